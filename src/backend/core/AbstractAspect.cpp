@@ -161,6 +161,30 @@
  * \brief Emitted from the parent after removing a child
  */
 
+/**
+ * \fn void AbstractAspect::aspectsAboutToBeAdded(const AbstractAspect *parent, int first, int last)
+ * \brief Emitted before the visible children \c first to \c last of \c parent are inserted at once
+ *
+ * The indices refer to the list of the visible children of \c parent after the insertion.
+ * No aspectAboutToBeAdded() and aspectAdded() are emitted for these children.
+ * \sa insertChildrenBefore()
+ */
+
+/**
+ * \fn void AbstractAspect::aspectsAdded(const AbstractAspect *parent, int first, int last)
+ * \brief Emitted after the visible children \c first to \c last have been added to \c parent at once
+ */
+
+/**
+ * \fn void AbstractAspect::aspectsAboutToBeRemoved(const AbstractAspect *parent, int first, int last)
+ * \brief Emitted before the visible children \c first to \c last of \c parent are removed at once
+ */
+
+/**
+ * \fn void AbstractAspect::aspectsRemoved(const AbstractAspect *parent, int first, int last)
+ * \brief Emitted from the parent after the children \c first to \c last have been removed at once
+ */
+
 /**
  * \fn void AbstractAspect::aspectHiddenAboutToChange(const AbstractAspect *aspect)
  * \brief Emitted before the hidden attribute is changed
@@ -421,6 +445,63 @@ void AbstractAspect::insertChildBeforeFast(AbstractAspect* child, AbstractAspect
 	d->insertChild(index, child);
 }
 
+/**
+ * \brief Add the given Aspects to my list of children.
+ *
+ * \sa insertChildrenBefore()
+ */
+void AbstractAspect::addChildren(const QList<AbstractAspect*>& children) {
+	insertChildrenBefore(children, 0);
+}
+
+/**
+ * \brief Add the given Aspects to my list of children without putting this step onto the undo-stack
+ *
+ * \sa insertChildrenBeforeFast()
+ */
+void AbstractAspect::addChildrenFast(const QList<AbstractAspect*>& children) {
+	insertChildrenBeforeFast(children, 0);
+}
+
+/**
+ * \brief Insert the given Aspects at a specific position in my list of children.
+ *
+ * In contrast to calling insertChildBefore() for every child, only one undo command is created
+ * and the unique names are determined for the whole list at once. The insertion is announced
+ * with one aspectsAboutToBeAdded()/aspectsAdded() pair for the whole range of new children.
+ * This is meant for the creation of many children at once, e.g. the columns of a data import.
+ */
+void AbstractAspect::insertChildrenBefore(const QList<AbstractAspect*>& children, AbstractAspect* before) {
+	if (children.isEmpty())
+		return;
+
+	makeUniqueNames(children);
+	int index = d->indexOfChild(before);
+	if (index == -1)
+		index = d->m_children.count();
+
+	exec(new AspectChildrenAddCmd(d, children, index));
+}
+
+/**
+ * \brief Insert the given Aspects at a specific position in my list of children without putting this step onto the undo-stack
+ *
+ * Like insertChildrenBefore(), the new children get unique names and are announced with one
+ * aspectsAboutToBeAdded()/aspectsAdded() pair. Used for the columns created by a data import,
+ * which is not undoable.
+ */
+void AbstractAspect::insertChildrenBeforeFast(const QList<AbstractAspect*>& children, AbstractAspect* before) {
+	if (children.isEmpty())
+		return;
+
+	makeUniqueNames(children);
+	int index = d->indexOfChild(before);
+	if (index == -1)
+		index = d->m_children.count();
+
+	d->insertChildren(index, children);
+}
+
 /**
  * \brief Remove the given Aspect from my list of children.
  *
@@ -481,6 +562,7 @@ void AbstractAspect::reparent(AbstractAspect* newParent, int newIndex) {
 	AbstractAspect* old_sibling = old_parent->child<AbstractAspect>(old_index+1, IncludeHidden);
 	AbstractAspect* new_sibling = newParent->child<AbstractAspect>(newIndex, IncludeHidden);
 
+	beginMacro(i18n("%1: move to %2", name(), newParent->name()));
 	//TODO check/test this!
 	emit aspectAboutToBeRemoved(this);
 	emit newParent->aspectAboutToBeAdded(newParent, new_sibling, this);
@@ -510,6 +592,23 @@ const QList<AbstractAspect*> AbstractAspect::children() const {
 	return d->m_children;
 }
 
+/**
+ * \brief Return the children inheriting from the class described by \c type, in the order of the children.
+ *
+ * The result is cached per class, so that child(), childCount() and indexOfChild()
+ * don't need to check every child with qobject_cast.
+ */
+QVector<AbstractAspect*> AbstractAspect::typedChildren(const QMetaObject* type, bool includeHidden) const {
+	return d->typedChildren(type, includeHidden);
+}
+
+/**
+ * \brief Return the children with the name \c name, in the order of the children.
+ */
+QList<AbstractAspect*> AbstractAspect::childrenNamed(const QString& name) const {
+	return d->childrenNamed(name);
+}
+
 /**
  * \brief Remove me from my parent's list of children.
  */
@@ -616,6 +715,10 @@ void AbstractAspect::setUndoAware(bool b) {
 	d->m_undoAware = b;
 }
 
+bool AbstractAspect::isUndoAware() const {
+	return d->m_undoAware;
+}
+
 /**
  * \brief Return the undo stack of the Project, or 0 if this Aspect is not part of a Project.
  *
@@ -679,26 +782,26 @@ void AbstractAspect::exec(QUndoCommand* command,
 
 /**
  * \brief Begin an undo stack macro (series of commands)
+ *
+ * The macro is also an update of the project: the data changes of columns within the macro
+ * are announced once per column in endMacro(), see Project::beginUpdate().
  */
 void AbstractAspect::beginMacro(const QString& text) {
-	if (!d->m_undoAware)
-		return;
-
-	QUndoStack* stack = undoStack();
-	if (stack)
-		stack->beginMacro(text);
+	Project* p = project();
+	if (p)
+		p->beginMacroUpdate(text, d->m_undoAware);
 }
 
 /**
  * \brief End the current undo stack macro
+ *
+ * Ends the last undo stack macro and project update begun with beginMacro(), the bookkeeping is done
+ * by the project. So it doesn't matter on which aspect of the project endMacro() is called.
  */
 void AbstractAspect::endMacro() {
-	if (!d->m_undoAware)
-		return;
-
-	QUndoStack* stack = undoStack();
-	if (stack)
-		stack->endMacro();
+	Project* p = project();
+	if (p)
+		p->endMacroUpdate();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -745,12 +848,19 @@ void AbstractAspect::childDeselected(const AbstractAspect* aspect) {
  * \brief Make the specified name unique among my children by incrementing a trailing number.
  */
 QString AbstractAspect::uniqueNameFor(const QString& current_name) const {
-// 	return d->uniqueNameFor(current_name);
-	QStringList child_names;
-	foreach(AbstractAspect * child, children())
-		child_names << child->name();
+	QHash<QString, int> lastNumbers;
+	return uniqueNameFor(current_name, QSet<QString>(), lastNumbers);
+}
 
-	if (!child_names.contains(current_name))
+/**
+ * \brief Make the specified name unique among my children and the names in \c reserved.
+ *
+ * \c lastNumbers holds for every base name the last number that was appended to it,
+ * the search for a free number continues from there. This keeps naming many new children
+ * with the same base name linear.
+ */
+QString AbstractAspect::uniqueNameFor(const QString& current_name, const QSet<QString>& reserved, QHash<QString, int>& lastNumbers) const {
+	if (!d->hasChildNamed(current_name) && !reserved.contains(current_name))
 		return current_name;
 
 	QString base = current_name;
@@ -762,16 +872,49 @@ QString AbstractAspect::uniqueNameFor(const QString& current_name) const {
 	if (last_non_digit >=0 && base[last_non_digit].category() != QChar::Separator_Space)
 		base.append(" ");
 
-	int new_nr = current_name.right(current_name.size() - base.size()).toInt();
+	int new_nr = qMax(current_name.right(current_name.size() - base.size()).toInt(), lastNumbers.value(base, 0));
 	QString new_name;
 	do
 		new_name = base + QString::number(++new_nr);
-	while (child_names.contains(new_name));
+	while (d->hasChildNamed(new_name) || reserved.contains(new_name));
 
+	lastNumbers[base] = new_nr;
 	return new_name;
 }
 
+/**
+ * \brief Renames the given new children, so that their names differ from the names of my children and from each other.
+ */
+void AbstractAspect::makeUniqueNames(const QList<AbstractAspect*>& children) const {
+	QSet<QString> names;
+	QHash<QString, int> lastNumbers;
+	foreach (AbstractAspect* child, children) {
+		Q_CHECK_PTR(child);
+		const QString new_name = uniqueNameFor(child->name(), names, lastNumbers);
+		if (new_name != child->name())
+			child->setName(new_name);
+		names.insert(new_name);
+	}
+}
+
+void AbstractAspect::childHiddenChanged(const AbstractAspect* aspect) {
+	//the signals of the grandchildren are forwarded by the children, only react on own children
+	if (aspect->parentAspect() == this)
+		d->invalidateChildCache();
+}
+
+void AbstractAspect::childDescriptionChanged(const AbstractAspect* aspect) {
+	if (aspect->parentAspect() == this)
+		d->m_childNamesValid = false;
+}
+
 void AbstractAspect::connectChild(AbstractAspect* child) {
+	//connect these first to invalidate the lookup caches before the forwarded signals are handled
+	connect(child, SIGNAL(aspectHiddenChanged(const AbstractAspect*)),
+	        this, SLOT(childHiddenChanged(const AbstractAspect*)));
+	connect(child, SIGNAL(aspectDescriptionChanged(const AbstractAspect*)),
+	        this, SLOT(childDescriptionChanged(const AbstractAspect*)));
+
 	connect(child, SIGNAL(aspectDescriptionAboutToChange(const AbstractAspect*)),
 	        this, SIGNAL(aspectDescriptionAboutToChange(const AbstractAspect*)));
 	connect(child, SIGNAL(aspectDescriptionChanged(const AbstractAspect*)),
@@ -784,6 +927,14 @@ void AbstractAspect::connectChild(AbstractAspect* child) {
 	        this, SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)));
 	connect(child, SIGNAL(aspectRemoved(const AbstractAspect*,const AbstractAspect*,const AbstractAspect*)),
 	        this, SIGNAL(aspectRemoved(const AbstractAspect*,const AbstractAspect*,const AbstractAspect*)));
+	connect(child, SIGNAL(aspectsAboutToBeAdded(const AbstractAspect*,int,int)),
+	        this, SIGNAL(aspectsAboutToBeAdded(const AbstractAspect*,int,int)));
+	connect(child, SIGNAL(aspectsAdded(const AbstractAspect*,int,int)),
+	        this, SIGNAL(aspectsAdded(const AbstractAspect*,int,int)));
+	connect(child, SIGNAL(aspectsAboutToBeRemoved(const AbstractAspect*,int,int)),
+	        this, SIGNAL(aspectsAboutToBeRemoved(const AbstractAspect*,int,int)));
+	connect(child, SIGNAL(aspectsRemoved(const AbstractAspect*,int,int)),
+	        this, SIGNAL(aspectsRemoved(const AbstractAspect*,int,int)));
 	connect(child, SIGNAL(aspectHiddenAboutToChange(const AbstractAspect*)),
 	        this, SIGNAL(aspectHiddenAboutToChange(const AbstractAspect*)));
 	connect(child, SIGNAL(aspectHiddenChanged(const AbstractAspect*)),
@@ -799,7 +950,7 @@ void AbstractAspect::connectChild(AbstractAspect* child) {
 //##############################################################################
 AbstractAspectPrivate::AbstractAspectPrivate(AbstractAspect* owner, const QString& name)
 	: m_name(name.isEmpty() ? "1" : name), m_hidden(false), q(owner), m_parent(0),
-	m_undoAware(true), m_isLoading(false) 
+	m_undoAware(true), m_isLoading(false), m_childNamesValid(false)
 {
 	m_creation_time = QDateTime::currentDateTime();
 }
@@ -811,6 +962,7 @@ AbstractAspectPrivate::~AbstractAspectPrivate() {
 
 void AbstractAspectPrivate::insertChild(int index, AbstractAspect* child) {
 	m_children.insert(index, child);
+	invalidateChildCache();
 
 	// Always remove from any previous parent before adding to a new one!
 	// Can't handle this case here since two undo commands have to be created.
@@ -819,6 +971,71 @@ void AbstractAspectPrivate::insertChild(int index, AbstractAspect* child) {
 	q->connectChild(child);
 }
 
+/*!
+ * inserts the children at \c index and announces the new visible children
+ * with one aspectsAboutToBeAdded()/aspectsAdded() pair.
+ */
+void AbstractAspectPrivate::insertChildren(int index, const QList<AbstractAspect*>& children) {
+	//the visible children are announced, they are consecutive in the list of the visible children
+	int first = 0;
+	for (int i = 0; i < index; ++i) {
+		if (!m_children.at(i)->hidden())
+			++first;
+	}
+	int count = 0;
+	foreach (const AbstractAspect* child, children) {
+		if (!child->hidden())
+			++count;
+	}
+
+	if (count > 0)
+		emit q->aspectsAboutToBeAdded(q, first, first + count - 1);
+
+	m_children = m_children.mid(0, index) + children + m_children.mid(index);
+	invalidateChildCache();
+	foreach (AbstractAspect* child, children) {
+		Q_ASSERT(child->parentAspect() == 0);
+		child->setParentAspect(q);
+		q->connectChild(child);
+	}
+
+	if (count > 0)
+		emit q->aspectsAdded(q, first, first + count - 1);
+}
+
+/*!
+ * removes the children, which have to be consecutive in the list of children,
+ * and announces this with one aspectsAboutToBeRemoved()/aspectsRemoved() pair.
+ */
+void AbstractAspectPrivate::removeChildren(const QList<AbstractAspect*>& children) {
+	const int index = indexOfChild(children.first());
+	Q_ASSERT(index != -1);
+	int first = 0;
+	for (int i = 0; i < index; ++i) {
+		if (!m_children.at(i)->hidden())
+			++first;
+	}
+	int count = 0;
+	for (int i = 0; i < children.size(); ++i) {
+		Q_ASSERT(m_children.at(index + i) == children.at(i));
+		if (!children.at(i)->hidden())
+			++count;
+	}
+
+	if (count > 0)
+		emit q->aspectsAboutToBeRemoved(q, first, first + count - 1);
+
+	m_children.erase(m_children.begin() + index, m_children.begin() + index + children.size());
+	invalidateChildCache();
+	foreach (AbstractAspect* child, children) {
+		QObject::disconnect(child, 0, q, 0);
+		child->setParentAspect(0);
+	}
+
+	if (count > 0)
+		emit q->aspectsRemoved(q, first, first + count - 1);
+}
+
 int AbstractAspectPrivate::indexOfChild(const AbstractAspect* child) const {
 	for(int i=0; i<m_children.size(); i++)
 		if(m_children.at(i) == child) return i;
@@ -830,7 +1047,60 @@ int AbstractAspectPrivate::removeChild(AbstractAspect* child) {
 	int index = indexOfChild(child);
 	Q_ASSERT(index != -1);
 	m_children.removeAll(child);
+	invalidateChildCache();
 	QObject::disconnect(child, 0, q, 0);
 	child->setParentAspect(0);
 	return index;
 }
+
+QVector<AbstractAspect*> AbstractAspectPrivate::typedChildren(const QMetaObject* type, bool includeHidden) const {
+	QHash<const QMetaObject*, QVector<AbstractAspect*> >& cache = includeHidden ? m_typedChildren : m_visibleTypedChildren;
+	QHash<const QMetaObject*, QVector<AbstractAspect*> >::const_iterator it = cache.constFind(type);
+	if (it != cache.constEnd())
+		return it.value();
+
+	QVector<AbstractAspect*> result;
+	foreach (AbstractAspect* child, m_children) {
+		if ((includeHidden || !child->hidden()) && type->cast(child))
+			result << child;
+	}
+	cache.insert(type, result);
+	return result;
+}
+
+void AbstractAspectPrivate::updateChildNames() const {
+	if (m_childNamesValid)
+		return;
+
+	m_childNames.clear();
+	m_childNames.reserve(m_children.size());
+	foreach (AbstractAspect* child, m_children)
+		m_childNames.insert(child->name(), child);
+	m_childNamesValid = true;
+}
+
+bool AbstractAspectPrivate::hasChildNamed(const QString& name) const {
+	updateChildNames();
+	return m_childNames.contains(name);
+}
+
+QList<AbstractAspect*> AbstractAspectPrivate::childrenNamed(const QString& name) const {
+	updateChildNames();
+
+	QList<AbstractAspect*> result = m_childNames.values(name);
+	if (result.size() > 1) {
+		//names are usually unique, keep the order of the children for the rare duplicates
+		result.clear();
+		foreach (AbstractAspect* child, m_children) {
+			if (child->name() == name)
+				result << child;
+		}
+	}
+	return result;
+}
+
+void AbstractAspectPrivate::invalidateChildCache() {
+	m_typedChildren.clear();
+	m_visibleTypedChildren.clear();
+	m_childNamesValid = false;
+}
@@ -31,7 +31,10 @@
 #define ABSTRACT_ASPECT_H
 
 #include <QObject>
+#include <QHash>
 #include <QList>
+#include <QSet>
+#include <QVector>
 
 class AbstractAspectPrivate;
 class Project;
@@ -57,6 +60,7 @@ class AbstractAspect : public QObject {
 
 		friend class AspectChildAddCmd;
 		friend class AspectChildRemoveCmd;
+		friend class AspectChildrenAddCmd;
 		friend class AbstractAspectPrivate;
 
 		explicit AbstractAspect(const QString& name);
@@ -83,9 +87,13 @@ class AbstractAspect : public QObject {
 		bool isDescendantOf(AbstractAspect* other);
 		void addChild(AbstractAspect*);
 		void addChildFast(AbstractAspect*);
+		void addChildren(const QList<AbstractAspect*>&);
+		void addChildrenFast(const QList<AbstractAspect*>&);
 		QList<AbstractAspect*> children(const char* className, const ChildIndexFlags& flags=0);
 		void insertChildBefore(AbstractAspect* child, AbstractAspect* before);
 		void insertChildBeforeFast(AbstractAspect* child, AbstractAspect* before);
+		void insertChildrenBefore(const QList<AbstractAspect*>& children, AbstractAspect* before);
+		void insertChildrenBeforeFast(const QList<AbstractAspect*>& children, AbstractAspect* before);
 		void reparent(AbstractAspect* newParent, int newIndex=-1);
 		void removeChild(AbstractAspect*);
 		void removeAllChildren();
@@ -103,6 +111,12 @@ class AbstractAspect : public QObject {
 
 		template <class T> QList<T*> children(const ChildIndexFlags& flags=0) const {
 			QList<T*> result;
+			if (!(flags & Recursive)) {
+				foreach (AbstractAspect* child, typedChildren(&T::staticMetaObject, flags.testFlag(IncludeHidden)))
+					result << static_cast<T*>(child);
+				return result;
+			}
+
 			foreach (AbstractAspect* child, children()) {
 				if (flags & IncludeHidden || !child->hidden()) {
 					T* i = qobject_cast<T*>(child);
@@ -117,35 +131,31 @@ class AbstractAspect : public QObject {
 		}
 
 		template <class T> T* child(int index, const ChildIndexFlags& flags=0) const {
-			int i = 0;
-			foreach (AbstractAspect* child, children()) {
-				T* c = qobject_cast<T*>(child);
-				if (c && (flags & IncludeHidden || !child->hidden()) && index == i++)
-					return c;
-			}
-			return 0;
+			const QVector<AbstractAspect*> list = typedChildren(&T::staticMetaObject, flags.testFlag(IncludeHidden));
+			if (index < 0 || index >= list.size())
+				return 0;
+			return static_cast<T*>(list.at(index));
 		}
 
 		template <class T> T* child(const QString& name) const {
-			foreach (AbstractAspect* child, children()) {
-			T* c = qobject_cast<T*>(child);
-			if (c && child->name() == name)
-				return c;
+			foreach (AbstractAspect* child, childrenNamed(name)) {
+				T* c = qobject_cast<T*>(child);
+				if (c)
+					return c;
 			}
 			return 0;
 		}
 
 		template <class T> int childCount(const ChildIndexFlags& flags=0) const {
-			int result = 0;
-			foreach(AbstractAspect* child, children()) {
-				T* i = qobject_cast<T*>(child);
-				if (i && (flags & IncludeHidden || !child->hidden()))
-					result++;
-			}
-			return result;
+			return typedChildren(&T::staticMetaObject, flags.testFlag(IncludeHidden)).size();
 		}
 
 		template <class T> int indexOfChild(const AbstractAspect* child, const ChildIndexFlags& flags=0) const {
+			const int pos = typedChildren(&T::staticMetaObject, flags.testFlag(IncludeHidden)).indexOf(const_cast<AbstractAspect*>(child));
+			if (pos != -1)
+				return pos;
+
+			//child is hidden or doesn't inherit T, count the preceding children of type T
 			int index = 0;
 			foreach(AbstractAspect* c, children()) {
 				if (child == c) return index;
@@ -158,6 +168,7 @@ class AbstractAspect : public QObject {
 
 		//undo/redo related functions
 		void setUndoAware(bool);
+		bool isUndoAware() const;
 		virtual QUndoStack* undoStack() const;
 		void exec(QUndoCommand*);
 		void exec(QUndoCommand* command, const char* preChangeSignal, const char* postChangeSignal,
@@ -183,7 +194,11 @@ class AbstractAspect : public QObject {
 		AbstractAspectPrivate* d;
 
 		QString uniqueNameFor(const QString&) const;
+		QString uniqueNameFor(const QString&, const QSet<QString>& reserved, QHash<QString, int>& lastNumbers) const;
+		void makeUniqueNames(const QList<AbstractAspect*>&) const;
 		const QList<AbstractAspect*> children() const;
+		QVector<AbstractAspect*> typedChildren(const QMetaObject*, bool includeHidden) const;
+		QList<AbstractAspect*> childrenNamed(const QString&) const;
 		void connectChild(AbstractAspect*);
 
 	public slots:
@@ -195,6 +210,10 @@ class AbstractAspect : public QObject {
 		virtual void childSelected(const AbstractAspect*);
 		virtual void childDeselected(const AbstractAspect*);
 
+	private slots:
+		void childHiddenChanged(const AbstractAspect*);
+		void childDescriptionChanged(const AbstractAspect*);
+
 	signals:
 		void aspectDescriptionAboutToChange(const AbstractAspect*);
 		void aspectDescriptionChanged(const AbstractAspect*);
@@ -202,6 +221,10 @@ class AbstractAspect : public QObject {
 		void aspectAdded(const AbstractAspect*);
 		void aspectAboutToBeRemoved(const AbstractAspect*);
 		void aspectRemoved(const AbstractAspect* parent, const AbstractAspect* before, const AbstractAspect* child);
+		void aspectsAboutToBeAdded(const AbstractAspect* parent, int first, int last);
+		void aspectsAdded(const AbstractAspect* parent, int first, int last);
+		void aspectsAboutToBeRemoved(const AbstractAspect* parent, int first, int last);
+		void aspectsRemoved(const AbstractAspect* parent, int first, int last);
 		void aspectHiddenAboutToChange(const AbstractAspect*);
 		void aspectHiddenChanged(const AbstractAspect*);
 		void statusInfo(const QString&);
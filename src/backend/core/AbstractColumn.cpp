@@ -93,6 +93,29 @@ AbstractColumn::~AbstractColumn() {
  * \brief Return whether the object is read-only
  */
 
+/**
+ * \brief Return whether the values of columns with the mode \c mode are numbers
+ *
+ * This is the case for Numeric (double) and for the more compact
+ * Integer, BigInt and Float storage modes. All of them provide their values via valueAt().
+ */
+bool AbstractColumn::isNumeric(AbstractColumn::ColumnMode mode) {
+	switch (mode) {
+	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float:
+		return true;
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	return false;
+}
+
 /**
  * \fn AbstractColumn::ColumnMode AbstractColumn::columnMode() const
  * \brief Return the column mode
@@ -206,6 +229,9 @@ void AbstractColumn::clear() {}
 bool AbstractColumn::isValid(int row) const {
 	switch (columnMode()) {
 		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float:
 			return !std::isnan(valueAt(row));
 		case AbstractColumn::Text:
 			return !textAt(row).isNull();
@@ -270,6 +296,45 @@ void AbstractColumn::setMasked(int row, bool mask) {
 	setMasked(Interval<int>(row,row), mask);
 }
 
+/**
+ * \brief Reorder the masks, row \c i gets the mask of row \c permutation[i]
+ *
+ * Masks of the rows from permutation.size() on are not changed.
+ * This doesn't create an undo command, it's used by the commands reordering the rows of a column.
+ */
+void AbstractColumn::permuteMasks(const QVector<int>& permutation) {
+	const QList< Interval<int> > intervals = m_abstract_column_private->m_masking.intervals();
+	if (intervals.isEmpty())
+		return;
+
+	const int rows = permutation.size();
+	QVector<bool> masked(rows, false);
+	QList< Interval<int> > new_intervals;
+	foreach (const Interval<int>& interval, intervals) {
+		for (int row = interval.start(); row <= qMin(interval.end(), rows-1); ++row)
+			masked[row] = true;
+		if (interval.end() >= rows)
+			new_intervals << Interval<int>(qMax(interval.start(), rows), interval.end());
+	}
+
+	// collect the new masked rows as intervals, in ascending order and in front of the unchanged ones
+	int index = 0;
+	int start = -1;
+	for (int row = 0; row <= rows; ++row) {
+		const bool mask = (row < rows && masked.at(permutation.at(row)));
+		if (mask && start == -1)
+			start = row;
+		else if (!mask && start != -1) {
+			new_intervals.insert(index++, Interval<int>(start, row-1));
+			start = -1;
+		}
+	}
+
+	emit maskingAboutToChange(this);
+	m_abstract_column_private->m_masking = IntervalAttribute<bool>(new_intervals);
+	emit maskingChanged(this);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //@}
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -64,13 +64,18 @@ class AbstractColumn : public AbstractAspect
 			Text = 1,
 			Month = 4,
 			Day = 5,
-			DateTime = 6
+			DateTime = 6,
 			// 2 and 3 are skipped to avoid problems with old obsolete values
+			Integer = 7,	// 32bit integer values
+			BigInt = 8,	// 64bit integer values
+			Float = 9	// single precision floating point values
 		};
 
 		explicit AbstractColumn(const QString& name);
 		virtual ~AbstractColumn();
 
+		static bool isNumeric(ColumnMode);
+
 		virtual bool isReadOnly() const { return true; };
 		virtual ColumnMode columnMode() const = 0;
 		virtual void setColumnMode(AbstractColumn::ColumnMode);
@@ -138,6 +143,7 @@ class AbstractColumn : public AbstractAspect
 
 		virtual void handleRowInsertion(int before, int count);
 		virtual void handleRowRemoval(int first, int count);
+		void permuteMasks(const QVector<int>& permutation);
 
 	private:
 		AbstractColumnPrivate* m_abstract_column_private;
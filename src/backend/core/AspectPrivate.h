@@ -31,9 +31,12 @@
 #define ASPECT_PRIVATE_H
 
 #include <QDateTime>
+#include <QHash>
 #include <QList>
+#include <QVector>
 
 class AbstractAspect;
+struct QMetaObject;
 
 class AbstractAspectPrivate {
 	public:
@@ -41,8 +44,15 @@ class AbstractAspectPrivate {
 		~AbstractAspectPrivate();
 
 		void insertChild(int index, AbstractAspect*);
+		void insertChildren(int index, const QList<AbstractAspect*>&);
+		void removeChildren(const QList<AbstractAspect*>&);
 		int indexOfChild(const AbstractAspect*) const;
 		int removeChild(AbstractAspect*);
+		QVector<AbstractAspect*> typedChildren(const QMetaObject*, bool includeHidden) const;
+		QList<AbstractAspect*> childrenNamed(const QString&) const;
+		bool hasChildNamed(const QString&) const;
+		void invalidateChildCache();
+		void updateChildNames() const;
 
 	public:
 		QList<AbstractAspect*> m_children;
@@ -54,6 +64,12 @@ class AbstractAspectPrivate {
 		AbstractAspect* m_parent;
 		bool m_undoAware;
 		bool m_isLoading;
+
+		//lookup caches for the children, rebuilt on demand after children were added, removed, hidden or renamed
+		mutable QHash<const QMetaObject*, QVector<AbstractAspect*> > m_typedChildren;
+		mutable QHash<const QMetaObject*, QVector<AbstractAspect*> > m_visibleTypedChildren;
+		mutable QMultiHash<QString, AbstractAspect*> m_childNames;
+		mutable bool m_childNamesValid;
 };
 
 #endif // ifndef ASPECT_PRIVATE_H
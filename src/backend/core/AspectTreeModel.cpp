@@ -87,6 +87,14 @@ AspectTreeModel::AspectTreeModel(AbstractAspect* root, QObject* parent)
 	        this, SLOT(aspectAdded(const AbstractAspect*)));
 	connect(m_root, SIGNAL(aspectRemoved(const AbstractAspect*,const AbstractAspect*,const AbstractAspect*)),
 	        this, SLOT(aspectRemoved()));
+	connect(m_root, SIGNAL(aspectsAboutToBeAdded(const AbstractAspect*,int,int)),
+	        this, SLOT(aspectsAboutToBeAdded(const AbstractAspect*,int,int)));
+	connect(m_root, SIGNAL(aspectsAdded(const AbstractAspect*,int,int)),
+	        this, SLOT(aspectsAdded(const AbstractAspect*,int,int)));
+	connect(m_root, SIGNAL(aspectsAboutToBeRemoved(const AbstractAspect*,int,int)),
+	        this, SLOT(aspectsAboutToBeRemoved(const AbstractAspect*,int,int)));
+	connect(m_root, SIGNAL(aspectsRemoved(const AbstractAspect*,int,int)),
+	        this, SLOT(aspectRemoved()));
 	connect(m_root, SIGNAL(aspectHiddenAboutToChange(const AbstractAspect*)),
 	        this, SLOT(aspectHiddenAboutToChange(const AbstractAspect*)));
 	connect(m_root, SIGNAL(aspectHiddenChanged(const AbstractAspect*)),
@@ -279,6 +287,29 @@ void AspectTreeModel::aspectRemoved() {
 	endRemoveRows();
 }
 
+void AspectTreeModel::aspectsAboutToBeAdded(const AbstractAspect* parent, int first, int last) {
+	beginInsertRows(modelIndexOfAspect(parent), first, last);
+}
+
+void AspectTreeModel::aspectsAdded(const AbstractAspect* parent, int first, int last) {
+	endInsertRows();
+	emit dataChanged(modelIndexOfAspect(parent), modelIndexOfAspect(parent, 3));
+
+	for (int i = first; i <= last; ++i) {
+		const AbstractAspect* aspect = parent->child<AbstractAspect>(i);
+		connect(aspect, SIGNAL(renameRequested()), this, SLOT(renameRequested()));
+		foreach(const AbstractAspect* child, aspect->children<AbstractAspect>())
+			connect(child, SIGNAL(renameRequested()), this, SLOT(renameRequested()));
+
+		connect(aspect, SIGNAL(childAspectSelectedInView(const AbstractAspect*)), this, SLOT(aspectSelectedInView(const AbstractAspect*)));
+		connect(aspect, SIGNAL(childAspectDeselectedInView(const AbstractAspect*)), this, SLOT(aspectDeselectedInView(const AbstractAspect*)));
+	}
+}
+
+void AspectTreeModel::aspectsAboutToBeRemoved(const AbstractAspect* parent, int first, int last) {
+	beginRemoveRows(modelIndexOfAspect(parent), first, last);
+}
+
 void AspectTreeModel::aspectHiddenAboutToChange(const AbstractAspect * aspect) {
 	for (AbstractAspect * i = aspect->parentAspect(); i; i = i->parentAspect())
 		if (i->hidden())
@@ -67,6 +67,9 @@ private slots:
 	void aspectAdded(const AbstractAspect *parent);
 	void aspectAboutToBeRemoved(const AbstractAspect *aspect);
 	void aspectRemoved();
+	void aspectsAboutToBeAdded(const AbstractAspect* parent, int first, int last);
+	void aspectsAdded(const AbstractAspect* parent, int first, int last);
+	void aspectsAboutToBeRemoved(const AbstractAspect* parent, int first, int last);
 	void aspectHiddenAboutToChange(const AbstractAspect * aspect);
 	void aspectHiddenChanged(const AbstractAspect *aspect);
 	void aspectSelectedInView(const AbstractAspect* aspect);
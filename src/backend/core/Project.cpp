@@ -41,8 +41,12 @@
 #include "backend/worksheet/plots/cartesian/XYFourierTransformCurve.h"
 #include "backend/worksheet/plots/cartesian/Axis.h"
 #include "backend/datapicker/DatapickerCurve.h"
+#include "backend/core/column/FormulaDependencyGraph.h"
 
 #include <QUndoStack>
+#include <QPointer>
+#include <QHash>
+#include <QSet>
 #include <QMenu>
 #include <QDateTime>
 #include <QThreadPool>
@@ -78,14 +82,16 @@
 
 class Project::Private {
 	public:
-		Private() :
+		explicit Private(Project* owner) :
 			mdiWindowVisibility(Project::folderOnly),
 			scriptingEngine(0),
 			version(LVERSION),
 			author(QString(qgetenv("USER"))),
 			modificationTime(QDateTime::currentDateTime()),
 			changed(false),
-			loading(false)
+			loading(false),
+			updateDepth(0),
+			formulaDependencies(owner)
 			{}
 
 		QUndoStack undo_stack;
@@ -97,15 +103,27 @@ class Project::Private {
 		QDateTime modificationTime;
 		bool changed;
 		bool loading;
+		int updateDepth;
+		QVector<bool> macroUndoAware;	//for every macro begun with beginMacroUpdate() whether an undo stack macro was begun
+		QSet<const AbstractColumn*> announcedColumns;
+		QList< QPointer<AbstractColumn> > changedColumns;
+		QHash<const AbstractColumn*, QPair<int, int> > changedColumnRows;	//first and last changed row, -1 for the last row
+		QString aspectName;	//name of the aspect whose description is about to change
+		FormulaDependencyGraph formulaDependencies;
 };
 
-Project::Project() : Folder(i18n("Project")), d(new Private()) {
+Project::Project() : Folder(i18n("Project")), d(new Private(this)) {
 	//load default values for name, comment and author from config
 	KConfig config;
 	KConfigGroup group = config.group("Project");
 
 	d->author = group.readEntry("Author", QString());
 
+	//number of steps kept in the undo history, the oldest commands are dropped, 0 for no limit.
+	//QUndoStack allows to set the limit only as long as the stack is empty.
+	const KConfigGroup generalGroup = config.group("Settings_General");
+	d->undo_stack.setUndoLimit(generalGroup.readEntry("UndoLimit", 100));
+
 	//we don't have direct access to the members name and comment
 	//->temporaly disable the undo stack and call the setters
 	setUndoAware(false);
@@ -121,6 +139,7 @@ Project::Project() : Folder(i18n("Project")), d(new Private()) {
 // 	QString engine_name = ScriptingEngineManager::instance()->engineNames()[0];
 // 	d->scriptingEngine = ScriptingEngineManager::instance()->engine(engine_name);
 
+	connect(this, SIGNAL(aspectDescriptionAboutToChange(const AbstractAspect*)),this, SLOT(descriptionAboutToChange(const AbstractAspect*)));
 	connect(this, SIGNAL(aspectDescriptionChanged(const AbstractAspect*)),this, SLOT(descriptionChanged(const AbstractAspect*)));
 }
 
@@ -184,7 +203,16 @@ bool Project ::hasChanged() const {
 	return d->changed ;
 }
 
+void Project::descriptionAboutToChange(const AbstractAspect* aspect) {
+	d->aspectName = aspect->name();
+}
+
 void Project::descriptionChanged(const AbstractAspect* aspect) {
+	//renaming an aspect changes the pathes of the columns in it, which are used by formulas.
+	//Moved and removed columns are noticed by the dependency graph itself
+	if (aspect->name() != d->aspectName)
+		d->formulaDependencies.invalidate();
+
 	if (d->loading)
 		return;
 
@@ -199,6 +227,128 @@ void Project::navigateTo(const QString& path) {
 	requestNavigateTo(path);
 }
 
+/*!
+	begins an update of the project, calls can be nested.
+	Until the outermost endUpdate() the columns don't emit dataAboutToChange() and dataChanged() for every modification,
+	every changed column emits dataAboutToChange() before its first change and dataChanged() once at the end of the update. This way the curves,
+	plots and analysis curves depending on the data are recalculated only once.
+	AbstractAspect::beginMacro() and endMacro() begin and end an update implicitly.
+*/
+void Project::beginUpdate() {
+	++d->updateDepth;
+}
+
+/*!
+	ends an update begun with beginUpdate(), emits the deferred dataChanged() signals
+	and recalculates the formula columns depending on the changed columns.
+*/
+void Project::endUpdate() {
+	if (d->updateDepth == 0 || --d->updateDepth > 0)
+		return;
+
+	// the receivers might begin a new update, work on a copy
+	const QList< QPointer<AbstractColumn> > columns = d->changedColumns;
+	const QHash<const AbstractColumn*, QPair<int, int> > rows = d->changedColumnRows;
+	d->changedColumns.clear();
+	d->changedColumnRows.clear();
+	d->announcedColumns.clear();
+	foreach (const QPointer<AbstractColumn>& column, columns) {
+		if (!column)
+			continue;
+
+		emit column->dataChanged(column);
+		Column* col = qobject_cast<Column*>(column.data());
+		if (col) {
+			const QPair<int, int>& range = rows[column.data()];
+			emit col->dataRangeChanged(col, range.first, range.second);
+		}
+	}
+
+	d->formulaDependencies.recalculate();
+}
+
+bool Project::isUpdating() const {
+	return d->updateDepth > 0;
+}
+
+/*!
+	begins an update and, if \c undoAware is \c true, a macro with the name \c text on the undo stack.
+	Called by AbstractAspect::beginMacro() of the aspects of the project.
+	The project keeps track of the open macros, so that endMacroUpdate() can be called by any aspect of the project.
+*/
+void Project::beginMacroUpdate(const QString& text, bool undoAware) {
+	beginUpdate();
+	if (undoAware)
+		d->undo_stack.beginMacro(text);
+	d->macroUndoAware << undoAware;
+}
+
+/*!
+	ends the last macro and update begun with beginMacroUpdate(), a call without open macro is ignored.
+*/
+void Project::endMacroUpdate() {
+	if (d->macroUndoAware.isEmpty())
+		return;
+
+	const bool undoAware = d->macroUndoAware.last();
+	d->macroUndoAware.pop_back();
+	if (undoAware)
+		d->undo_stack.endMacro();
+	endUpdate();
+}
+
+/*!
+	called by a column changed during an update before the change.
+	Returns \c true if the column has to emit dataAboutToChange(), which is the case only for the first change of the update.
+*/
+bool Project::announceDataChange(const AbstractColumn* column) {
+	if (d->announcedColumns.contains(column))
+		return false;
+
+	d->announcedColumns.insert(column);
+	return true;
+}
+
+/*!
+	called by a column changed during an update, the column emits dataChanged() once when the update ends.
+	The rows \c first to \c last (-1 for the last row) of the formula columns depending on \c column are recalculated then.
+*/
+void Project::deferDataChanged(AbstractColumn* column, int first, int last) {
+	if (!d->loading)
+		d->formulaDependencies.addChange(column, first, last);
+
+	QHash<const AbstractColumn*, QPair<int, int> >::iterator it = d->changedColumnRows.find(column);
+	if (it != d->changedColumnRows.end()) {
+		//merge the changed rows
+		QPair<int, int>& range = it.value();
+		range.first = qMin(range.first, first);
+		range.second = (range.second == -1 || last == -1) ? -1 : qMax(range.second, last);
+		return;
+	}
+
+	d->changedColumnRows.insert(column, qMakePair(first, last));
+	d->changedColumns << column;
+}
+
+/*!
+	recalculates the rows \c first to \c last (-1 for the last row) of the formula columns depending on \c column.
+	Called by a column changed outside of an update.
+*/
+void Project::recalculateDependentColumns(AbstractColumn* column, int first, int last) {
+	if (d->loading)
+		return;
+
+	d->formulaDependencies.addChange(column, first, last);
+	d->formulaDependencies.recalculate();
+}
+
+/*!
+	called when a formula was changed, the dependencies between the formula columns are determined again on the next change.
+*/
+void Project::invalidateFormulaDependencies() {
+	d->formulaDependencies.invalidate();
+}
+
 bool Project::isLoading() const {
 	return d->loading;
 }
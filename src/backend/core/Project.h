@@ -34,6 +34,7 @@
 #include "backend/lib/macros.h"
 
 class QString;
+class AbstractColumn;
 class AbstractScriptingEngine;
 
 class Project : public Folder {
@@ -72,11 +73,22 @@ class Project : public Folder {
 		bool hasChanged() const;
 		void navigateTo(const QString& path);
 
+		void beginUpdate();
+		void endUpdate();
+		bool isUpdating() const;
+		void beginMacroUpdate(const QString& text, bool undoAware);
+		void endMacroUpdate();
+		bool announceDataChange(const AbstractColumn*);
+		void deferDataChanged(AbstractColumn*, int first = 0, int last = -1);
+		void recalculateDependentColumns(AbstractColumn*, int first = 0, int last = -1);
+
 		virtual void save(QXmlStreamWriter*) const;
 		virtual bool load(XmlStreamReader*);
 
 	public slots:
+		void descriptionAboutToChange(const AbstractAspect*);
 		void descriptionChanged(const AbstractAspect*);
+		void invalidateFormulaDependencies();
 
 	signals:
 		void requestSaveState(QXmlStreamWriter*) const;
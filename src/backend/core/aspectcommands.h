@@ -98,6 +98,28 @@ public:
 	}
 };
 
+class AspectChildrenAddCmd : public QUndoCommand {
+public:
+	AspectChildrenAddCmd(AbstractAspectPrivate* target, const QList<AbstractAspect*>& children, int index)
+		: m_target(target), m_children(children), m_index(index) {
+		setText(i18n("%1: add %2 children", m_target->m_name, m_children.size()));
+	}
+
+	// the children are announced as one range, see AbstractAspectPrivate::insertChildren()
+	virtual void redo() {
+		m_target->insertChildren(m_index, m_children);
+	}
+
+	virtual void undo() {
+		m_target->removeChildren(m_children);
+	}
+
+protected:
+	AbstractAspectPrivate* m_target;
+	QList<AbstractAspect*> m_children;
+	int m_index;
+};
+
 class AspectChildReparentCmd : public QUndoCommand {
 public:
 	AspectChildReparentCmd(AbstractAspectPrivate* target, AbstractAspectPrivate* new_parent,
@@ -30,7 +30,10 @@
 #include "backend/core/column/Column.h"
 #include "backend/core/column/ColumnPrivate.h"
 #include "backend/core/column/columncommands.h"
+#include "backend/core/Project.h"
 #include "backend/lib/XmlStreamReader.h"
+#include "backend/lib/ChunkedVector.h"
+#include "backend/lib/TextDictionary.h"
 #include "backend/core/datatypes/String2DateTimeFilter.h"
 #include "backend/core/datatypes/DateTime2StringFilter.h"
 
@@ -62,8 +65,8 @@ extern "C" {
  * This class represents a column, i.e., (mathematically) a 1D vector of
  * values with a header. It provides a public reading and (undo aware) writing
  * interface as defined in AbstractColumn. A column
- * can have one of currently three data types: double, QString, or
- * QDateTime. The string representation of the values can differ depending
+ * can have one of currently six data types: double, float, int, qint64,
+ * QString, or QDateTime. The string representation of the values can differ depending
  * on the mode of the column.
  *
  * Column inherits from AbstractAspect and is intended to be a child
@@ -89,7 +92,40 @@ Column::Column(const QString& name, AbstractColumn::ColumnMode mode)
  * \param data initial data vector
  */
 Column::Column(const QString& name, QVector<double> data)
-	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::Numeric, new QVector<double>(data)) ) {
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::Numeric, new ChunkedVector<double>(data)) ) {
+	init();
+}
+
+/**
+ * \brief Ctor
+ *
+ * \param name the column name (= aspect name)
+ * \param data initial data vector
+ */
+Column::Column(const QString& name, QVector<int> data)
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::Integer, new ChunkedVector<int>(data)) ) {
+	init();
+}
+
+/**
+ * \brief Ctor
+ *
+ * \param name the column name (= aspect name)
+ * \param data initial data vector
+ */
+Column::Column(const QString& name, QVector<qint64> data)
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::BigInt, new ChunkedVector<qint64>(data)) ) {
+	init();
+}
+
+/**
+ * \brief Ctor
+ *
+ * \param name the column name (= aspect name)
+ * \param data initial data vector
+ */
+Column::Column(const QString& name, QVector<float> data)
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::Float, new ChunkedVector<float>(data)) ) {
 	init();
 }
 
@@ -100,7 +136,7 @@ Column::Column(const QString& name, QVector<double> data)
  * \param data initial data vector
  */
 Column::Column(const QString& name, QStringList data)
-	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::Text, new QStringList(data))) {
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::Text, new TextDictionary(data))) {
 	init();
 }
 
@@ -111,7 +147,10 @@ Column::Column(const QString& name, QStringList data)
  * \param data initial data vector
  */
 Column::Column(const QString& name, QList<QDateTime> data)
-	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::DateTime, new QList<QDateTime>(data)) ) {
+	: AbstractColumn(name), m_column_private( new ColumnPrivate(this, AbstractColumn::DateTime, new ChunkedVector<qint64>()) ) {
+	ChunkedVector<qint64>* vec = static_cast< ChunkedVector<qint64>* >(m_column_private->dataPointer());
+	for (int i = 0; i < data.size(); ++i)
+		vec->append(ColumnPrivate::toMSecs(data.at(i)));
 	init();
 }
 
@@ -144,6 +183,45 @@ void Column::setSuppressDataChangedSignal(bool b) {
 	m_suppressDataChangedSignal = b;
 }
 
+/*!
+ * emits dataAboutToChange() unless it is suppressed.
+ * During an update of the project (see Project::beginUpdate()) the signal is emitted only before the first change of the column.
+ * The random seed of the column is dropped, see setRandomValues().
+ */
+void Column::emitDataAboutToChange() {
+	m_column_private->setRandomSeed(QString(), 0);
+
+	if (m_suppressDataChangedSignal)
+		return;
+
+	Project* p = project();
+	if (p && p->isUpdating() && !p->announceDataChange(this))
+		return;
+
+	emit dataAboutToChange(this);
+}
+
+/*!
+ * emits dataChanged() and dataRangeChanged() unless they are suppressed.
+ * During an update of the project (see Project::beginUpdate()) the signals are emitted once when the update ends.
+ * The rows \c first to \c last (-1 for the last row) were changed, dataRangeChanged() passes them
+ * to the views and the formula columns of the project depending on this column are recalculated for these rows.
+ */
+void Column::emitDataChanged(int first, int last) {
+	if (m_suppressDataChangedSignal)
+		return;
+
+	Project* p = project();
+	if (p && p->isUpdating())
+		p->deferDataChanged(this, first, last);
+	else {
+		emit dataChanged(this);
+		emit dataRangeChanged(this, first, last);
+		if (p)
+			p->recalculateDependentColumns(this, first, last);
+	}
+}
+
 /**
  * \brief Set the column mode
  *
@@ -206,8 +284,7 @@ bool Column::copy(const AbstractColumn * source, int source_start, int dest_star
 void Column::handleRowInsertion(int before, int count) {
 	AbstractColumn::handleRowInsertion(before, count);
 	exec(new ColumnInsertRowsCmd(m_column_private, before, count));
-	if (!m_suppressDataChangedSignal)
-		emit dataChanged(this);
+	emitDataChanged(before);
 
 	setStatisticsAvailable(false);
 }
@@ -218,8 +295,7 @@ void Column::handleRowInsertion(int before, int count) {
 void Column::handleRowRemoval(int first, int count) {
 	AbstractColumn::handleRowRemoval(first, count);
 	exec(new ColumnRemoveRowsCmd(m_column_private, first, count));
-	if (!m_suppressDataChangedSignal)
-		emit dataChanged(this);
+	emitDataChanged(first);
 
 	setStatisticsAvailable(false);
 }
@@ -232,6 +308,24 @@ void Column::setPlotDesignation(AbstractColumn::PlotDesignation pd) {
 		exec(new ColumnSetPlotDesignationCmd(m_column_private, pd));
 }
 
+/**
+ * \brief Return the time spec used to represent the values of date and time columns
+ */
+Qt::TimeSpec Column::timeSpec() const {
+	return m_column_private->timeSpec();
+}
+
+/**
+ * \brief Set the time spec used to represent the values of date and time columns
+ *
+ * The values are stored as points in time, changing the time spec only changes
+ * how they are shown and converted to QDateTime.
+ */
+void Column::setTimeSpec(Qt::TimeSpec spec) {
+	if(spec != timeSpec())
+		exec(new ColumnSetTimeSpecCmd(m_column_private, spec));
+}
+
 /**
  * \brief Get width
  */
@@ -253,6 +347,54 @@ void Column::clear() {
 	exec(new ColumnClearCmd(m_column_private));
 }
 
+/**
+ * \brief Return an integer sort key for every row
+ *
+ * Comparing the keys of two rows gives the same result as comparing their values,
+ * rows with invalid values get the key -1. Used to sort by several columns.
+ */
+QVector<int> Column::sortKeys() const {
+	return m_column_private->sortKeys();
+}
+
+/**
+ * \brief Return the order of the rows when sorting the column
+ *
+ * Element \c i is the row to put at position \c i, invalid values are put at the end.
+ * The result can be passed to permuteRows() of this or of other columns.
+ */
+QVector<int> Column::sortPermutation(bool ascending) const {
+	return m_column_private->sortPermutation(ascending);
+}
+
+/**
+ * \brief Reorder the rows, row \c i gets the value and the mask of row \c permutation[i]
+ *
+ * Only the permutation is put on the undo stack, not the data.
+ */
+void Column::permuteRows(const QVector<int>& permutation) {
+	exec(new ColumnPermuteRowsCmd(m_column_private, permutation));
+}
+
+/**
+ * \brief Reorder the rows of several columns by the same permutation
+ *
+ * The reordered data of all columns is calculated in parallel, one task per range of chunks.
+ * Afterwards the undo commands taking over this data are pushed one after another.
+ */
+void Column::permuteRows(const QList<Column*>& columns, const QVector<int>& permutation) {
+	QThreadPool pool;
+	QVector<void*> data(columns.size());
+	for (int i = 0; i < columns.size(); ++i)
+		data[i] = columns.at(i)->m_column_private->startPermutedRows(permutation, &pool);
+	pool.waitForDone();
+
+	for (int i = 0; i < columns.size(); ++i) {
+		Column* column = columns.at(i);
+		column->exec(new ColumnPermuteRowsCmd(column->m_column_private, permutation, data.at(i)));
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //@}
 ////////////////////////////////////////////////////////////////////////////////
@@ -283,6 +425,24 @@ void Column::setFormula(const QString& formula, const QStringList& variableNames
 	exec(new ColumnSetGlobalFormulaCmd(m_column_private, formula, variableNames, columnPathes));
 }
 
+/**
+ * \brief Replace the values by the random values \c values generated by the GSL generator \c generator with \c seed
+ *
+ * The chunks of \c values are shared and not copied. The generator and the seed are kept
+ * until the values are changed otherwise, RandomValuesDialog can generate the values again with them.
+ */
+void Column::setRandomValues(const ChunkedVector<double>& values, const QString& generator, quint64 seed) {
+	exec(new ColumnSetRandomValuesCmd(m_column_private, values, generator, seed));
+}
+
+QString Column::randomGenerator() const {
+	return m_column_private->randomGenerator();
+}
+
+quint64 Column::randomSeed() const {
+	return m_column_private->randomSeed();
+}
+
 /**
  * \brief Set a formula string for an interval of rows
  */
@@ -380,7 +540,7 @@ void Column::replaceDateTimes(int first, const QList<QDateTime>& new_values) {
 /**
  * \brief Set the content of row 'row'
  *
- * Use this only when columnMode() is Numeric
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
  */
 void Column::setValueAt(int row, double new_value) {
 	setStatisticsAvailable(false);
@@ -390,7 +550,7 @@ void Column::setValueAt(int row, double new_value) {
 /**
  * \brief Replace a range of values
  *
- * Use this only when columnMode() is Numeric
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
  */
 void Column::replaceValues(int first, const QVector<double>& new_values) {
 	if (!new_values.isEmpty()) {
@@ -419,7 +579,10 @@ void Column::calculateStatistics() {
 	m_column_private->statistics = ColumnStatistics();
 	ColumnStatistics& statistics = m_column_private->statistics;
 
-	QVector<double>* rowValues = reinterpret_cast<QVector<double>*>(data());
+	//work on a contiguous double copy of the values
+	QVector<double> convertedValues(rowCount());
+	valuesAsDouble(0, convertedValues.size(), convertedValues.data());
+	const QVector<double>* rowValues = &convertedValues;
 
 	int notNanCount = 0;
 	double val;
@@ -565,14 +728,33 @@ double Column::valueAt(int row) const {
 	return m_column_private->valueAt(row);
 }
 
+/**
+ * \brief Convert \c count date and time values starting at row \c first to Julian days and write them to \c dest
+ *
+ * This is much faster than converting dateTimeAt() for every row and is used when plotting.
+ * Use this only when columnMode() is DateTime, Month or Day
+ */
+void Column::julianDays(int first, int count, double* dest) const {
+	m_column_private->julianDays(first, count, dest);
+}
+
+/**
+ * \brief Convert \c count values starting at row \c first to double and write them to \c dest
+ *
+ * Gives bulk access to the values, data() points to the values stored in chunks.
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
+ */
+void Column::valuesAsDouble(int first, int count, double* dest) const {
+	m_column_private->valuesAsDouble(first, count, dest);
+}
+
 /*
  * call this function if the data of the column was changed directly via the data()-pointer
  * and not via the setValueAt() in order to emit the dataChanged-signal.
  * This is used e.g. in \c XYFitCurvePrivate::recalculate()
  */
 void Column::setChanged() {
-	if (!m_suppressDataChangedSignal)
-		emit dataChanged(this);
+	emitDataChanged();
 
 	setStatisticsAvailable(false);
 }
@@ -587,6 +769,9 @@ void Column::setChanged() {
 QIcon Column::icon() const {
 	switch(columnMode()) {
 	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float:
 		return QIcon::fromTheme("x-shape-text");
 	case AbstractColumn::Text:
 		return QIcon::fromTheme("draw-text");
@@ -603,6 +788,15 @@ QIcon Column::icon() const {
 //@{
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+//the values of an integer or float column as one block of bytes, the chunks are stored one after another
+template<typename T> static QByteArray rawBytes(const ChunkedVector<T>* values) {
+	QByteArray bytes;
+	bytes.reserve(values->size()*sizeof(T));
+	for (int i = 0; i < values->chunkCount(); ++i)
+		bytes.append(reinterpret_cast<const char*>(values->chunkData(i)), values->chunkSize(i)*sizeof(T));
+	return bytes;
+}
+
 /**
  * \brief Save the column as XML
  */
@@ -612,6 +806,7 @@ void Column::save(QXmlStreamWriter* writer) const {
 
 	writer->writeAttribute("mode", QString::number(columnMode()));
 	writer->writeAttribute("width", QString::number(width()));
+	writer->writeAttribute("timeSpec", QString::number(timeSpec()));
 
 	//save the formula used to generate column values, if available
 	if (!formula().isEmpty() ) {
@@ -631,6 +826,14 @@ void Column::save(QXmlStreamWriter* writer) const {
 		writer->writeEndElement();
 	}
 
+	//save the generator and the seed of random values, if available
+	if (!randomGenerator().isEmpty()) {
+		writer->writeStartElement("randomSeed");
+		writer->writeAttribute("generator", randomGenerator());
+		writer->writeAttribute("seed", QString::number(randomSeed()));
+		writer->writeEndElement();
+	}
+
 	writeCommentElement(writer);
 
 	writer->writeStartElement("input_filter");
@@ -654,13 +857,18 @@ void Column::save(QXmlStreamWriter* writer) const {
 
 	int i;
 	switch(columnMode()) {
-	case AbstractColumn::Numeric: {
-			const char* data = reinterpret_cast<const char*>(
-			                       static_cast< QVector<double>* >(m_column_private->dataPointer())->constData());
-			int size = m_column_private->rowCount()*sizeof(double);
-			writer->writeCharacters(QByteArray::fromRawData(data,size).toBase64());
-			break;
-		}
+	case AbstractColumn::Numeric:
+		writer->writeCharacters(rawBytes(static_cast< ChunkedVector<double>* >(m_column_private->dataPointer())).toBase64());
+		break;
+	case AbstractColumn::Integer:
+		writer->writeCharacters(rawBytes(static_cast< ChunkedVector<int>* >(m_column_private->dataPointer())).toBase64());
+		break;
+	case AbstractColumn::BigInt:
+		writer->writeCharacters(rawBytes(static_cast< ChunkedVector<qint64>* >(m_column_private->dataPointer())).toBase64());
+		break;
+	case AbstractColumn::Float:
+		writer->writeCharacters(rawBytes(static_cast< ChunkedVector<float>* >(m_column_private->dataPointer())).toBase64());
+		break;
 	case AbstractColumn::Text:
 		for(i=0; i<rowCount(); ++i) {
 			writer->writeStartElement("row");
@@ -690,17 +898,46 @@ public:
 	DecodeColumnTask(ColumnPrivate* priv, const QString& content) {
 		m_private = priv;
 		m_content = content;
+		m_randomGenerator = priv->randomGenerator();
+		m_randomSeed = priv->randomSeed();
 	};
 	void run() {
 		QByteArray bytes = QByteArray::fromBase64(m_content.toAscii());
-		QVector<double> * data = new QVector<double>(bytes.size()/sizeof(double));
-		memcpy(data->data(), bytes.data(), bytes.size());
-		m_private->replaceData(data);
+		switch (m_private->columnMode()) {
+		case AbstractColumn::Integer:
+			m_private->replaceData(decodeChunked<int>(bytes));
+			break;
+		case AbstractColumn::BigInt:
+			m_private->replaceData(decodeChunked<qint64>(bytes));
+			break;
+		case AbstractColumn::Float:
+			m_private->replaceData(decodeChunked<float>(bytes));
+			break;
+		case AbstractColumn::Numeric:
+			m_private->replaceData(decodeChunked<double>(bytes));
+			break;
+		case AbstractColumn::Text:
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day:
+			break;
+		}
+		//replacing the data dropped the random seed read before, the decoded values are the generated ones
+		m_private->setRandomSeed(m_randomGenerator, m_randomSeed);
 	}
 
 private:
+
+	template<typename T> static ChunkedVector<T>* decodeChunked(const QByteArray& bytes) {
+		ChunkedVector<T>* data = new ChunkedVector<T>();
+		data->append(reinterpret_cast<const T*>(bytes.constData()), bytes.size()/sizeof(T));
+		return data;
+	}
+
 	ColumnPrivate* m_private;
 	QString m_content;
+	QString m_randomGenerator;
+	quint64 m_randomSeed;
 };
 
 /**
@@ -726,6 +963,11 @@ bool Column::load(XmlStreamReader* reader) {
 		else
 			setWidth(str.toInt());
 
+		//not available in older projects, local time was used there
+		str = attribs.value("timeSpec").toString();
+		if(!str.isEmpty())
+			setTimeSpec( Qt::TimeSpec(str.toInt()) );
+
 		// read child elements
 		while (!reader->atEnd()) {
 			reader->readNext();
@@ -744,6 +986,8 @@ bool Column::load(XmlStreamReader* reader) {
 					ret_val = XmlReadMask(reader);
 				else if(reader->name() == "formula")
 					ret_val = XmlReadFormula(reader);
+				else if(reader->name() == "randomSeed")
+					ret_val = XmlReadRandomSeed(reader);
 				else if(reader->name() == "row")
 					ret_val = XmlReadRow(reader);
 				else { // unknown element
@@ -754,7 +998,7 @@ bool Column::load(XmlStreamReader* reader) {
 					return false;
 			}
 			QString content = reader->text().toString().trimmed();
-			if (!content.isEmpty() && columnMode() == AbstractColumn::Numeric) {
+			if (!content.isEmpty() && isNumeric(columnMode())) {
 				DecodeColumnTask* task = new DecodeColumnTask(m_column_private, content);
 				QThreadPool::globalInstance()->start(task);
 			}
@@ -821,6 +1065,20 @@ bool Column::XmlReadFormula(XmlStreamReader* reader) {
 	return true;
 }
 
+/**
+ * \brief Read XML random seed element
+ */
+bool Column::XmlReadRandomSeed(XmlStreamReader* reader) {
+	const QXmlStreamAttributes attribs = reader->attributes();
+	bool ok;
+	const quint64 seed = attribs.value("seed").toString().toULongLong(&ok);
+	if (ok)
+		m_column_private->setRandomSeed(attribs.value("generator").toString(), seed);
+	else
+		reader->raiseWarning(i18n("invalid random seed"));
+
+	return reader->skipToEndElement();
+}
 
 //TODO: read cell formula, not implemented yet
 // bool Column::XmlReadFormula(XmlStreamReader * reader)
@@ -861,7 +1119,10 @@ bool Column::XmlReadRow(XmlStreamReader * reader) {
 
 	str = reader->readElementText();
 	switch(columnMode()) {
-	case AbstractColumn::Numeric: {
+	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float: {
 			double value = str.toDouble(&ok);
 			if(!ok) {
 				reader->raiseError(i18n("invalid row value"));
@@ -878,6 +1139,7 @@ bool Column::XmlReadRow(XmlStreamReader * reader) {
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
 		QDateTime date_time = QDateTime::fromString(str,"yyyy-dd-MM hh:mm:ss:zzz");
+		date_time.setTimeSpec(timeSpec());
 		setDateTimeAt(index, date_time);
 		break;
 	}
@@ -972,8 +1234,7 @@ void Column::handleFormatChange() {
 	}
 
 	emit aspectDescriptionChanged(this); // the icon for the type changed
-	if (!m_suppressDataChangedSignal)
-		emit dataChanged(this); // all cells must be repainted
+	emitDataChanged(); // all cells must be repainted
 
 	setStatisticsAvailable(false);
 }
@@ -35,6 +35,7 @@
 
 class ColumnStringIO;
 class ColumnPrivate;
+template<class T> class ChunkedVector;
 
 class Column : public AbstractColumn {
 	Q_OBJECT
@@ -79,6 +80,9 @@ class Column : public AbstractColumn {
 
 		explicit Column(const QString& name, AbstractColumn::ColumnMode mode = AbstractColumn::Numeric);
 		Column(const QString& name, QVector<double> data);
+		Column(const QString& name, QVector<int> data);
+		Column(const QString& name, QVector<qint64> data);
+		Column(const QString& name, QVector<float> data);
 		Column(const QString& name, QStringList data);
 		Column(const QString& name, QList<QDateTime> data);
 		void init();
@@ -94,9 +98,15 @@ class Column : public AbstractColumn {
 		int rowCount() const;
 		AbstractColumn::PlotDesignation plotDesignation() const;
 		void setPlotDesignation(AbstractColumn::PlotDesignation pd);
+		Qt::TimeSpec timeSpec() const;
+		void setTimeSpec(Qt::TimeSpec);
 		int width() const;
 		void setWidth(int value);
 		void clear();
+		QVector<int> sortKeys() const;
+		QVector<int> sortPermutation(bool ascending) const;
+		void permuteRows(const QVector<int>& permutation);
+		static void permuteRows(const QList<Column*>& columns, const QVector<int>& permutation);
 		AbstractSimpleFilter *outputFilter() const;
 		ColumnStringIO *asStringColumn() const;
 
@@ -111,6 +121,10 @@ class Column : public AbstractColumn {
 		void setFormula(int row, QString formula);
 		void clearFormulas();
 
+		void setRandomValues(const ChunkedVector<double>& values, const QString& generator, quint64 seed);
+		QString randomGenerator() const;
+		quint64 randomSeed() const;
+
 		const ColumnStatistics& statistics();
 		void* data() const;
 		QString textAt(int row) const;
@@ -126,6 +140,8 @@ class Column : public AbstractColumn {
 		double valueAt(int row) const;
 		void setValueAt(int row, double new_value);
 		virtual void replaceValues(int first, const QVector<double>& new_values);
+		void valuesAsDouble(int first, int count, double* dest) const;
+		void julianDays(int first, int count, double* dest) const;
 		void setChanged();
 		void setSuppressDataChangedSignal(bool);
 
@@ -136,10 +152,13 @@ class Column : public AbstractColumn {
 		bool XmlReadInputFilter(XmlStreamReader * reader);
 		bool XmlReadOutputFilter(XmlStreamReader * reader);
 		bool XmlReadFormula(XmlStreamReader * reader);
+		bool XmlReadRandomSeed(XmlStreamReader * reader);
 		bool XmlReadRow(XmlStreamReader * reader);
 
 		void handleRowInsertion(int before, int count);
 		void handleRowRemoval(int first, int count);
+		void emitDataAboutToChange();
+		void emitDataChanged(int first = 0, int last = -1);
 
 		void calculateStatistics();
 		void setStatisticsAvailable(bool available);
@@ -154,6 +173,7 @@ class Column : public AbstractColumn {
 	signals:
 		void widthAboutToChange(const Column*);
 		void widthChanged(const Column*);
+		void dataRangeChanged(const AbstractColumn*, int first, int last);
 
 	private slots:
 		void handleFormatChange();
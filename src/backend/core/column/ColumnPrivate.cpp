@@ -28,6 +28,9 @@
 
 #include "ColumnPrivate.h"
 #include "backend/core/AbstractSimpleFilter.h"
+#include "backend/core/Project.h"
+#include "backend/lib/ChunkedVector.h"
+#include "backend/lib/TextDictionary.h"
 #include "backend/core/datatypes/SimpleCopyThroughFilter.h"
 #include "backend/core/datatypes/String2DoubleFilter.h"
 #include "backend/core/datatypes/Double2StringFilter.h"
@@ -42,6 +45,301 @@
 #include "backend/core/datatypes/DayOfWeek2DoubleFilter.h"
 #include "backend/core/datatypes/Month2DoubleFilter.h"
 
+#include <QThreadPool>
+#include <QTimeZone>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+//conversion of double values to the integer storage types, the smallest value of the type marks
+//a missing value. NAN and values out of range are stored as missing
+static int toInt(double value) {
+	if (!(value >= -std::numeric_limits<int>::max() && value <= std::numeric_limits<int>::max()))
+		return ColumnPrivate::missingInt();
+	return qRound(value);
+}
+
+static qint64 toBigInt(double value) {
+	// +-2^63 are not representable anymore, -2^63 is the missing value
+	if (!(value > -9223372036854775808.0 && value < 9223372036854775808.0))
+		return ColumnPrivate::missingBigInt();
+	return qRound64(value);
+}
+
+//converts the values of an Integer or BigInt column to double, missing values become NAN
+template <typename T>
+static void integersAsDouble(const ChunkedVector<T>* vec, int first, int count, double* dest) {
+	T buffer[1024];
+	while (count > 0) {
+		const int n = qMin(count, 1024);
+		vec->read(first, n, buffer);
+		for (int i = 0; i < n; ++i)
+			dest[i] = (buffer[i] == std::numeric_limits<T>::min()) ? NAN : static_cast<double>(buffer[i]);
+		first += n;
+		dest += n;
+		count -= n;
+	}
+}
+
+//copies values between two columns stored in chunks, complete chunks are shared and not copied.
+//New rows in front of dest_start and the rows behind the end of the source are set to empty_value
+template <typename T>
+static void copyChunks(void* dest, const void* source, int source_start, int dest_start, int num_rows, const T& empty_value) {
+	ChunkedVector<T>* dest_vector = static_cast< ChunkedVector<T>* >(dest);
+	//source and dest can be the same column, the copy keeps the unmodified chunks
+	const ChunkedVector<T> source_vector = *static_cast< const ChunkedVector<T>* >(source);
+	const int count = qBound(0, source_vector.size() - source_start, num_rows);
+	if (dest_start == 0 && num_rows >= dest_vector->size()) {
+		*dest_vector = source_vector.mid(source_start, count);
+		dest_vector->resize(num_rows, empty_value);
+		return;
+	}
+
+	if (dest_start + num_rows > dest_vector->size())
+		dest_vector->resize(dest_start + num_rows, empty_value);
+	dest_vector->replace(dest_start, source_vector, source_start, count);
+	for (int i = dest_start + count; i < dest_start + num_rows; ++i)
+		dest_vector->replace(i, empty_value);
+}
+
+//number of rows from which on a permutation is applied in parallel
+static const int ParallelPermutationSize = 100000;
+
+//gathers the chunks [first, last) of a column, see ChunkedVector::gatherChunk().
+//The source and the permutation are implicitly shared copies, the task may outlive the caller's objects
+template <typename T>
+class GatherChunksTask : public QRunnable {
+	public:
+		GatherChunksTask(ChunkedVector<T>* dest, const ChunkedVector<T>& source, const QVector<int>& permutation, int first, int last)
+			: m_dest(dest), m_source(source), m_permutation(permutation), m_first(first), m_last(last) {}
+
+		virtual void run() {
+			for (int chunk = m_first; chunk < m_last; ++chunk)
+				m_dest->gatherChunk(chunk, m_source, m_permutation);
+		}
+
+	private:
+		ChunkedVector<T>* m_dest;
+		const ChunkedVector<T> m_source;
+		const QVector<int> m_permutation;
+		int m_first;
+		int m_last;
+};
+
+//reorders a copy of a text column
+class PermuteTextTask : public QRunnable {
+	public:
+		PermuteTextTask(TextDictionary* dest, const QVector<int>& permutation)
+			: m_dest(dest), m_permutation(permutation) {}
+
+		virtual void run() {
+			m_dest->permute(m_permutation);
+		}
+
+	private:
+		TextDictionary* m_dest;
+		const QVector<int> m_permutation;
+};
+
+//reorders the values of a column stored in chunks, row i gets the value of row permutation[i].
+//Large columns are split into one range of chunks per thread, unchanged chunks stay shared
+template <typename T>
+static void permuteChunks(void* data, const QVector<int>& permutation) {
+	ChunkedVector<T>* vector = static_cast< ChunkedVector<T>* >(data);
+	QThreadPool pool;
+	if (permutation.size() < ParallelPermutationSize || pool.maxThreadCount() < 2) {
+		vector->permute(permutation);
+		return;
+	}
+
+	const ChunkedVector<T> source = *vector;
+	vector->detachChunkList();
+	const int chunks = vector->chunkCount();
+	const int range = (chunks + pool.maxThreadCount() - 1)/pool.maxThreadCount();
+	for (int first = 0; first < chunks; first += range)
+		pool.start(new GatherChunksTask<T>(vector, source, permutation, first, qMin(first + range, chunks)));
+	pool.waitForDone();
+}
+
+//starts the permutation of a copy of a column stored in chunks in \c pool, the copy is
+//padded with \c empty_value to the size of the permutation. Returns the copy,
+//it must not be used before the tasks in \c pool are done.
+template <typename T>
+static void* startPermutedCopy(const void* data, const QVector<int>& permutation, const T& empty_value, QThreadPool* pool) {
+	ChunkedVector<T>* vector = new ChunkedVector<T>(*static_cast< const ChunkedVector<T>* >(data));
+	if (vector->size() < permutation.size())
+		vector->resize(permutation.size(), empty_value);
+
+	const ChunkedVector<T> source = *vector;
+	vector->detachChunkList();
+	const int chunks = vector->chunkCount();
+	const int threads = qMax(1, pool->maxThreadCount());
+	const int range = qMax(1, (chunks + threads - 1)/threads);
+	for (int first = 0; first < chunks; first += range)
+		pool->start(new GatherChunksTask<T>(vector, source, permutation, first, qMin(first + range, chunks)));
+	return vector;
+}
+
+//replaces the values of \c data by the ones of \c permuted and deletes \c permuted.
+//The storage object itself is kept, undo commands may hold pointers to it.
+template <typename T>
+static void takePermutedCopy(void* data, void* permuted) {
+	ChunkedVector<T>* vector = static_cast< ChunkedVector<T>* >(permuted);
+	*static_cast< ChunkedVector<T>* >(data) = *vector;
+	delete vector;
+}
+
+//orders (key, row) pairs by their keys, equal keys by their rows
+template <typename T>
+class KeyLess {
+	public:
+		bool operator()(const QPair<T, int>& a, const QPair<T, int>& b) const {
+			if (a.first < b.first)
+				return true;
+			if (b.first < a.first)
+				return false;
+			return a.second < b.second;
+		}
+};
+
+//number of values from which on the (key, row) pairs are sorted in parallel
+static const int ParallelSortSize = 100000;
+
+//sorts the (key, row) pairs in [start, end)
+template <typename T>
+class SortPairsTask : public QRunnable {
+	public:
+		SortPairsTask(QPair<T, int>* pairs, int start, int end)
+			: m_pairs(pairs), m_start(start), m_end(end) {}
+
+		virtual void run() {
+			std::sort(m_pairs + m_start, m_pairs + m_end, KeyLess<T>());
+		}
+
+	private:
+		QPair<T, int>* m_pairs;
+		int m_start;
+		int m_end;
+};
+
+//merges the sorted ranges [start, middle) and [middle, end) of src into dest
+template <typename T>
+class MergePairsTask : public QRunnable {
+	public:
+		MergePairsTask(const QPair<T, int>* src, QPair<T, int>* dest, int start, int middle, int end)
+			: m_src(src), m_dest(dest), m_start(start), m_middle(middle), m_end(end) {}
+
+		virtual void run() {
+			std::merge(m_src + m_start, m_src + m_middle, m_src + m_middle, m_src + m_end, m_dest + m_start, KeyLess<T>());
+		}
+
+	private:
+		const QPair<T, int>* m_src;
+		QPair<T, int>* m_dest;
+		int m_start;
+		int m_middle;
+		int m_end;
+};
+
+//sorts the (key, row) pairs with a merge sort: one block per thread is sorted in parallel,
+//then the blocks are merged pairwise, the merges of one level run in parallel.
+//The rows make all pairs distinct, the result doesn't depend on the number of threads.
+template <typename T>
+static void sortPairs(QVector< QPair<T, int> >& pairs) {
+	const int count = pairs.size();
+	QThreadPool pool;
+	if (count < ParallelSortSize || pool.maxThreadCount() < 2) {
+		std::sort(pairs.begin(), pairs.end(), KeyLess<T>());
+		return;
+	}
+
+	const int blockSize = (count + pool.maxThreadCount() - 1)/pool.maxThreadCount();
+	for (int start = 0; start < count; start += blockSize)
+		pool.start(new SortPairsTask<T>(pairs.data(), start, qMin(start + blockSize, count)));
+	pool.waitForDone();
+
+	QVector< QPair<T, int> > buffer(count);
+	for (int width = blockSize; width < count; width *= 2) {
+		for (int start = 0; start < count; start += 2*width) {
+			const int middle = qMin(start + width, count);
+			const int end = qMin(start + 2*width, count);
+			pool.start(new MergePairsTask<T>(pairs.constData(), buffer.data(), start, middle, end));
+		}
+		pool.waitForDone();
+		pairs.swap(buffer);
+	}
+}
+
+//returns for every row the rank of its key among the distinct keys, -1 for the rows not contained in keys
+template <typename T>
+static QVector<int> denseRanks(QVector< QPair<T, int> >& keys, int rows) {
+	sortPairs(keys);
+
+	QVector<int> ranks(rows, -1);
+	int rank = -1;
+	for (int i = 0; i < keys.size(); ++i) {
+		if (i == 0 || keys.at(i-1).first < keys.at(i).first)
+			++rank;
+		ranks[keys.at(i).second] = rank;
+	}
+	return ranks;
+}
+
+//allocates an empty data vector for one of the numeric column modes
+static void* numericData(AbstractColumn::ColumnMode mode) {
+	switch(mode) {
+	case AbstractColumn::Integer:
+		return new ChunkedVector<int>();
+	case AbstractColumn::BigInt:
+		return new ChunkedVector<qint64>();
+	case AbstractColumn::Float:
+		return new ChunkedVector<float>();
+	case AbstractColumn::Numeric:
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	return new ChunkedVector<double>();
+}
+
+//returns the values of the numeric column \c column converted to the storage type of the numeric mode \c mode.
+//The values are converted block by block, no temporary column is needed
+static void* convertedNumericData(const ColumnPrivate* column, AbstractColumn::ColumnMode mode) {
+	void* data = numericData(mode);
+	const int rows = column->rowCount();
+	double buffer[1024];
+	for (int first = 0; first < rows; first += 1024) {
+		const int count = qMin(1024, rows - first);
+		column->valuesAsDouble(first, count, buffer);
+		switch(mode) {
+		case AbstractColumn::Integer:
+			for (int i = 0; i < count; ++i)
+				static_cast< ChunkedVector<int>* >(data)->append(toInt(buffer[i]));
+			break;
+		case AbstractColumn::BigInt:
+			for (int i = 0; i < count; ++i)
+				static_cast< ChunkedVector<qint64>* >(data)->append(toBigInt(buffer[i]));
+			break;
+		case AbstractColumn::Float:
+			static_cast< ChunkedVector<float>* >(data)->append(buffer, count);
+			break;
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Text:
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day:
+			static_cast< ChunkedVector<double>* >(data)->append(buffer, count);
+			break;
+		}
+	}
+	return data;
+}
+
 
 /**
  * \class ColumnPrivate
@@ -62,8 +360,21 @@
  * \var ColumnPrivate::m_data
  * \brief Pointer to the data vector
  *
- * This will point to a QVector<double>, QStringList or
- * QList<QDateTime> depending on the stored data type.
+ * This will point to a ChunkedVector<double>, ChunkedVector<int>, ChunkedVector<qint64>,
+ * ChunkedVector<float> or TextDictionary depending on the stored data type.
+ * The chunks of the numeric and date and time columns are shared between copies of the data,
+ * e.g. with the backups of undo commands, and are only copied when they are modified.
+ * Inserting and removing rows only moves the values of the affected chunk.
+ * Text is stored dictionary-encoded, i.e. every row only holds
+ * an integer code into a table of the distinct strings.
+ * Date and time values are stored as milliseconds since the epoch (UTC),
+ * invalid values as invalidDateTime(). They are converted to QDateTime
+ * according to m_timeSpec when accessed.
+ */
+
+/**
+ * \var ColumnPrivate::m_timeSpec
+ * \brief The time spec used to convert the stored date and time values to QDateTime
  */
 
 /**
@@ -95,36 +406,51 @@
  * \brief Ctor
  */
 ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode)
-	: statisticsAvailable(false), m_column_mode(mode), m_plot_designation(AbstractColumn::noDesignation), m_width(0), m_owner(owner) {
+	: statisticsAvailable(false), m_column_mode(mode), m_timeSpec(Qt::LocalTime), m_randomSeed(0), m_plot_designation(AbstractColumn::noDesignation), m_width(0), m_owner(owner) {
 	Q_ASSERT(owner != 0); // a ColumnPrivate without owner is not allowed
 	// because the owner must become the parent aspect of the input and output filters
 	switch(mode) {
 	case AbstractColumn::Numeric:
 		m_input_filter = new String2DoubleFilter();
 		m_output_filter = new Double2StringFilter();
-		m_data = new QVector<double>();
+		m_data = new ChunkedVector<double>();
+		break;
+	case AbstractColumn::Integer:
+		m_input_filter = new String2DoubleFilter();
+		m_output_filter = new Double2StringFilter('f', 0);
+		m_data = new ChunkedVector<int>();
+		break;
+	case AbstractColumn::BigInt:
+		m_input_filter = new String2DoubleFilter();
+		m_output_filter = new Double2StringFilter('f', 0);
+		m_data = new ChunkedVector<qint64>();
+		break;
+	case AbstractColumn::Float:
+		m_input_filter = new String2DoubleFilter();
+		m_output_filter = new Double2StringFilter();
+		m_data = new ChunkedVector<float>();
 		break;
 	case AbstractColumn::Text:
 		m_input_filter = new SimpleCopyThroughFilter();
 		m_output_filter = new SimpleCopyThroughFilter();
-		m_data = new QStringList();
+		m_data = new TextDictionary();
 		break;
 	case AbstractColumn::DateTime:
 		m_input_filter = new String2DateTimeFilter();
 		m_output_filter = new DateTime2StringFilter();
-		m_data = new QList<QDateTime>();
+		m_data = new ChunkedVector<qint64>();
 		break;
 	case AbstractColumn::Month:
 		m_input_filter = new String2MonthFilter();
 		m_output_filter = new DateTime2StringFilter();
 		static_cast<DateTime2StringFilter *>(m_output_filter)->setFormat("MMMM");
-		m_data = new QList<QDateTime>();
+		m_data = new ChunkedVector<qint64>();
 		break;
 	case AbstractColumn::Day:
 		m_input_filter = new String2DayOfWeekFilter();
 		m_output_filter = new DateTime2StringFilter();
 		static_cast<DateTime2StringFilter *>(m_output_filter)->setFormat("dddd");
-		m_data = new QList<QDateTime>();
+		m_data = new ChunkedVector<qint64>();
 		break;
 	}
 
@@ -138,15 +464,23 @@ ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode)
  * \brief Special ctor (to be called from Column only!)
  */
 ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode, void* data)
-	: statisticsAvailable(false), m_column_mode(mode), m_data(data), m_plot_designation(AbstractColumn::noDesignation), m_width(0), m_owner(owner) {
+	: statisticsAvailable(false), m_column_mode(mode), m_data(data), m_timeSpec(Qt::LocalTime), m_randomSeed(0), m_plot_designation(AbstractColumn::noDesignation), m_width(0), m_owner(owner) {
 
 	switch(mode) {
 	case AbstractColumn::Numeric:
+	case AbstractColumn::Float:
 		m_input_filter = new String2DoubleFilter();
 		m_output_filter = new Double2StringFilter();
 		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
 		break;
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+		m_input_filter = new String2DoubleFilter();
+		m_output_filter = new Double2StringFilter('f', 0);
+		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
+		        m_owner, SLOT(handleFormatChange()));
+		break;
 	case AbstractColumn::Text:
 		m_input_filter = new SimpleCopyThroughFilter();
 		m_output_filter = new SimpleCopyThroughFilter();
@@ -185,17 +519,29 @@ ColumnPrivate::~ColumnPrivate() {
 
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric:
-		delete static_cast< QVector<double>* >(m_data);
+		delete static_cast< ChunkedVector<double>* >(m_data);
+		break;
+
+	case AbstractColumn::Integer:
+		delete static_cast< ChunkedVector<int>* >(m_data);
+		break;
+
+	case AbstractColumn::BigInt:
+		delete static_cast< ChunkedVector<qint64>* >(m_data);
+		break;
+
+	case AbstractColumn::Float:
+		delete static_cast< ChunkedVector<float>* >(m_data);
 		break;
 
 	case AbstractColumn::Text:
-		delete static_cast< QStringList* >(m_data);
+		delete static_cast< TextDictionary* >(m_data);
 		break;
 
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
-		delete static_cast< QList<QDateTime>* >(m_data);
+		delete static_cast< ChunkedVector<qint64>* >(m_data);
 		break;
 	} // switch(m_column_mode)
 }
@@ -230,40 +576,51 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 	AbstractSimpleFilter* new_out_filter = 0;
 	bool filter_is_temporary = false; // it can also become outputFilter(), which we may not delete here
 	Column* temp_col = 0;
+	bool converted = false; // the values were converted without temp_col
 
 	emit m_owner->modeAboutToChange(m_owner);
 
 	// determine the conversion filter and allocate the new data vector
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float:
 		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		           m_owner, SLOT(handleFormatChange()));
 		switch(mode) {
 		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float:
+			// only the storage type changes
+			m_owner->emitDataAboutToChange();
+			m_data = convertedNumericData(this, mode);
+			converted = true;
 			break;
 		case AbstractColumn::Text:
 			filter = outputFilter();
 			filter_is_temporary = false;
-			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QStringList();
+			temp_col = new Column("temp_col", doubleVector(old_data));
+			m_data = new TextDictionary();
 			break;
 		case AbstractColumn::DateTime:
 			filter = new Double2DateTimeFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QList<QDateTime>();
+			temp_col = new Column("temp_col", doubleVector(old_data));
+			m_data = new ChunkedVector<qint64>();
 			break;
 		case AbstractColumn::Month:
 			filter = new Double2MonthFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QList<QDateTime>();
+			temp_col = new Column("temp_col", doubleVector(old_data));
+			m_data = new ChunkedVector<qint64>();
 			break;
 		case AbstractColumn::Day:
 			filter = new Double2DayOfWeekFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QVector<double>* >(old_data)));
-			m_data = new QList<QDateTime>();
+			temp_col = new Column("temp_col", doubleVector(old_data));
+			m_data = new ChunkedVector<qint64>();
 			break;
 		} // switch(mode)
 		break;
@@ -273,28 +630,31 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 		case AbstractColumn::Text:
 			break;
 		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float:
 			filter = new String2DoubleFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
-			m_data = new QVector<double>();
+			temp_col = new Column("temp_col", static_cast< TextDictionary* >(old_data)->toStringList());
+			m_data = numericData(mode);
 			break;
 		case AbstractColumn::DateTime:
 			filter = new String2DateTimeFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
-			m_data = new QList<QDateTime>();
+			temp_col = new Column("temp_col", static_cast< TextDictionary* >(old_data)->toStringList());
+			m_data = new ChunkedVector<qint64>();
 			break;
 		case AbstractColumn::Month:
 			filter = new String2MonthFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
-			m_data = new QList<QDateTime>();
+			temp_col = new Column("temp_col", static_cast< TextDictionary* >(old_data)->toStringList());
+			m_data = new ChunkedVector<qint64>();
 			break;
 		case AbstractColumn::Day:
 			filter = new String2DayOfWeekFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QStringList* >(old_data)));
-			m_data = new QList<QDateTime>();
+			temp_col = new Column("temp_col", static_cast< TextDictionary* >(old_data)->toStringList());
+			m_data = new ChunkedVector<qint64>();
 			break;
 		} // switch(mode)
 		break;
@@ -310,10 +670,13 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 		case AbstractColumn::Text:
 			filter = outputFilter();
 			filter_is_temporary = false;
-			temp_col = new Column("temp_col", *(static_cast< QList<QDateTime>* >(old_data)));
-			m_data = new QStringList();
+			temp_col = new Column("temp_col", dateTimeList(old_data));
+			m_data = new TextDictionary();
 			break;
 		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float:
 			if (m_column_mode == AbstractColumn::Month)
 				filter = new Month2DoubleFilter();
 			else if (m_column_mode == AbstractColumn::Day)
@@ -321,8 +684,8 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 			else
 				filter = new DateTime2DoubleFilter();
 			filter_is_temporary = true;
-			temp_col = new Column("temp_col", *(static_cast< QList<QDateTime>* >(old_data)));
-			m_data = new QVector<double>();
+			temp_col = new Column("temp_col", dateTimeList(old_data));
+			m_data = numericData(mode);
 			break;
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
@@ -335,11 +698,19 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 	// determine the new input and output filters
 	switch(mode) {
 	case AbstractColumn::Numeric:
+	case AbstractColumn::Float:
 		new_in_filter = new String2DoubleFilter();
 		new_out_filter = new Double2StringFilter();
 		connect(static_cast<Double2StringFilter *>(new_out_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
 		break;
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+		new_in_filter = new String2DoubleFilter();
+		new_out_filter = new Double2StringFilter('f', 0);
+		connect(static_cast<Double2StringFilter *>(new_out_filter), SIGNAL(formatChanged()),
+		        m_owner, SLOT(handleFormatChange()));
+		break;
 	case AbstractColumn::Text:
 		new_in_filter = new SimpleCopyThroughFilter();
 		new_out_filter = new SimpleCopyThroughFilter();
@@ -379,10 +750,14 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 
 	if (temp_col) { // if temp_col == 0, only the input/output filters need to be changed
 		// copy the filtered, i.e. converted, column
-		filter->input(0, temp_col);
-		copy(filter->output(0));
+		if (filter) {
+			filter->input(0, temp_col);
+			copy(filter->output(0));
+		} else
+			copy(temp_col);
 		delete temp_col;
-	}
+	} else if (converted)
+		m_owner->emitDataChanged();
 
 	if (filter_is_temporary) delete filter;
 
@@ -400,6 +775,9 @@ void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void * data
 	// disconnect formatChanged()
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float:
 		disconnect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		           m_owner, SLOT(handleFormatChange()));
 		break;
@@ -426,6 +804,9 @@ void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void * data
 	// connect formatChanged()
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float:
 		connect(static_cast<Double2StringFilter *>(m_output_filter), SIGNAL(formatChanged()),
 		        m_owner, SLOT(handleFormatChange()));
 		break;
@@ -446,10 +827,9 @@ void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void * data
  * \brief Replace data pointer
  */
 void ColumnPrivate::replaceData(void * data) {
-	emit m_owner->dataAboutToChange(m_owner);
+	m_owner->emitDataAboutToChange();
 	m_data = data;
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged();
 }
 
 /**
@@ -460,36 +840,66 @@ void ColumnPrivate::replaceData(void * data) {
  * Use a filter to convert a column to another type.
  */
 bool ColumnPrivate::copy(const AbstractColumn * other) {
-	if (other->columnMode() != columnMode()) return false;
+	if (!isCompatible(other->columnMode())) return false;
+
+	// columns of the same type share their data instead of copying it value by value
+	const Column* column = qobject_cast<const Column*>(other);
+	if (column && column->columnMode() == m_column_mode)
+		return copy(column->m_column_private);
+
 	int num_rows = other->rowCount();
 
-	emit m_owner->dataAboutToChange(m_owner);
+	m_owner->emitDataAboutToChange();
 	resizeTo(num_rows);
 
 	// copy the data
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric: {
-			double * ptr = static_cast< QVector<double>* >(m_data)->data();
+			ChunkedVector<double>* vec = static_cast< ChunkedVector<double>* >(m_data);
+			for(int i=0; i<num_rows; i++)
+				vec->replace(i, other->valueAt(i));
+			break;
+		}
+	case AbstractColumn::Integer: {
+			ChunkedVector<int>* vec = static_cast< ChunkedVector<int>* >(m_data);
+			for(int i=0; i<num_rows; i++)
+				vec->replace(i, toInt(other->valueAt(i)));
+			break;
+		}
+	case AbstractColumn::BigInt: {
+			ChunkedVector<qint64>* vec = static_cast< ChunkedVector<qint64>* >(m_data);
+			for(int i=0; i<num_rows; i++)
+				vec->replace(i, toBigInt(other->valueAt(i)));
+			break;
+		}
+	case AbstractColumn::Float: {
+			ChunkedVector<float>* vec = static_cast< ChunkedVector<float>* >(m_data);
 			for(int i=0; i<num_rows; i++)
-				ptr[i] = other->valueAt(i);
+				vec->replace(i, other->valueAt(i));
 			break;
 		}
 	case AbstractColumn::Text: {
 			for(int i=0; i<num_rows; i++)
-				static_cast< QStringList* >(m_data)->replace(i, other->textAt(i));
+				static_cast< TextDictionary* >(m_data)->replace(i, other->textAt(i));
 			break;
 		}
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day: {
-			for(int i=0; i<num_rows; i++)
-				static_cast< QList<QDateTime>* >(m_data)->replace(i, other->dateTimeAt(i));
+			// values provided by filters (e.g. string input) are wall-clock times in the time spec of this column
+			const bool wallClock = (qobject_cast<const Column*>(other) == 0);
+			ChunkedVector<qint64>* vec = static_cast< ChunkedVector<qint64>* >(m_data);
+			for(int i=0; i<num_rows; i++) {
+				QDateTime dateTime = other->dateTimeAt(i);
+				if (wallClock)
+					dateTime.setTimeSpec(m_timeSpec);
+				vec->replace(i, toMSecs(dateTime));
+			}
 			break;
 		}
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged();
 
 	return true;
 }
@@ -505,35 +915,63 @@ bool ColumnPrivate::copy(const AbstractColumn * other) {
  * \param num_rows the number of rows to copy
  */
 bool ColumnPrivate::copy(const AbstractColumn * source, int source_start, int dest_start, int num_rows) {
-	if (source->columnMode() != m_column_mode) return false;
+	if (!isCompatible(source->columnMode())) return false;
 	if (num_rows == 0) return true;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	const Column* column = qobject_cast<const Column*>(source);
+	if (column && column->columnMode() == m_column_mode)
+		return copy(column->m_column_private, source_start, dest_start, num_rows);
+
+	m_owner->emitDataAboutToChange();
 	if (dest_start + num_rows > rowCount())
 		resizeTo(dest_start + num_rows);
 
 	// copy the data
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric: {
-			double * ptr = static_cast< QVector<double>* >(m_data)->data();
+			ChunkedVector<double>* vec = static_cast< ChunkedVector<double>* >(m_data);
+			for(int i=0; i<num_rows; i++)
+				vec->replace(dest_start+i, source->valueAt(source_start + i));
+			break;
+		}
+	case AbstractColumn::Integer: {
+			ChunkedVector<int>* vec = static_cast< ChunkedVector<int>* >(m_data);
 			for(int i=0; i<num_rows; i++)
-				ptr[dest_start+i] = source->valueAt(source_start + i);
+				vec->replace(dest_start+i, toInt(source->valueAt(source_start + i)));
+			break;
+		}
+	case AbstractColumn::BigInt: {
+			ChunkedVector<qint64>* vec = static_cast< ChunkedVector<qint64>* >(m_data);
+			for(int i=0; i<num_rows; i++)
+				vec->replace(dest_start+i, toBigInt(source->valueAt(source_start + i)));
+			break;
+		}
+	case AbstractColumn::Float: {
+			ChunkedVector<float>* vec = static_cast< ChunkedVector<float>* >(m_data);
+			for(int i=0; i<num_rows; i++)
+				vec->replace(dest_start+i, source->valueAt(source_start + i));
 			break;
 		}
 	case AbstractColumn::Text:
 		for(int i=0; i<num_rows; i++)
-			static_cast< QStringList* >(m_data)->replace(dest_start+i, source->textAt(source_start + i));
+			static_cast< TextDictionary* >(m_data)->replace(dest_start+i, source->textAt(source_start + i));
 		break;
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
-	case AbstractColumn::Day:
-		for(int i=0; i<num_rows; i++)
-			static_cast< QList<QDateTime>* >(m_data)->replace(dest_start+i, source->dateTimeAt(source_start + i));
-		break;
+	case AbstractColumn::Day: {
+			const bool wallClock = (qobject_cast<const Column*>(source) == 0);
+			ChunkedVector<qint64>* vec = static_cast< ChunkedVector<qint64>* >(m_data);
+			for(int i=0; i<num_rows; i++) {
+				QDateTime dateTime = source->dateTimeAt(source_start + i);
+				if (wallClock)
+					dateTime.setTimeSpec(m_timeSpec);
+				vec->replace(dest_start+i, toMSecs(dateTime));
+			}
+			break;
+		}
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(dest_start, dest_start + num_rows - 1);
 
 	return true;
 }
@@ -547,35 +985,37 @@ bool ColumnPrivate::copy(const AbstractColumn * source, int source_start, int de
  */
 bool ColumnPrivate::copy(const ColumnPrivate * other) {
 	if (other->columnMode() != m_column_mode) return false;
-	int num_rows = other->rowCount();
 
-	emit m_owner->dataAboutToChange(m_owner);
-	resizeTo(num_rows);
+	m_owner->emitDataAboutToChange();
 
 	// copy the data
 	switch(m_column_mode) {
-	case AbstractColumn::Numeric: {
-			double * ptr = static_cast< QVector<double>* >(m_data)->data();
-			for(int i=0; i<num_rows; i++)
-				ptr[i] = other->valueAt(i);
-			break;
-		}
-	case AbstractColumn::Text: {
-			for(int i=0; i<num_rows; i++)
-				static_cast< QStringList* >(m_data)->replace(i, other->textAt(i));
-			break;
-		}
+	case AbstractColumn::Numeric:
+		// only the chunks modified later on are copied
+		*static_cast< ChunkedVector<double>* >(m_data) = *static_cast< ChunkedVector<double>* >(other->m_data);
+		break;
+	case AbstractColumn::Integer:
+		*static_cast< ChunkedVector<int>* >(m_data) = *static_cast< ChunkedVector<int>* >(other->m_data);
+		break;
+	case AbstractColumn::BigInt:
+		*static_cast< ChunkedVector<qint64>* >(m_data) = *static_cast< ChunkedVector<qint64>* >(other->m_data);
+		break;
+	case AbstractColumn::Float:
+		*static_cast< ChunkedVector<float>* >(m_data) = *static_cast< ChunkedVector<float>* >(other->m_data);
+		break;
+	case AbstractColumn::Text:
+		// codes and dictionary are implicitly shared, no need to copy row by row
+		*static_cast< TextDictionary* >(m_data) = *static_cast< TextDictionary* >(other->m_data);
+		break;
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
-	case AbstractColumn::Day: {
-			for(int i=0; i<num_rows; i++)
-				static_cast< QList<QDateTime>* >(m_data)->replace(i, other->dateTimeAt(i));
-			break;
-		}
+	case AbstractColumn::Day:
+		// the stored values are points in time independent of the time spec
+		*static_cast< ChunkedVector<qint64>* >(m_data) = *static_cast< ChunkedVector<qint64>* >(other->m_data);
+		break;
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged();
 
 	return true;
 }
@@ -594,36 +1034,90 @@ bool ColumnPrivate::copy(const ColumnPrivate * source, int source_start, int des
 	if (source->columnMode() != m_column_mode) return false;
 	if (num_rows == 0) return true;
 
-	emit m_owner->dataAboutToChange(m_owner);
-	if (dest_start + num_rows > rowCount())
+	m_owner->emitDataAboutToChange();
+	// all columns but text columns are resized in copyChunks()
+	if (m_column_mode == AbstractColumn::Text && dest_start + num_rows > rowCount())
 		resizeTo(dest_start + num_rows);
 
-	// copy the data
+	// copy the data, the complete chunks within the range are shared with the source
 	switch(m_column_mode) {
-	case AbstractColumn::Numeric: {
-			double * ptr = static_cast< QVector<double>* >(m_data)->data();
-			for(int i=0; i<num_rows; i++)
-				ptr[dest_start+i] = source->valueAt(source_start + i);
-			break;
-		}
+	case AbstractColumn::Numeric:
+		copyChunks<double>(m_data, source->m_data, source_start, dest_start, num_rows, NAN);
+		break;
+	case AbstractColumn::Integer:
+		copyChunks<int>(m_data, source->m_data, source_start, dest_start, num_rows, missingInt());
+		break;
+	case AbstractColumn::BigInt:
+		copyChunks<qint64>(m_data, source->m_data, source_start, dest_start, num_rows, missingBigInt());
+		break;
+	case AbstractColumn::Float:
+		copyChunks<float>(m_data, source->m_data, source_start, dest_start, num_rows, NAN);
+		break;
 	case AbstractColumn::Text:
 		for(int i=0; i<num_rows; i++)
-			static_cast< QStringList* >(m_data)->replace(dest_start+i, source->textAt(source_start + i));
+			static_cast< TextDictionary* >(m_data)->replace(dest_start+i, source->textAt(source_start + i));
 		break;
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
-		for(int i=0; i<num_rows; i++)
-			static_cast< QList<QDateTime>* >(m_data)->replace(dest_start+i, source->dateTimeAt(source_start + i));
+		copyChunks<qint64>(m_data, source->m_data, source_start, dest_start, num_rows, invalidDateTime());
 		break;
 	}
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(dest_start, dest_start + num_rows - 1);
 
 	return true;
 }
 
+/**
+ * \brief Return whether values of a column with the mode \c mode can be copied into this column
+ *
+ * Besides columns of the same mode this is the case for all numeric modes,
+ * the values are converted to the storage type of this column.
+ */
+bool ColumnPrivate::isCompatible(AbstractColumn::ColumnMode mode) const {
+	if (mode == m_column_mode)
+		return true;
+	return AbstractColumn::isNumeric(mode) && AbstractColumn::isNumeric(m_column_mode);
+}
+
+/**
+ * \brief Return the numeric values in \c data, stored according to the current column mode, as doubles
+ */
+QVector<double> ColumnPrivate::doubleVector(void* data) const {
+	QVector<double> values;
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		values = static_cast< ChunkedVector<double>* >(data)->toVector();
+		break;
+	case AbstractColumn::Integer: {
+			const ChunkedVector<int>* vec = static_cast< ChunkedVector<int>* >(data);
+			values.resize(vec->size());
+			integersAsDouble(vec, 0, vec->size(), values.data());
+			break;
+		}
+	case AbstractColumn::BigInt: {
+			const ChunkedVector<qint64>* vec = static_cast< ChunkedVector<qint64>* >(data);
+			values.resize(vec->size());
+			integersAsDouble(vec, 0, vec->size(), values.data());
+			break;
+		}
+	case AbstractColumn::Float: {
+			const ChunkedVector<float>* vec = static_cast< ChunkedVector<float>* >(data);
+			values.resize(vec->size());
+			vec->read(0, vec->size(), values.data());
+			break;
+		}
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	return values;
+}
+
 /**
  * \brief Return the data vector size
  *
@@ -634,13 +1128,19 @@ bool ColumnPrivate::copy(const ColumnPrivate * source, int source_start, int des
 int ColumnPrivate::rowCount() const {
 	switch(m_column_mode) {
 	case AbstractColumn::Numeric:
-		return static_cast< QVector<double>* >(m_data)->size();
+		return static_cast< ChunkedVector<double>* >(m_data)->size();
+	case AbstractColumn::Integer:
+		return static_cast< ChunkedVector<int>* >(m_data)->size();
+	case AbstractColumn::BigInt:
+		return static_cast< ChunkedVector<qint64>* >(m_data)->size();
+	case AbstractColumn::Float:
+		return static_cast< ChunkedVector<float>* >(m_data)->size();
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
 	case AbstractColumn::Day:
-		return static_cast< QList<QDateTime>* >(m_data)->size();
+		return static_cast< ChunkedVector<qint64>* >(m_data)->size();
 	case AbstractColumn::Text:
-		return static_cast< QStringList* >(m_data)->size();
+		return static_cast< TextDictionary* >(m_data)->size();
 	}
 
 	return 0;
@@ -661,33 +1161,25 @@ void ColumnPrivate::resizeTo(int new_size) {
 	if (new_size == old_size) return;
 
 	switch(m_column_mode) {
-	case AbstractColumn::Numeric: {
-			QVector<double> *numeric_data = static_cast< QVector<double>* >(m_data);
-			numeric_data->insert(numeric_data->end(), new_size-old_size, NAN);
-			break;
-		}
+	case AbstractColumn::Numeric:
+		static_cast< ChunkedVector<double>* >(m_data)->resize(new_size, NAN);
+		break;
+	case AbstractColumn::Integer:
+		static_cast< ChunkedVector<int>* >(m_data)->resize(new_size, missingInt());
+		break;
+	case AbstractColumn::BigInt:
+		static_cast< ChunkedVector<qint64>* >(m_data)->resize(new_size, missingBigInt());
+		break;
+	case AbstractColumn::Float:
+		static_cast< ChunkedVector<float>* >(m_data)->resize(new_size, NAN);
+		break;
 	case AbstractColumn::DateTime:
 	case AbstractColumn::Month:
-	case AbstractColumn::Day: {
-			int new_rows = new_size - old_size;
-			if (new_rows > 0) {
-				for(int i=0; i<new_rows; i++)
-					static_cast< QList<QDateTime>* >(m_data)->append(QDateTime());
-			} else {
-				for(int i=0; i<-new_rows; i++)
-					static_cast< QList<QDateTime>* >(m_data)->removeLast();
-			}
-			break;
-		}
+	case AbstractColumn::Day:
+		static_cast< ChunkedVector<qint64>* >(m_data)->resize(new_size, invalidDateTime());
+		break;
 	case AbstractColumn::Text: {
-			int new_rows = new_size - old_size;
-			if (new_rows > 0) {
-				for(int i=0; i<new_rows; i++)
-					static_cast< QStringList* >(m_data)->append(QString());
-			} else {
-				for(int i=0; i<-new_rows; i++)
-					static_cast< QStringList* >(m_data)->removeLast();
-			}
+			static_cast< TextDictionary* >(m_data)->resize(new_size);
 			break;
 		}
 	}
@@ -695,26 +1187,37 @@ void ColumnPrivate::resizeTo(int new_size) {
 
 /**
  * \brief Insert some empty (or initialized with zero) rows
+ *
+ * Only the values of the affected chunks are moved, the effort is O(chunk) and not O(rowCount()).
  */
 void ColumnPrivate::insertRows(int before, int count) {
 	if (count == 0) return;
 
 	m_formulas.insertRows(before, count);
+	//the rows don't correspond to the random values generated with the seed anymore
+	setRandomSeed(QString(), 0);
 
 	if (before <= rowCount()) {
 		switch(m_column_mode) {
 		case AbstractColumn::Numeric:
-			static_cast< QVector<double>* >(m_data)->insert(before, count, NAN);
+			static_cast< ChunkedVector<double>* >(m_data)->insert(before, count, NAN);
+			break;
+		case AbstractColumn::Integer:
+			static_cast< ChunkedVector<int>* >(m_data)->insert(before, count, missingInt());
+			break;
+		case AbstractColumn::BigInt:
+			static_cast< ChunkedVector<qint64>* >(m_data)->insert(before, count, missingBigInt());
+			break;
+		case AbstractColumn::Float:
+			static_cast< ChunkedVector<float>* >(m_data)->insert(before, count, NAN);
 			break;
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
-			for(int i=0; i<count; i++)
-				static_cast< QList<QDateTime>* >(m_data)->insert(before, QDateTime());
+			static_cast< ChunkedVector<qint64>* >(m_data)->insert(before, count, invalidDateTime());
 			break;
 		case AbstractColumn::Text:
-			for(int i=0; i<count; i++)
-				static_cast< QStringList* >(m_data)->insert(before, QString());
+			static_cast< TextDictionary* >(m_data)->insert(before, count);
 			break;
 		}
 	}
@@ -722,11 +1225,15 @@ void ColumnPrivate::insertRows(int before, int count) {
 
 /**
  * \brief Remove 'count' rows starting from row 'first'
+ *
+ * Only the values of the affected chunks are moved, the effort is O(chunk) and not O(rowCount()).
  */
 void ColumnPrivate::removeRows(int first, int count) {
 	if (count == 0) return;
 
 	m_formulas.removeRows(first, count);
+	//the rows don't correspond to the random values generated with the seed anymore
+	setRandomSeed(QString(), 0);
 
 	if (first < rowCount()) {
 		int corrected_count = count;
@@ -735,20 +1242,232 @@ void ColumnPrivate::removeRows(int first, int count) {
 
 		switch(m_column_mode) {
 		case AbstractColumn::Numeric:
-			static_cast< QVector<double>* >(m_data)->remove(first, corrected_count);
+			static_cast< ChunkedVector<double>* >(m_data)->remove(first, corrected_count);
+			break;
+		case AbstractColumn::Integer:
+			static_cast< ChunkedVector<int>* >(m_data)->remove(first, corrected_count);
+			break;
+		case AbstractColumn::BigInt:
+			static_cast< ChunkedVector<qint64>* >(m_data)->remove(first, corrected_count);
+			break;
+		case AbstractColumn::Float:
+			static_cast< ChunkedVector<float>* >(m_data)->remove(first, corrected_count);
 			break;
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
-			for(int i=0; i<corrected_count; i++)
-				static_cast< QList<QDateTime>* >(m_data)->removeAt(first);
+			static_cast< ChunkedVector<qint64>* >(m_data)->remove(first, corrected_count);
 			break;
 		case AbstractColumn::Text:
-			for(int i=0; i<corrected_count; i++)
-				static_cast< QStringList* >(m_data)->removeAt(first);
+			static_cast< TextDictionary* >(m_data)->remove(first, corrected_count);
+			break;
+		}
+	}
+}
+
+/**
+ * \brief Return an integer sort key for every row
+ *
+ * Comparing the keys of two rows gives the same result as comparing their values,
+ * the keys are the ranks of the values among the distinct values of the column.
+ * The values are compared in their storage type, text columns use the sort keys of the dictionary.
+ * Rows with NAN or an invalid date get the key -1.
+ */
+QVector<int> ColumnPrivate::sortKeys() const {
+	const int rows = rowCount();
+
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::Float: {
+			QVector<double> values(rows);
+			valuesAsDouble(0, rows, values.data());
+			QVector< QPair<double, int> > keys;
+			keys.reserve(rows);
+			for (int i = 0; i < rows; ++i) {
+				if (!std::isnan(values.at(i)))
+					keys << qMakePair(values.at(i), i);
+			}
+			return denseRanks(keys, rows);
+		}
+	case AbstractColumn::BigInt: {
+			QVector<qint64> values(rows);
+			static_cast< ChunkedVector<qint64>* >(m_data)->read(0, rows, values.data());
+			QVector< QPair<qint64, int> > keys;
+			keys.reserve(rows);
+			for (int i = 0; i < rows; ++i) {
+				if (values.at(i) != missingBigInt())
+					keys << qMakePair(values.at(i), i);
+			}
+			return denseRanks(keys, rows);
+		}
+	case AbstractColumn::Text:
+		// the dictionary ranks its distinct strings, no need to compare the rows
+		return static_cast< TextDictionary* >(m_data)->sortKeys();
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day: {
+			QVector<qint64> values(rows);
+			static_cast< ChunkedVector<qint64>* >(m_data)->read(0, rows, values.data());
+			QVector< QPair<qint64, int> > keys;
+			keys.reserve(rows);
+			for (int i = 0; i < rows; ++i) {
+				if (values.at(i) != invalidDateTime())
+					keys << qMakePair(values.at(i), i);
+			}
+			return denseRanks(keys, rows);
+		}
+	}
+
+	return QVector<int>();
+}
+
+/**
+ * \brief Return the order of the rows when sorting the column
+ *
+ * Element \c i of the returned vector is the row that is put at position \c i.
+ * Rows with NAN or an invalid date are put at the end, rows with equal values keep their order.
+ * Since the sort keys are small integers the rows are ordered with a counting sort.
+ */
+QVector<int> ColumnPrivate::sortPermutation(bool ascending) const {
+	const QVector<int> keys = sortKeys();
+	const int rows = keys.size();
+	int maxKey = -1;
+	for (int i = 0; i < rows; ++i)
+		maxKey = qMax(maxKey, keys.at(i));
+
+	// positions[k] is the first position of the rows with key k, the invalid rows use the last entry
+	QVector<int> positions(maxKey + 2, 0);
+	for (int i = 0; i < rows; ++i) {
+		const int key = keys.at(i);
+		if (key == -1)
+			continue;
+		++positions[ascending ? key : maxKey - key];
+	}
+	int position = 0;
+	for (int k = 0; k < positions.size(); ++k) {
+		const int count = positions.at(k);
+		positions[k] = position;
+		position += count;
+	}
+
+	QVector<int> permutation(rows);
+	for (int i = 0; i < rows; ++i) {
+		const int key = keys.at(i);
+		const int k = (key == -1) ? maxKey + 1 : (ascending ? key : maxKey - key);
+		permutation[positions[k]++] = i;
+	}
+	return permutation;
+}
+
+/**
+ * \brief Reorder the rows, row \c i gets the value and the mask of row \c permutation[i]
+ *
+ * The rows from permutation.size() on are not changed.
+ * All rows referenced in \c permutation have to exist.
+ */
+void ColumnPrivate::permuteRows(const QVector<int>& permutation) {
+	m_owner->emitDataAboutToChange();
+
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		permuteChunks<double>(m_data, permutation);
+		break;
+	case AbstractColumn::Integer:
+		permuteChunks<int>(m_data, permutation);
+		break;
+	case AbstractColumn::BigInt:
+		permuteChunks<qint64>(m_data, permutation);
+		break;
+	case AbstractColumn::Float:
+		permuteChunks<float>(m_data, permutation);
+		break;
+	case AbstractColumn::Text:
+		static_cast< TextDictionary* >(m_data)->permute(permutation);
+		break;
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		permuteChunks<qint64>(m_data, permutation);
+		break;
+	}
+
+	m_owner->permuteMasks(permutation);
+
+	m_owner->emitDataChanged();
+}
+
+/**
+ * \brief Start reordering a copy of the rows in \c pool, see permuteRows()
+ *
+ * The copy is extended by empty rows to the size of \c permutation. It is
+ * passed to setPermutedRows() once the tasks in \c pool are done. The column
+ * itself is not changed and no signals are emitted, the columns of a spreadsheet
+ * are permuted in parallel this way.
+ */
+void* ColumnPrivate::startPermutedRows(const QVector<int>& permutation, QThreadPool* pool) const {
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		return startPermutedCopy<double>(m_data, permutation, NAN, pool);
+	case AbstractColumn::Integer:
+		return startPermutedCopy<int>(m_data, permutation, missingInt(), pool);
+	case AbstractColumn::BigInt:
+		return startPermutedCopy<qint64>(m_data, permutation, missingBigInt(), pool);
+	case AbstractColumn::Float:
+		return startPermutedCopy<float>(m_data, permutation, NAN, pool);
+	case AbstractColumn::Text: {
+			TextDictionary* dictionary = new TextDictionary(*static_cast< TextDictionary* >(m_data));
+			if (dictionary->size() < permutation.size())
+				dictionary->resize(permutation.size());
+			pool->start(new PermuteTextTask(dictionary, permutation));
+			return dictionary;
+		}
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		return startPermutedCopy<qint64>(m_data, permutation, invalidDateTime(), pool);
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Take over the rows reordered by startPermutedRows() and delete \c data
+ *
+ * The masks are reordered by \c permutation and the usual signals are emitted.
+ */
+void ColumnPrivate::setPermutedRows(void* data, const QVector<int>& permutation) {
+	m_owner->emitDataAboutToChange();
+
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		takePermutedCopy<double>(m_data, data);
+		break;
+	case AbstractColumn::Integer:
+		takePermutedCopy<int>(m_data, data);
+		break;
+	case AbstractColumn::BigInt:
+		takePermutedCopy<qint64>(m_data, data);
+		break;
+	case AbstractColumn::Float:
+		takePermutedCopy<float>(m_data, data);
+		break;
+	case AbstractColumn::Text: {
+			TextDictionary* dictionary = static_cast< TextDictionary* >(data);
+			*static_cast< TextDictionary* >(m_data) = *dictionary;
+			delete dictionary;
 			break;
 		}
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		takePermutedCopy<qint64>(m_data, data);
+		break;
 	}
+
+	m_owner->permuteMasks(permutation);
+
+	m_owner->emitDataChanged();
 }
 
 //! Return the column name
@@ -827,6 +1546,36 @@ void ColumnPrivate::setFormula(const QString& formula, const QStringList& variab
 	m_formula = formula;
 	m_formulaVariableNames = variableNames;
 	m_formulaVariableColumnPathes = variableColumnPathes;
+
+	Project* project = m_owner->project();
+	if (project)
+		project->invalidateFormulaDependencies();
+}
+
+/**
+ * \brief Return the name of the GSL generator the random values of the column were generated with
+ *
+ * Empty if the values were not generated by RandomValuesDialog.
+ */
+QString ColumnPrivate::randomGenerator() const {
+	return m_randomGenerator;
+}
+
+/**
+ * \brief Return the seed the random values of the column were generated with
+ */
+quint64 ColumnPrivate::randomSeed() const {
+	return m_randomSeed;
+}
+
+/**
+ * \brief Set the generator and the seed the random values were generated with, an empty generator drops them
+ *
+ * Column::emitDataAboutToChange() drops them on every change of the values.
+ */
+void ColumnPrivate::setRandomSeed(const QString& generator, quint64 seed) {
+	m_randomGenerator = generator;
+	m_randomSeed = seed;
 }
 
 /**
@@ -898,7 +1647,7 @@ void ColumnPrivate::clearFormulas() {
  */
 QString ColumnPrivate::textAt(int row) const {
 	if (m_column_mode != AbstractColumn::Text) return QString();
-	return static_cast< QStringList* >(m_data)->value(row);
+	return static_cast< TextDictionary* >(m_data)->value(row);
 }
 
 /**
@@ -929,15 +1678,205 @@ QDateTime ColumnPrivate::dateTimeAt(int row) const {
 	        m_column_mode != AbstractColumn::Month &&
 	        m_column_mode != AbstractColumn::Day)
 		return QDateTime();
-	return static_cast< QList<QDateTime>* >(m_data)->value(row);
+	return fromMSecs(static_cast< ChunkedVector<qint64>* >(m_data)->value(row, invalidDateTime()));
 }
 
 /**
  * \brief Return the double value in row 'row'
  */
 double ColumnPrivate::valueAt(int row) const {
-	if (m_column_mode != AbstractColumn::Numeric) return NAN;
-	return static_cast< QVector<double>* >(m_data)->value(row, NAN);
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		return static_cast< ChunkedVector<double>* >(m_data)->value(row, NAN);
+	case AbstractColumn::Integer: {
+			const ChunkedVector<int>* vec = static_cast< ChunkedVector<int>* >(m_data);
+			if (row < 0 || row >= vec->size() || vec->at(row) == missingInt())
+				return NAN;
+			return vec->at(row);
+		}
+	case AbstractColumn::BigInt: {
+			const ChunkedVector<qint64>* vec = static_cast< ChunkedVector<qint64>* >(m_data);
+			if (row < 0 || row >= vec->size() || vec->at(row) == missingBigInt())
+				return NAN;
+			return vec->at(row);
+		}
+	case AbstractColumn::Float: {
+			const ChunkedVector<float>* vec = static_cast< ChunkedVector<float>* >(m_data);
+			return (row >= 0 && row < vec->size()) ? vec->at(row) : NAN;
+		}
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	return NAN;
+}
+
+/**
+ * \brief Convert \c count values starting at row \c first to double and write them to \c dest
+ *
+ * The conversion loop is specialized for the storage type of the column.
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
+ */
+void ColumnPrivate::valuesAsDouble(int first, int count, double* dest) const {
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		static_cast< ChunkedVector<double>* >(m_data)->read(first, count, dest);
+		break;
+	case AbstractColumn::Integer:
+		integersAsDouble(static_cast< ChunkedVector<int>* >(m_data), first, count, dest);
+		break;
+	case AbstractColumn::BigInt:
+		integersAsDouble(static_cast< ChunkedVector<qint64>* >(m_data), first, count, dest);
+		break;
+	case AbstractColumn::Float:
+		static_cast< ChunkedVector<float>* >(m_data)->read(first, count, dest);
+		break;
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+}
+
+/**
+ * \brief Convert \c count date and time values starting at row \c first to Julian days
+ *
+ * Same conversion as in DateTime2DoubleFilter, i.e. the integer part is the
+ * Julian day of the date and the fractional part the time of the day,
+ * but done directly on the stored milliseconds without creating QDateTime objects.
+ * Invalid values are converted to NAN.
+ * Use this only when columnMode() is DateTime, Month or Day
+ */
+void ColumnPrivate::julianDays(int first, int count, double* dest) const {
+	if (m_column_mode != AbstractColumn::DateTime &&
+	        m_column_mode != AbstractColumn::Month &&
+	        m_column_mode != AbstractColumn::Day)
+		return;
+	if (count <= 0)
+		return;
+
+	const ChunkedVector<qint64>* values = static_cast< ChunkedVector<qint64>* >(m_data);
+	const qint64 invalid = invalidDateTime();
+	const double msecsPerDay = 86400000.;
+	const double epochJulianDay = 2440587.5; // 1970-01-01T00:00
+
+	// local time: the offset to UTC only changes at daylight-saving transitions.
+	// determine it together with the interval it is valid for and only redo this
+	// when a value outside of this interval is found.
+	const bool isUtc = (m_timeSpec == Qt::UTC);
+	const QTimeZone zone = QTimeZone::systemTimeZone();
+	const bool hasTransitions = !isUtc && zone.hasTransitions();
+	qint64 validFrom = 1;
+	qint64 validTo = 0;
+	qint64 offset = 0;
+
+	// the values of one chunk are contiguous
+	for (int chunk = values->chunkIndex(first); count > 0; ++chunk) {
+		const int start = first - values->chunkStart(chunk);
+		const int n = qMin(count, values->chunkSize(chunk) - start);
+		const qint64* msecs = values->chunkData(chunk) + start;
+
+		if (isUtc) {
+			for (int i = 0; i < n; ++i)
+				dest[i] = (msecs[i] == invalid) ? NAN : msecs[i]/msecsPerDay + epochJulianDay;
+		} else {
+			for (int i = 0; i < n; ++i) {
+				const qint64 value = msecs[i];
+				if (value == invalid) {
+					dest[i] = NAN;
+					continue;
+				}
+
+				if (value < validFrom || value >= validTo) {
+					const QDateTime utc = QDateTime::fromMSecsSinceEpoch(value, Qt::UTC);
+					offset = 1000LL * zone.offsetFromUtc(utc);
+					if (hasTransitions) {
+						const QTimeZone::OffsetData prev = zone.previousTransition(utc.addMSecs(1));
+						const QTimeZone::OffsetData next = zone.nextTransition(utc);
+						validFrom = prev.atUtc.isValid() ? prev.atUtc.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+						validTo = next.atUtc.isValid() ? next.atUtc.toMSecsSinceEpoch() : std::numeric_limits<qint64>::max();
+					} else {
+						// no transition data available, assume the offset to be constant for one hour
+						const qint64 msecsPerHour = 3600000;
+						validFrom = value - ((value % msecsPerHour) + msecsPerHour) % msecsPerHour;
+						validTo = validFrom + msecsPerHour;
+					}
+				}
+
+				dest[i] = (value + offset)/msecsPerDay + epochJulianDay;
+			}
+		}
+
+		dest += n;
+		first += n;
+		count -= n;
+	}
+}
+
+/**
+ * \brief Return the time spec used to convert the stored values to QDateTime
+ */
+Qt::TimeSpec ColumnPrivate::timeSpec() const {
+	return m_timeSpec;
+}
+
+/**
+ * \brief Set the time spec used to convert the stored values to QDateTime
+ *
+ * The stored points in time are not changed, only their representation.
+ */
+void ColumnPrivate::setTimeSpec(Qt::TimeSpec spec) {
+	m_owner->emitDataAboutToChange();
+	m_timeSpec = spec;
+	m_owner->emitDataChanged();
+}
+
+/**
+ * \brief Convert a QDateTime to the stored representation
+ */
+qint64 ColumnPrivate::toMSecs(const QDateTime& dateTime) {
+	return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : invalidDateTime();
+}
+
+/**
+ * \brief Convert a QDateTime passed to the setters to the stored representation
+ *
+ * Values in local time (the time spec of parsed strings and of QDateTime without an explicit spec)
+ * are taken as wall-clock times in the time spec of the column, values in UTC or with an offset
+ * keep their point in time.
+ */
+qint64 ColumnPrivate::wallClockToMSecs(const QDateTime& dateTime) const {
+	if (dateTime.timeSpec() != Qt::LocalTime || m_timeSpec == Qt::LocalTime)
+		return toMSecs(dateTime);
+
+	QDateTime wallClock(dateTime);
+	wallClock.setTimeSpec(m_timeSpec);
+	return toMSecs(wallClock);
+}
+
+/**
+ * \brief Convert a stored value to QDateTime using the time spec of the column
+ */
+QDateTime ColumnPrivate::fromMSecs(qint64 msecs) const {
+	if (msecs == invalidDateTime())
+		return QDateTime();
+	return QDateTime::fromMSecsSinceEpoch(msecs, m_timeSpec);
+}
+
+/**
+ * \brief Convert a vector of stored date and time values to a list of QDateTime
+ */
+QList<QDateTime> ColumnPrivate::dateTimeList(void* data) const {
+	const ChunkedVector<qint64>* msecs = static_cast< ChunkedVector<qint64>* >(data);
+	QList<QDateTime> list;
+	list.reserve(msecs->size());
+	for (int i = 0; i < msecs->size(); ++i)
+		list << fromMSecs(msecs->at(i));
+	return list;
 }
 
 /**
@@ -948,13 +1887,12 @@ double ColumnPrivate::valueAt(int row) const {
 void ColumnPrivate::setTextAt(int row, const QString& new_value) {
 	if (m_column_mode != AbstractColumn::Text) return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	m_owner->emitDataAboutToChange();
 	if (row >= rowCount())
 		resizeTo(row+1);
 
-	static_cast< QStringList* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	static_cast< TextDictionary* >(m_data)->replace(row, new_value);
+	m_owner->emitDataChanged(row, row);
 }
 
 /**
@@ -965,16 +1903,15 @@ void ColumnPrivate::setTextAt(int row, const QString& new_value) {
 void ColumnPrivate::replaceTexts(int first, const QStringList& new_values) {
 	if (m_column_mode != AbstractColumn::Text) return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	m_owner->emitDataAboutToChange();
 	int num_rows = new_values.size();
 	if (first + num_rows > rowCount())
 		resizeTo(first + num_rows);
 
 	for(int i=0; i<num_rows; i++)
-		static_cast< QStringList* >(m_data)->replace(first+i, new_values.at(i));
+		static_cast< TextDictionary* >(m_data)->replace(first+i, new_values.at(i));
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(first, first + num_rows - 1);
 }
 
 /**
@@ -1016,13 +1953,12 @@ void ColumnPrivate::setDateTimeAt(int row, const QDateTime& new_value) {
 	        m_column_mode != AbstractColumn::Day)
 		return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	m_owner->emitDataAboutToChange();
 	if (row >= rowCount())
 		resizeTo(row+1);
 
-	static_cast< QList<QDateTime>* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	static_cast< ChunkedVector<qint64>* >(m_data)->replace(row, wallClockToMSecs(new_value));
+	m_owner->emitDataChanged(row, row);
 }
 
 /**
@@ -1036,54 +1972,110 @@ void ColumnPrivate::replaceDateTimes(int first, const QList<QDateTime>& new_valu
 	        m_column_mode != AbstractColumn::Day)
 		return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	m_owner->emitDataAboutToChange();
 	int num_rows = new_values.size();
 	if (first + num_rows > rowCount())
 		resizeTo(first + num_rows);
 
+	ChunkedVector<qint64>* vec = static_cast< ChunkedVector<qint64>* >(m_data);
 	for(int i=0; i<num_rows; i++)
-		static_cast< QList<QDateTime>* >(m_data)->replace(first+i, new_values.at(i));
+		vec->replace(first+i, wallClockToMSecs(new_values.at(i)));
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataChanged(first, first + num_rows - 1);
 }
 
 /**
  * \brief Set the content of row 'row'
  *
- * Use this only when columnMode() is Numeric
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float.
+ * For the integer modes the value is rounded, NAN and values that can't be represented are stored as missing values.
  */
 void ColumnPrivate::setValueAt(int row, double new_value) {
-	if (m_column_mode != AbstractColumn::Numeric) return;
+	if (!AbstractColumn::isNumeric(m_column_mode)) return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	m_owner->emitDataAboutToChange();
 	if (row >= rowCount())
 		resizeTo(row+1);
 
-	static_cast< QVector<double>* >(m_data)->replace(row, new_value);
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		static_cast< ChunkedVector<double>* >(m_data)->replace(row, new_value);
+		break;
+	case AbstractColumn::Integer:
+		static_cast< ChunkedVector<int>* >(m_data)->replace(row, toInt(new_value));
+		break;
+	case AbstractColumn::BigInt:
+		static_cast< ChunkedVector<qint64>* >(m_data)->replace(row, toBigInt(new_value));
+		break;
+	case AbstractColumn::Float:
+		static_cast< ChunkedVector<float>* >(m_data)->replace(row, new_value);
+		break;
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	m_owner->emitDataChanged(row, row);
 }
 
 /**
  * \brief Replace a range of values
  *
- * Use this only when columnMode() is Numeric
+ * Use this only when columnMode() is Numeric, Integer, BigInt or Float
  */
 void ColumnPrivate::replaceValues(int first, const QVector<double>& new_values) {
-	if (m_column_mode != AbstractColumn::Numeric) return;
+	if (!AbstractColumn::isNumeric(m_column_mode)) return;
 
-	emit m_owner->dataAboutToChange(m_owner);
+	m_owner->emitDataAboutToChange();
 	int num_rows = new_values.size();
 	if (first + num_rows > rowCount())
 		resizeTo(first + num_rows);
 
-	double * ptr = static_cast< QVector<double>* >(m_data)->data();
-	for(int i=0; i<num_rows; i++)
-		ptr[first+i] = new_values.at(i);
+	switch(m_column_mode) {
+	case AbstractColumn::Numeric:
+		static_cast< ChunkedVector<double>* >(m_data)->write(first, num_rows, new_values.constData());
+		break;
+	case AbstractColumn::Integer: {
+			ChunkedVector<int>* vec = static_cast< ChunkedVector<int>* >(m_data);
+			for(int i=0; i<num_rows; i++)
+				vec->replace(first+i, toInt(new_values.at(i)));
+			break;
+		}
+	case AbstractColumn::BigInt: {
+			ChunkedVector<qint64>* vec = static_cast< ChunkedVector<qint64>* >(m_data);
+			for(int i=0; i<num_rows; i++)
+				vec->replace(first+i, toBigInt(new_values.at(i)));
+			break;
+		}
+	case AbstractColumn::Float: {
+			ChunkedVector<float>* vec = static_cast< ChunkedVector<float>* >(m_data);
+			for(int i=0; i<num_rows; i++)
+				vec->replace(first+i, new_values.at(i));
+			break;
+		}
+	case AbstractColumn::Text:
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day:
+		break;
+	}
+
+	m_owner->emitDataChanged(first, first + num_rows - 1);
+}
+
+/**
+ * \brief Replace all values, the chunks are shared with \c values and not copied
+ *
+ * Use this only when columnMode() is Numeric
+ */
+void ColumnPrivate::replaceValues(const ChunkedVector<double>& values) {
+	if (m_column_mode != AbstractColumn::Numeric) return;
 
-	if (!m_owner->m_suppressDataChangedSignal)
-		emit m_owner->dataChanged(m_owner);
+	m_owner->emitDataAboutToChange();
+	*static_cast< ChunkedVector<double>* >(m_data) = values;
+	m_owner->emitDataChanged();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -33,7 +33,11 @@
 #include "backend/lib/IntervalAttribute.h"
 #include "backend/core/column/Column.h"
 
+#include <limits>
+
 class AbstractSimpleFilter;
+class QThreadPool;
+template<class T> class ChunkedVector;
 
 class ColumnPrivate: QObject {
 	Q_OBJECT
@@ -54,6 +58,11 @@ class ColumnPrivate: QObject {
 		void resizeTo(int new_size);
 		void insertRows(int before, int count);
 		void removeRows(int first, int count);
+		QVector<int> sortKeys() const;
+		QVector<int> sortPermutation(bool ascending) const;
+		void permuteRows(const QVector<int>& permutation);
+		void* startPermutedRows(const QVector<int>& permutation, QThreadPool* pool) const;
+		void setPermutedRows(void* data, const QVector<int>& permutation);
 		QString name() const;
 		AbstractColumn::PlotDesignation plotDesignation() const;
 		void setPlotDesignation(AbstractColumn::PlotDesignation);
@@ -79,6 +88,10 @@ class ColumnPrivate: QObject {
 		void setFormula(int row, QString formula);
 		void clearFormulas();
 
+		QString randomGenerator() const;
+		quint64 randomSeed() const;
+		void setRandomSeed(const QString& generator, quint64 seed);
+
 		QString textAt(int row) const;
 		void setTextAt(int row, const QString& new_value);
 		void replaceTexts(int first, const QStringList& new_values);
@@ -92,19 +105,40 @@ class ColumnPrivate: QObject {
 		double valueAt(int row) const;
 		void setValueAt(int row, double new_value);
 		void replaceValues(int first, const QVector<double>& new_values);
+		void replaceValues(const ChunkedVector<double>& values);
+		void valuesAsDouble(int first, int count, double* dest) const;
+		void julianDays(int first, int count, double* dest) const;
+		Qt::TimeSpec timeSpec() const;
+		void setTimeSpec(Qt::TimeSpec);
+
+		//! marks an invalid value in the storage of date and time columns
+		static qint64 invalidDateTime() { return std::numeric_limits<qint64>::min(); }
+		//! marks a missing value (NAN) in the storage of Integer and BigInt columns
+		static int missingInt() { return std::numeric_limits<int>::min(); }
+		static qint64 missingBigInt() { return std::numeric_limits<qint64>::min(); }
+		static qint64 toMSecs(const QDateTime&);
+		qint64 wallClockToMSecs(const QDateTime&) const;
 
 		Column::ColumnStatistics statistics;
 		bool statisticsAvailable;
 
 	private:
+		bool isCompatible(AbstractColumn::ColumnMode) const;
+		QVector<double> doubleVector(void* data) const;
+		QDateTime fromMSecs(qint64) const;
+		QList<QDateTime> dateTimeList(void* data) const;
+
 		AbstractColumn::ColumnMode m_column_mode;
 		void* m_data;
+		Qt::TimeSpec m_timeSpec;
 		AbstractSimpleFilter* m_input_filter;
 		AbstractSimpleFilter* m_output_filter;
 		QString m_formula;
 		QStringList m_formulaVariableNames;
 		QStringList m_formulaVariableColumnPathes;
 		IntervalAttribute<QString> m_formulas;
+		QString m_randomGenerator;
+		quint64 m_randomSeed;
 		AbstractColumn::PlotDesignation m_plot_designation;
 		int m_width;
 		Column* m_owner;
@@ -0,0 +1,379 @@
+/***************************************************************************
+    File                 : FormulaDependencyGraph.cpp
+    Project              : LabPlot
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+    Description          : dependencies between the formula columns of a project
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "FormulaDependencyGraph.h"
+#include "backend/core/column/Column.h"
+#include "backend/gsl/ExpressionParser.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <cmath>
+
+namespace {
+//number of rows from which on the formula columns are recalculated in the background
+const int BackgroundRecalculationSize = 100000;
+
+//merges two row ranges, -1 stands for the last row of the column
+QPair<int, int> unite(const QPair<int, int>& a, const QPair<int, int>& b) {
+	const int last = (a.second == -1 || b.second == -1) ? -1 : qMax(a.second, b.second);
+	return qMakePair(qMin(a.first, b.first), last);
+}
+}
+
+/*!
+	\class FormulaDependencyGraph
+	\brief Dependency graph of the columns with a global formula (see Column::setFormula()) in a project.
+
+	A formula column depends on the columns bound to the variables of its formula,
+	the columns are found by their pathes and can belong to other spreadsheets.
+	When the data of a column changes, the changed rows of all formula columns depending
+	on it directly or indirectly are recalculated in topological order, every formula column at most once.
+	Since the formulas are evaluated row-wise, only the rows changed in the variable columns are evaluated again.
+	Columns with a cyclic dependency are not recalculated.
+
+	The graph is built lazily on the first change after it was invalidated by renaming an aspect or by changing a formula.
+	Before a recalculation the pathes of the columns in the graph are compared with the ones it was built with,
+	this way moved and removed columns are noticed without rebuilding the graph for every added or removed aspect.
+
+	Large recalculations run in the background: the values of the involved columns are taken when the recalculation
+	is started (the values of double columns are implicitly shared and not copied), the formulas are evaluated
+	in another thread and the new values are set in the GUI thread when the evaluation has finished.
+	The columns changed in the meantime are recalculated afterwards.
+
+	\ingroup backend
+*/
+
+FormulaDependencyGraph::FormulaDependencyGraph(const AbstractAspect* root)
+	: m_root(root), m_valid(false), m_unresolved(false), m_recalculating(false), m_applying(false) {
+	connect(&m_watcher, SIGNAL(finished()), this, SLOT(recalculationFinished()));
+}
+
+FormulaDependencyGraph::~FormulaDependencyGraph() {
+	m_watcher.waitForFinished();
+}
+
+/*!
+	marks the graph as outdated, it is rebuilt on the next recalculation.
+*/
+void FormulaDependencyGraph::invalidate() {
+	m_valid = false;
+}
+
+/*!
+	records that the rows \c first to \c last (-1 for the last row) of \c column were changed.
+	The dependent columns are updated in recalculate().
+*/
+void FormulaDependencyGraph::addChange(const AbstractColumn* column, int first, int last) {
+	// the values set by a recalculation already took the dependent columns into account
+	if (m_applying)
+		return;
+
+	// without formulas depending on the column there is nothing to do
+	if (m_valid && !m_dependents.contains(column))
+		return;
+
+	const RowRange range(qMax(first, 0), last);
+	QHash<const AbstractColumn*, RowRange>::iterator it = m_changes.find(column);
+	if (it == m_changes.end())
+		m_changes.insert(column, range);
+	else
+		it.value() = unite(it.value(), range);
+}
+
+/*!
+	recalculates the formula columns depending on the changed columns.
+	The formulas are evaluated in several threads, see ExpressionParser::evaluateVectors(),
+	more than BackgroundRecalculationSize rows are evaluated in the background.
+	The new values are not put on the undo stack, undoing the change of a variable column
+	recalculates the dependent columns again. The undo commands replacing values of formula
+	columns store the absolute values for this reason, see ColumnReplaceValuesCmd.
+*/
+void FormulaDependencyGraph::recalculate() {
+	// the changes made during a running recalculation are recalculated when it has finished
+	if (m_recalculating || m_applying || m_changes.isEmpty())
+		return;
+
+	if (!m_valid || !isUpToDate())
+		rebuild();
+
+	ExpressionParser::getInstance();	//initializes the symbol table of the parser in the GUI thread
+
+	QVector<RowRange> pending(m_columns.size(), RowRange(-1, -1));
+	takeChanges(pending);
+
+	// the changes of a formula column only affect columns later in the topological order
+	Recalculation recalculation;
+	QHash<const Column*, int> indices;
+	m_recalculatedColumns.clear();
+	int rows = 0;
+	for (int i = 0; i < m_columns.size(); ++i) {
+		if (pending.at(i).first == -1)
+			continue;
+
+		Column* column = m_columns.at(i);
+		if (!AbstractColumn::isNumeric(column->columnMode()))
+			continue;
+
+		const int rowCount = column->rowCount();
+		const int first = pending.at(i).first;
+		const int last = (pending.at(i).second == -1 || pending.at(i).second >= rowCount) ? rowCount - 1 : pending.at(i).second;
+		if (first > last)
+			continue;
+
+		Task task;
+		task.column = takeValues(column, recalculation, indices);
+		m_recalculatedColumns[task.column] = column;
+		task.formula = column->formula();
+		task.variableNames = column->formulaVariableNames();
+		foreach (const Column* input, m_inputs.at(i))
+			task.inputs << takeValues(input, recalculation, indices);
+		task.first = first;
+		task.last = last;
+		task.valid = false;
+		recalculation.tasks << task;
+		rows += last - first + 1;
+
+		const RowRange range(first, last);
+		foreach (int j, m_dependents.value(column))
+			pending[j] = (pending.at(j).first == -1) ? range : unite(pending.at(j), range);
+	}
+
+	if (recalculation.tasks.isEmpty())
+		return;
+
+	if (rows < BackgroundRecalculationSize)
+		apply(evaluate(recalculation));
+	else {
+		m_recalculating = true;
+		m_watcher.setFuture(QtConcurrent::run(&FormulaDependencyGraph::evaluate, recalculation));
+	}
+}
+
+void FormulaDependencyGraph::recalculationFinished() {
+	apply(m_watcher.result());
+	m_recalculating = false;
+	recalculate();
+}
+
+//moves the recorded changes to the ranges of the dependent formula columns
+void FormulaDependencyGraph::takeChanges(QVector<RowRange>& pending) {
+	for (QHash<const AbstractColumn*, RowRange>::const_iterator it = m_changes.constBegin(); it != m_changes.constEnd(); ++it) {
+		foreach (int index, m_dependents.value(it.key())) {
+			if (pending.at(index).first == -1)
+				pending[index] = it.value();
+			else
+				pending[index] = unite(pending.at(index), it.value());
+		}
+	}
+	m_changes.clear();
+}
+
+//adds the values of \c column converted to double to the data of \c recalculation once, returns their index
+int FormulaDependencyGraph::takeValues(const Column* column, Recalculation& recalculation, QHash<const Column*, int>& indices) {
+	const int index = indices.value(column, -1);
+	if (index != -1)
+		return index;
+
+	if (column->columnMode() == AbstractColumn::Numeric)
+		recalculation.data << *static_cast<const ChunkedVector<double>*>(column->data());
+	else {
+		QVector<double> values(column->rowCount());
+		column->valuesAsDouble(0, values.size(), values.data());
+		recalculation.data << ChunkedVector<double>(values);
+	}
+	m_recalculatedColumns << QPointer<Column>();
+	indices.insert(column, recalculation.data.size() - 1);
+	return recalculation.data.size() - 1;
+}
+
+/*!
+	evaluates the formulas of the tasks of \c recalculation in their order, the new values of a
+	formula column are used by the later tasks. Only works on the data of \c recalculation
+	and can be called from a background thread.
+*/
+FormulaDependencyGraph::Recalculation FormulaDependencyGraph::evaluate(Recalculation recalculation) {
+	for (int t = 0; t < recalculation.tasks.size(); ++t) {
+		Task& task = recalculation.tasks[t];
+
+		// rows behind the end of the shortest variable column get NAN like in the "Function values" dialog
+		task.values = QVector<double>(task.last - task.first + 1, NAN);
+		int count = task.values.size();
+		foreach (int input, task.inputs)
+			count = qMin(count, recalculation.data.at(input).size() - task.first);
+
+		QVector< QVector<double> > buffers(task.inputs.size());
+		QVector<const double*> data;
+		for (int n = 0; n < task.inputs.size(); ++n) {
+			if (count > 0) {
+				buffers[n].resize(count);
+				recalculation.data.at(task.inputs.at(n)).read(task.first, count, buffers[n].data());
+			}
+			data << buffers.at(n).constData();
+		}
+
+		task.valid = (count <= 0) || ExpressionParser::getInstance()->evaluateVectors(task.formula, task.variableNames,
+			data, task.values.data(), count);
+		if (task.valid)
+			recalculation.data[task.column].write(task.first, task.values.size(), task.values.constData());
+	}
+
+	return recalculation;
+}
+
+//sets the values calculated by evaluate() in the formula columns that still exist
+void FormulaDependencyGraph::apply(const Recalculation& recalculation) {
+	m_applying = true;
+	foreach (const Task& task, recalculation.tasks) {
+		Column* column = m_recalculatedColumns.value(task.column);
+		if (!task.valid || !column || !AbstractColumn::isNumeric(column->columnMode()))
+			continue;
+
+		// the column might have been shortened in the meantime
+		const int count = qMin(task.values.size(), column->rowCount() - task.first);
+		if (count <= 0)
+			continue;
+
+		const bool undoAware = column->isUndoAware();
+		column->setUndoAware(false);
+		column->replaceValues(task.first, count < task.values.size() ? task.values.mid(0, count) : task.values);
+		column->setUndoAware(undoAware);
+	}
+	m_applying = false;
+}
+
+//compares the pathes of the columns in the graph with the ones it was built with,
+//moving or removing a column or one of its parents changes its path
+bool FormulaDependencyGraph::isUpToDate() const {
+	// a column added since then might provide a missing variable column
+	if (m_unresolved)
+		return false;
+
+	for (QHash<const Column*, QString>::const_iterator it = m_paths.constBegin(); it != m_paths.constEnd(); ++it) {
+		if (it.key()->path() != it.value())
+			return false;
+	}
+	return true;
+}
+
+//collects the formula columns and sorts them topologically
+void FormulaDependencyGraph::rebuild() {
+	m_columns.clear();
+	m_inputs.clear();
+	m_paths.clear();
+	m_dependents.clear();
+	m_unresolved = false;
+
+	const QList<Column*> columns = m_root->children<Column>(AbstractAspect::Recursive | AbstractAspect::IncludeHidden);
+	QHash<QString, const Column*> columnsByPath;
+	foreach (const Column* column, columns)
+		columnsByPath.insert(column->path(), column);
+
+	// formula columns whose variable columns all exist
+	QVector<Column*> formulaColumns;
+	QVector< QVector<const Column*> > inputs;
+	foreach (Column* column, columns) {
+		if (column->formula().isEmpty())
+			continue;
+
+		const QStringList& pathes = column->formulaVariableColumnPathes();
+		if (pathes.size() != column->formulaVariableNames().size())
+			continue;
+
+		QVector<const Column*> variableColumns;
+		foreach (const QString& path, pathes) {
+			const Column* variableColumn = columnsByPath.value(path);
+			if (!variableColumn)
+				break;
+			variableColumns << variableColumn;
+		}
+		if (variableColumns.size() != pathes.size()) {
+			m_unresolved = true;
+			continue;
+		}
+
+		formulaColumns << column;
+		inputs << variableColumns;
+	}
+
+	// Kahn's algorithm, columns on a cycle never get an in-degree of zero and are dropped
+	QHash<const Column*, int> indices;
+	for (int i = 0; i < formulaColumns.size(); ++i)
+		indices.insert(formulaColumns.at(i), i);
+
+	QVector<int> inDegrees(formulaColumns.size(), 0);
+	QVector< QVector<int> > successors(formulaColumns.size());
+	for (int i = 0; i < formulaColumns.size(); ++i) {
+		foreach (const Column* input, inputs.at(i)) {
+			const int j = indices.value(input, -1);
+			if (j != -1) {
+				successors[j] << i;
+				++inDegrees[i];
+			}
+		}
+	}
+
+	QVector<int> order;
+	for (int i = 0; i < formulaColumns.size(); ++i) {
+		if (inDegrees.at(i) == 0)
+			order << i;
+	}
+	for (int k = 0; k < order.size(); ++k) {
+		foreach (int j, successors.at(order.at(k))) {
+			if (--inDegrees[j] == 0)
+				order << j;
+		}
+	}
+
+	foreach (int i, order) {
+		const int index = m_columns.size();
+		m_columns << formulaColumns.at(i);
+		m_inputs << inputs.at(i);
+		m_paths.insert(formulaColumns.at(i), formulaColumns.at(i)->path());
+		foreach (const Column* input, inputs.at(i)) {
+			QVector<int>& dependents = m_dependents[input];
+			if (dependents.isEmpty() || dependents.last() != index)
+				dependents << index;
+			m_paths.insert(input, input->path());
+		}
+	}
+
+	// the graph keeps pointers to the columns, deleting one of them makes it invalid
+	for (QHash<const Column*, QString>::const_iterator it = m_paths.constBegin(); it != m_paths.constEnd(); ++it)
+		connect(it.key(), SIGNAL(destroyed()), this, SLOT(invalidate()), Qt::UniqueConnection);
+
+	// changes of columns without dependents are not needed anymore
+	QHash<const AbstractColumn*, RowRange>::iterator it = m_changes.begin();
+	while (it != m_changes.end()) {
+		if (m_dependents.contains(it.key()))
+			++it;
+		else
+			it = m_changes.erase(it);
+	}
+
+	m_valid = true;
+}
@@ -0,0 +1,107 @@
+/***************************************************************************
+    File                 : FormulaDependencyGraph.h
+    Project              : LabPlot
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+    Description          : dependencies between the formula columns of a project
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef FORMULADEPENDENCYGRAPH_H
+#define FORMULADEPENDENCYGRAPH_H
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QPointer>
+#include <QStringList>
+#include <QVector>
+
+#include "backend/lib/ChunkedVector.h"
+
+class AbstractAspect;
+class AbstractColumn;
+class Column;
+
+//! Dependencies between the formula columns of a project
+class FormulaDependencyGraph : public QObject {
+	Q_OBJECT
+
+	public:
+		explicit FormulaDependencyGraph(const AbstractAspect* root);
+		~FormulaDependencyGraph();
+
+		void addChange(const AbstractColumn*, int first, int last);
+		void recalculate();
+
+	public slots:
+		void invalidate();
+
+	private:
+		Q_DISABLE_COPY(FormulaDependencyGraph)
+
+		typedef QPair<int, int> RowRange;	// first and last row, -1 for the last row of the column
+
+		//! formula column to recalculate, see FormulaDependencyGraph::recalculate()
+		struct Task {
+			int column;	// index of the formula column in Recalculation::data
+			QString formula;
+			QStringList variableNames;
+			QVector<int> inputs;	// indices of the variable columns in Recalculation::data
+			int first;
+			int last;
+			QVector<double> values;	// the new values of the rows first to last
+			bool valid;
+		};
+
+		//! values of the columns a recalculation reads and writes, taken when it is started
+		struct Recalculation {
+			QVector< ChunkedVector<double> > data;
+			QVector<Task> tasks;	// in topological order
+		};
+
+		static Recalculation evaluate(Recalculation);
+		void rebuild();
+		bool isUpToDate() const;
+		void takeChanges(QVector<RowRange>& pending);
+		int takeValues(const Column*, Recalculation&, QHash<const Column*, int>& indices);
+		void apply(const Recalculation&);
+
+		const AbstractAspect* m_root;
+		bool m_valid;
+		bool m_unresolved;	// there are formulas with variable columns not found in the project
+		bool m_recalculating;
+		bool m_applying;
+		QVector<Column*> m_columns;	// formula columns in topological order
+		QVector< QVector<const Column*> > m_inputs;	// the variable columns of m_columns
+		QHash<const Column*, QString> m_paths;	// pathes of the formula and variable columns when the graph was built
+		QHash<const AbstractColumn*, QVector<int> > m_dependents;	// indices of the formula columns using a column
+		QHash<const AbstractColumn*, RowRange> m_changes;
+		QFutureWatcher<Recalculation> m_watcher;
+		QVector< QPointer<Column> > m_recalculatedColumns;	// the formula columns of the running recalculation's data, null for the others
+
+	private slots:
+		void recalculationFinished();
+};
+
+#endif
@@ -29,8 +29,11 @@
 
 #include "columncommands.h"
 #include "ColumnPrivate.h"
+#include "backend/lib/ChunkedVector.h"
+#include "backend/lib/TextDictionary.h"
 #include <KLocale>
 #include <cmath>
+#include <cstring>
 
 /** ***************************************************************************
  * \class ColumnSetModeCmd
@@ -110,30 +113,48 @@ ColumnSetModeCmd::~ColumnSetModeCmd() {
 		if(m_new_data != m_old_data)
 			switch (m_mode) {
 			case AbstractColumn::Numeric:
-				delete static_cast< QVector<double>* >(m_new_data);
+				delete static_cast< ChunkedVector<double>* >(m_new_data);
+				break;
+			case AbstractColumn::Integer:
+				delete static_cast< ChunkedVector<int>* >(m_new_data);
+				break;
+			case AbstractColumn::BigInt:
+				delete static_cast< ChunkedVector<qint64>* >(m_new_data);
+				break;
+			case AbstractColumn::Float:
+				delete static_cast< ChunkedVector<float>* >(m_new_data);
 				break;
 			case AbstractColumn::Text:
-				delete static_cast< QStringList* >(m_new_data);
+				delete static_cast< TextDictionary* >(m_new_data);
 				break;
 			case AbstractColumn::DateTime:
 			case AbstractColumn::Month:
 			case AbstractColumn::Day:
-				delete static_cast< QList<QDateTime>* >(m_new_data);
+				delete static_cast< ChunkedVector<qint64>* >(m_new_data);
 				break;
 			}
 	} else {
 		if(m_new_data != m_old_data)
 			switch (m_old_mode) {
 			case AbstractColumn::Numeric:
-				delete static_cast< QVector<double>* >(m_old_data);
+				delete static_cast< ChunkedVector<double>* >(m_old_data);
+				break;
+			case AbstractColumn::Integer:
+				delete static_cast< ChunkedVector<int>* >(m_old_data);
+				break;
+			case AbstractColumn::BigInt:
+				delete static_cast< ChunkedVector<qint64>* >(m_old_data);
+				break;
+			case AbstractColumn::Float:
+				delete static_cast< ChunkedVector<float>* >(m_old_data);
 				break;
 			case AbstractColumn::Text:
-				delete static_cast< QStringList* >(m_old_data);
+				delete static_cast< TextDictionary* >(m_old_data);
 				break;
 			case AbstractColumn::DateTime:
 			case AbstractColumn::Month:
 			case AbstractColumn::Day:
-				delete static_cast< QList<QDateTime>* >(m_old_data);
+				delete static_cast< ChunkedVector<qint64>* >(m_old_data);
 				break;
 			}
 	}
@@ -513,6 +534,49 @@ void ColumnSetPlotDesignationCmd::undo() {
 	m_col->setPlotDesignation(m_old_pd);
 }
 
+/** ***************************************************************************
+ * \class ColumnSetTimeSpecCmd
+ * \brief Sets the time spec of a date and time column
+ ** ***************************************************************************/
+
+/**
+ * \var ColumnSetTimeSpecCmd::m_col
+ * \brief The private column data to modify
+ */
+
+/**
+ * \var ColumnSetTimeSpecCmd::m_new_spec
+ * \brief New time spec
+ */
+
+/**
+ * \var ColumnSetTimeSpecCmd::m_old_spec
+ * \brief Old time spec
+ */
+
+/**
+ * \brief Ctor
+ */
+ColumnSetTimeSpecCmd::ColumnSetTimeSpecCmd( ColumnPrivate * col, Qt::TimeSpec spec, QUndoCommand * parent )
+	: QUndoCommand( parent ), m_col(col), m_new_spec(spec) {
+	setText(i18n("%1: set time spec", col->name()));
+}
+
+/**
+ * \brief Execute the command
+ */
+void ColumnSetTimeSpecCmd::redo() {
+	m_old_spec = m_col->timeSpec();
+	m_col->setTimeSpec(m_new_spec);
+}
+
+/**
+ * \brief Undo the command
+ */
+void ColumnSetTimeSpecCmd::undo() {
+	m_col->setTimeSpec(m_old_spec);
+}
+
 /** ***************************************************************************
  * \class ColumnClearCmd
  * \brief Clear the column
@@ -557,30 +621,48 @@ ColumnClearCmd::~ColumnClearCmd() {
 		if (!m_empty_data) return;
 		switch(m_col->columnMode()) {
 		case AbstractColumn::Numeric:
-			delete static_cast< QVector<double>* >(m_empty_data);
+			delete static_cast< ChunkedVector<double>* >(m_empty_data);
+			break;
+		case AbstractColumn::Integer:
+			delete static_cast< ChunkedVector<int>* >(m_empty_data);
+			break;
+		case AbstractColumn::BigInt:
+			delete static_cast< ChunkedVector<qint64>* >(m_empty_data);
+			break;
+		case AbstractColumn::Float:
+			delete static_cast< ChunkedVector<float>* >(m_empty_data);
 			break;
 		case AbstractColumn::Text:
-			delete static_cast< QStringList* >(m_empty_data);
+			delete static_cast< TextDictionary* >(m_empty_data);
 			break;
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
-			delete static_cast< QList<QDateTime>* >(m_empty_data);
+			delete static_cast< ChunkedVector<qint64>* >(m_empty_data);
 			break;
 		}
 	} else {
 		if (!m_data) return;
 		switch(m_col->columnMode()) {
 		case AbstractColumn::Numeric:
-			delete static_cast< QVector<double>* >(m_data);
+			delete static_cast< ChunkedVector<double>* >(m_data);
+			break;
+		case AbstractColumn::Integer:
+			delete static_cast< ChunkedVector<int>* >(m_data);
+			break;
+		case AbstractColumn::BigInt:
+			delete static_cast< ChunkedVector<qint64>* >(m_data);
+			break;
+		case AbstractColumn::Float:
+			delete static_cast< ChunkedVector<float>* >(m_data);
 			break;
 		case AbstractColumn::Text:
-			delete static_cast< QStringList* >(m_data);
+			delete static_cast< TextDictionary* >(m_data);
 			break;
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
-			delete static_cast< QList<QDateTime>* >(m_data);
+			delete static_cast< ChunkedVector<qint64>* >(m_data);
 			break;
 		}
 	}
@@ -593,24 +675,26 @@ void ColumnClearCmd::redo() {
 	if(!m_empty_data) {
 		const int rowCount = m_col->rowCount();
 		switch(m_col->columnMode()) {
-		case AbstractColumn::Numeric: {
-				QVector<double>* vec = new QVector<double>(rowCount);
-				m_empty_data = vec;
-				for (int i=0; i<rowCount; i++)
-					vec->operator[](i) = NAN;
-				break;
-			}
+		case AbstractColumn::Numeric:
+			m_empty_data = new ChunkedVector<double>(rowCount, NAN);
+			break;
+		case AbstractColumn::Integer:
+			m_empty_data = new ChunkedVector<int>(rowCount, ColumnPrivate::missingInt());
+			break;
+		case AbstractColumn::BigInt:
+			m_empty_data = new ChunkedVector<qint64>(rowCount, ColumnPrivate::missingBigInt());
+			break;
+		case AbstractColumn::Float:
+			m_empty_data = new ChunkedVector<float>(rowCount, NAN);
+			break;
 		case AbstractColumn::DateTime:
 		case AbstractColumn::Month:
 		case AbstractColumn::Day:
-			m_empty_data = new QList<QDateTime>();
-			for(int i=0; i<rowCount; i++)
-				static_cast< QList<QDateTime> *>(m_empty_data)->append(QDateTime());
+			m_empty_data = new ChunkedVector<qint64>(rowCount, ColumnPrivate::invalidDateTime());
 			break;
 		case AbstractColumn::Text:
-			m_empty_data = new QStringList();
-			for(int i=0; i<rowCount; i++)
-				static_cast< QStringList *>(m_empty_data)->append(QString());
+			m_empty_data = new TextDictionary();
+			static_cast< TextDictionary *>(m_empty_data)->resize(rowCount);
 			break;
 		}
 		m_data = m_col->dataPointer();
@@ -627,6 +711,61 @@ void ColumnClearCmd::undo() {
 	m_undone = true;
 }
 
+/** ***************************************************************************
+ * \class ColumnPermuteRowsCmd
+ * \brief Reorder the rows of a column, e.g. when sorting
+ *
+ * Only the permutation is stored, undo applies its inverse. When sorting several
+ * columns by a leading column, the commands of all columns share the same permutation.
+ ** ***************************************************************************/
+
+/**
+ * \var ColumnPermuteRowsCmd::m_permutation
+ * \brief Row \c i gets the value of row m_permutation[i]
+ */
+
+/**
+ * \var ColumnPermuteRowsCmd::m_permuted_data
+ * \brief The rows already reordered by ColumnPrivate::startPermutedRows(), taken over by the first redo()
+ */
+
+/**
+ * \brief Ctor
+ */
+ColumnPermuteRowsCmd::ColumnPermuteRowsCmd(ColumnPrivate* col, const QVector<int>& permutation, void* permuted_data, QUndoCommand* parent)
+	: QUndoCommand(parent), m_col(col), m_permutation(permutation), m_permuted_data(permuted_data), m_old_row_count(0) {
+	setText(i18n("%1: sort rows", col->name()));
+}
+
+/**
+ * \brief Execute the command
+ */
+void ColumnPermuteRowsCmd::redo() {
+	m_old_row_count = m_col->rowCount();
+	if (m_permuted_data) {
+		m_col->setPermutedRows(m_permuted_data, m_permutation);
+		m_permuted_data = 0;
+		return;
+	}
+
+	if (m_old_row_count < m_permutation.size())
+		m_col->resizeTo(m_permutation.size());
+	m_col->permuteRows(m_permutation);
+}
+
+/**
+ * \brief Undo the command
+ */
+void ColumnPermuteRowsCmd::undo() {
+	QVector<int> inverse(m_permutation.size());
+	for (int i = 0; i < m_permutation.size(); ++i)
+		inverse[m_permutation.at(i)] = i;
+
+	m_col->permuteRows(inverse);
+	if (m_old_row_count < m_permutation.size())
+		m_col->resizeTo(m_old_row_count);
+}
+
 
 /** ***************************************************************************
  * \class ColumSetGlobalFormulaCmd
@@ -652,6 +791,68 @@ void ColumnSetGlobalFormulaCmd::undo() {
 	m_col->setFormula(m_formula, m_variableNames, m_variableColumnPathes);
 }
 
+/** ***************************************************************************
+ * \class ColumnSetRandomValuesCmd
+ * \brief Replace the values by generated random values and record the generator and the seed they were generated with
+ *
+ * The chunks of the generated values are shared with the column, undo restores the chunks of the old values.
+ ** ***************************************************************************/
+
+/**
+ * \var ColumnSetRandomValuesCmd::m_values
+ * \brief The generated values followed by the remaining rows of the column, empty if the column converts them
+ */
+
+/**
+ * \var ColumnSetRandomValuesCmd::m_old_values
+ * \brief The values before the command was executed, empty if the column converts the generated values
+ */
+
+/**
+ * \brief Ctor
+ */
+ColumnSetRandomValuesCmd::ColumnSetRandomValuesCmd(ColumnPrivate* col, const ChunkedVector<double>& values,
+		const QString& generator, quint64 seed, QUndoCommand* parent)
+	: QUndoCommand(parent), m_col(col), m_values(values), m_generator(generator), m_seed(seed),
+	m_old_generator(col->randomGenerator()), m_old_seed(col->randomSeed()) {
+	setText(i18n("%1: fill with random values", col->name()));
+
+	if (col->columnMode() == AbstractColumn::Numeric) {
+		m_old_values = *static_cast< ChunkedVector<double>* >(col->dataPointer());
+		//rows beyond the generated ones keep their values
+		m_values.append(m_old_values, m_values.size(), m_old_values.size() - m_values.size());
+	} else {
+		//Integer, BigInt and Float columns store the converted values
+		new ColumnReplaceValuesCmd(col, 0, values.toVector(), this);
+		m_values.clear();
+	}
+}
+
+/**
+ * \brief Execute the command
+ */
+void ColumnSetRandomValuesCmd::redo() {
+	if (childCount() > 0)
+		QUndoCommand::redo();
+	else
+		m_col->replaceValues(m_values);
+
+	//changing the values dropped the seed, it's set afterwards
+	m_col->setRandomSeed(m_generator, m_seed);
+}
+
+/**
+ * \brief Undo the command
+ */
+void ColumnSetRandomValuesCmd::undo() {
+	if (childCount() > 0)
+		QUndoCommand::undo();
+	else
+		m_col->replaceValues(m_old_values);
+
+	m_col->setRandomSeed(m_old_generator, m_old_seed);
+}
+
 
 /** ***************************************************************************
  * \class ColumSetFormulaCmd
@@ -970,7 +1171,7 @@ ColumnReplaceTextsCmd::ColumnReplaceTextsCmd(ColumnPrivate * col, int first, con
  */
 void ColumnReplaceTextsCmd::redo() {
 	if(!m_copied) {
-		m_old_values = static_cast< QStringList* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
+		m_old_values = static_cast< TextDictionary* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
 		m_row_count = m_col->rowCount();
 		m_copied = true;
 	}
@@ -1001,14 +1202,34 @@ void ColumnReplaceTextsCmd::undo() {
  * \brief The first row to replace
  */
 
+/**
+ * \var ColumnReplaceValuesCmd::m_count
+ * \brief The number of rows to replace
+ */
+
 /**
  * \var ColumnReplaceValuesCmd::m_new_values
- * \brief The new values
+ * \brief The new values, only kept until the command is executed the first time
  */
 
 /**
- * \var ColumnReplaceValuesCmd::m_old_values
- * \brief The old values
+ * \var ColumnReplaceValuesCmd::m_ranges
+ * \brief The ranges (offset to m_first and length) of the rows within m_old_count whose values were changed
+ */
+
+/**
+ * \var ColumnReplaceValuesCmd::m_old_data
+ * \brief The old values of the rows in m_ranges
+ */
+
+/**
+ * \var ColumnReplaceValuesCmd::m_new_data
+ * \brief The new values of the rows in m_ranges followed by the new values of the rows from m_old_count on
+ */
+
+/**
+ * \var ColumnReplaceValuesCmd::m_old_count
+ * \brief The number of replaced rows which existed before, the rows behind them are removed again by undo()
  */
 
 /**
@@ -1025,28 +1246,87 @@ void ColumnReplaceTextsCmd::undo() {
  * \brief Ctor
  */
 ColumnReplaceValuesCmd::ColumnReplaceValuesCmd(ColumnPrivate * col, int first, const QVector<double>& new_values, QUndoCommand * parent )
-	: QUndoCommand( parent ), m_col(col), m_first(first), m_new_values(new_values) {
+	: QUndoCommand( parent ), m_col(col), m_first(first), m_count(new_values.count()), m_new_values(new_values),
+	m_old_count(0), m_copied(false), m_row_count(0) {
 	setText(i18n("%1: replace the values for rows %2 to %3", col->name(), first, first + new_values.count() -1));
-	m_copied = false;
 }
 
 /**
  * \brief Execute the command
+ *
+ * The first time the old and the new values of the changed rows are stored compressed,
+ * unchanged rows are not stored at all. The new values are dropped afterwards.
  */
 void ColumnReplaceValuesCmd::redo() {
 	if(!m_copied) {
-		m_old_values = static_cast< QVector<double>* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
 		m_row_count = m_col->rowCount();
+		m_old_count = qBound(0, m_row_count - m_first, m_count);
+		QVector<double> old_values(m_old_count);
+		m_col->valuesAsDouble(m_first, m_old_count, old_values.data());
+
+		m_col->replaceValues(m_first, m_new_values);
+
+		// compare with the stored values, they can differ from the given ones in integer columns
+		QVector<double> values(m_count);
+		m_col->valuesAsDouble(m_first, m_count, values.data());
+		m_new_values = QVector<double>();
+
+		// the values are compared bitwise, unchanged NaNs are not stored
+		int i = 0;
+		while (i < m_old_count) {
+			if (memcmp(&old_values[i], &values[i], sizeof(double)) == 0) {
+				++i;
+				continue;
+			}
+			const int start = i;
+			while (i < m_old_count && memcmp(&old_values[i], &values[i], sizeof(double)) != 0)
+				++i;
+			m_ranges << qMakePair(start, i - start);
+		}
+
+		QVector<double> changed;
+		for (int r = 0; r < m_ranges.size(); ++r)
+			changed += old_values.mid(m_ranges.at(r).first, m_ranges.at(r).second);
+		m_old_data.append(changed.constData(), changed.size());
+		old_values = QVector<double>();
+
+		changed.clear();
+		for (int r = 0; r < m_ranges.size(); ++r)
+			changed += values.mid(m_ranges.at(r).first, m_ranges.at(r).second);
+		changed += values.mid(m_old_count);
+		m_new_data.append(changed.constData(), changed.size());
 		m_copied = true;
+		return;
+	}
+
+	QVector<double> values(m_count);
+	m_col->valuesAsDouble(m_first, m_old_count, values.data());
+	QVector<double> changed(m_new_data.size());
+	m_new_data.read(changed.data());
+	int offset = 0;
+	for (int r = 0; r < m_ranges.size(); ++r) {
+		memcpy(values.data() + m_ranges.at(r).first, changed.constData() + offset, m_ranges.at(r).second*sizeof(double));
+		offset += m_ranges.at(r).second;
 	}
-	m_col->replaceValues(m_first, m_new_values);
+	memcpy(values.data() + m_old_count, changed.constData() + offset, (m_count - m_old_count)*sizeof(double));
+	m_col->replaceValues(m_first, values);
 }
 
 /**
  * \brief Undo the command
  */
 void ColumnReplaceValuesCmd::undo() {
-	m_col->replaceValues(m_first, m_old_values);
+	QVector<double> values(m_old_count);
+	m_col->valuesAsDouble(m_first, m_old_count, values.data());
+	QVector<double> changed(m_old_data.size());
+	m_old_data.read(changed.data());
+	int offset = 0;
+	for (int r = 0; r < m_ranges.size(); ++r) {
+		memcpy(values.data() + m_ranges.at(r).first, changed.constData() + offset, m_ranges.at(r).second*sizeof(double));
+		offset += m_ranges.at(r).second;
+	}
+	if (m_old_count > 0)
+		m_col->replaceValues(m_first, values);
 	m_col->resizeTo(m_row_count);
 	m_col->replaceData(m_col->dataPointer());
 }
@@ -1100,7 +1380,9 @@ ColumnReplaceDateTimesCmd::ColumnReplaceDateTimesCmd(ColumnPrivate * col, int fi
  */
 void ColumnReplaceDateTimesCmd::redo() {
 	if(!m_copied) {
-		m_old_values = static_cast< QList<QDateTime>* >(m_col->dataPointer())->mid(m_first, m_new_values.count());
+		const int last = qMin(m_first + m_new_values.count(), m_col->rowCount());
+		for (int i = m_first; i < last; ++i)
+			m_old_values << m_col->dateTimeAt(i);
 		m_row_count = m_col->rowCount();
 		m_copied = true;
 	}
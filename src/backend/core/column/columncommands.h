@@ -31,7 +31,9 @@
 #ifndef COLUMNCOMMANDS_H
 #define COLUMNCOMMANDS_H
 
+#include "backend/lib/ChunkedVector.h"
 #include "backend/lib/IntervalAttribute.h"
+#include "backend/lib/UndoBuffer.h"
 #include "backend/core/column/Column.h"
 
 #include <QUndoCommand>
@@ -141,6 +143,19 @@ private:
 	AbstractColumn::PlotDesignation m_old_pd;
 };
 
+class ColumnSetTimeSpecCmd : public QUndoCommand {
+public:
+	explicit ColumnSetTimeSpecCmd(ColumnPrivate* col, Qt::TimeSpec spec, QUndoCommand* parent = 0);
+
+	virtual void redo();
+	virtual void undo();
+
+private:
+	ColumnPrivate* m_col;
+	Qt::TimeSpec m_new_spec;
+	Qt::TimeSpec m_old_spec;
+};
+
 class ColumnClearCmd : public QUndoCommand {
 public:
 	explicit ColumnClearCmd(ColumnPrivate* col, QUndoCommand* parent = 0);
@@ -157,6 +172,20 @@ private:
 
 };
 
+class ColumnPermuteRowsCmd : public QUndoCommand {
+public:
+	explicit ColumnPermuteRowsCmd(ColumnPrivate* col, const QVector<int>& permutation, void* permuted_data = 0, QUndoCommand* parent = 0);
+
+	virtual void redo();
+	virtual void undo();
+
+private:
+	ColumnPrivate* m_col;
+	QVector<int> m_permutation;
+	void* m_permuted_data;
+	int m_old_row_count;
+};
+
 class ColumnSetGlobalFormulaCmd : public QUndoCommand {
 public:
 	explicit ColumnSetGlobalFormulaCmd(ColumnPrivate* col, const QString& formula, const QStringList& variableNames, const QStringList& variableColumnPathes);
@@ -175,6 +204,24 @@ private:
 	bool m_copied;
 };
 
+class ColumnSetRandomValuesCmd : public QUndoCommand {
+public:
+	explicit ColumnSetRandomValuesCmd(ColumnPrivate* col, const ChunkedVector<double>& values, const QString& generator,
+		quint64 seed, QUndoCommand* parent = 0);
+
+	virtual void redo();
+	virtual void undo();
+
+private:
+	ColumnPrivate* m_col;
+	ChunkedVector<double> m_values;
+	ChunkedVector<double> m_old_values;
+	QString m_generator;
+	quint64 m_seed;
+	QString m_old_generator;
+	quint64 m_old_seed;
+};
+
 class ColumnSetFormulaCmd : public QUndoCommand {
 public:
 	explicit ColumnSetFormulaCmd(ColumnPrivate* col, Interval<int> interval, const QString& formula, QUndoCommand* parent = 0);
@@ -275,8 +322,12 @@ public:
 private:
 	ColumnPrivate* m_col;
 	int m_first;
+	int m_count;
 	QVector<double> m_new_values;
-	QVector<double> m_old_values;
+	QVector<QPair<int, int> > m_ranges;
+	UndoBuffer m_old_data;
+	UndoBuffer m_new_data;
+	int m_old_count;
 	bool m_copied;
 	int m_row_count;
 };
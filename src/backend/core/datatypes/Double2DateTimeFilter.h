@@ -64,7 +64,7 @@ class Double2DateTimeFilter : public AbstractSimpleFilter
 	protected:
 		//! Using typed ports: only double inputs are accepted.
 		virtual bool inputAcceptable(int, const AbstractColumn *source) {
-			return source->columnMode() == AbstractColumn::Numeric;
+			return AbstractColumn::isNumeric(source->columnMode());
 		}
 };
 
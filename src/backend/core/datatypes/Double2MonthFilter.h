@@ -61,7 +61,7 @@ class Double2MonthFilter : public AbstractSimpleFilter
 
 	protected:
 		virtual bool inputAcceptable(int, const AbstractColumn *source) {
-			return source->columnMode() == AbstractColumn::Numeric;
+			return AbstractColumn::isNumeric(source->columnMode());
 		}
 };
 
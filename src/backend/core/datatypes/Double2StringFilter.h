@@ -81,7 +81,7 @@ class Double2StringFilter : public AbstractSimpleFilter
 	protected:
 		//! Using typed ports: only double inputs are accepted.
 		virtual bool inputAcceptable(int, const AbstractColumn *source) {
-			return source->columnMode() == AbstractColumn::Numeric;
+			return AbstractColumn::isNumeric(source->columnMode());
 		}
 };
 
@@ -55,31 +55,34 @@ void AbstractDataSource::clear() {
 }
 
 /*!
-	resize data source to cols columns
+	resize data source to cols columns of the mode \c columnMode
 	returns column offset depending on import mode
 */
-int AbstractDataSource::resize(AbstractFileFilter::ImportMode mode, QStringList colNameList, int cols) {
+int AbstractDataSource::resize(AbstractFileFilter::ImportMode mode, QStringList colNameList, int cols, AbstractColumn::ColumnMode columnMode) {
 	// name additional columns
 	for (int k=colNameList.size(); k<cols; k++ )
 		colNameList.append( "Column " + QString::number(k+1) );
 
 	int columnOffset=0; //indexes the "start column" in the spreadsheet. Starting from this column the data will be imported.
 
-	Column* newColumn = 0;
+	//new columns are added in one step and without undo commands, see AbstractAspect::insertChildrenBeforeFast()
+	QList<AbstractAspect*> newColumns;
         if (mode==AbstractFileFilter::Append){
                 columnOffset=childCount<Column>();
                 for ( int n=0; n<cols; n++ ){
-                        newColumn = new Column(colNameList.at(n), AbstractColumn::Numeric);
+                        Column* newColumn = new Column(colNameList.at(n), columnMode);
                         newColumn->setUndoAware(false);
-                        addChildFast(newColumn);
+                        newColumns << newColumn;
                 }
+                addChildrenFast(newColumns);
 	}else if (mode==AbstractFileFilter::Prepend){
                 Column* firstColumn = child<Column>(0);
                 for ( int n=0; n<cols; n++ ){
-                        newColumn = new Column(colNameList.at(n), AbstractColumn::Numeric);
+                        Column* newColumn = new Column(colNameList.at(n), columnMode);
                         newColumn->setUndoAware(false);
-                        insertChildBeforeFast(newColumn, firstColumn);
+                        newColumns << newColumn;
                 }
+                insertChildrenBeforeFast(newColumns, firstColumn);
         }else if (mode==AbstractFileFilter::Replace){
                 //replace completely the previous content of the data source with the content to be imported.
                 int columns = childCount<Column>();
@@ -94,7 +97,9 @@ int AbstractDataSource::resize(AbstractFileFilter::ImportMode mode, QStringList
                         //rename the columns, that are already available
                         for (int i=0; i<cols; i++){
                                 child<Column>(i)->setUndoAware(false);
-                                child<Column>(i)->setColumnMode( AbstractColumn::Numeric);
+                                //the values are replaced, clear them instead of converting them to the new mode
+                                child<Column>(i)->clear();
+                                child<Column>(i)->setColumnMode(columnMode);
                                 child<Column>(i)->setName(colNameList.at(i));
                                 child<Column>(i)->setSuppressDataChangedSignal(true);
                         }
@@ -102,41 +107,38 @@ int AbstractDataSource::resize(AbstractFileFilter::ImportMode mode, QStringList
                         //rename the columns, that are already available
                         for (int i=0; i<columns; i++){
                                 child<Column>(i)->setUndoAware(false);
-                                child<Column>(i)->setColumnMode( AbstractColumn::Numeric);
+                                //the values are replaced, clear them instead of converting them to the new mode
+                                child<Column>(i)->clear();
+                                child<Column>(i)->setColumnMode(columnMode);
                                 child<Column>(i)->setName(colNameList.at(i));
                                 child<Column>(i)->setSuppressDataChangedSignal(true);
                         }
 
                         //create additional columns if needed
                         for(int i=columns; i < cols; i++) {
-                                newColumn = new Column(colNameList.at(i), AbstractColumn::Numeric);
+                                Column* newColumn = new Column(colNameList.at(i), columnMode);
                                 newColumn->setUndoAware(false);
-                                addChildFast(newColumn);
-                                child<Column>(i)->setSuppressDataChangedSignal(true);
+                                newColumn->setSuppressDataChangedSignal(true);
+                                newColumns << newColumn;
                         }
+                        addChildrenFast(newColumns);
                 }
 	}
 
-	if (newColumn) {
-		//notify the model about newly created objects, it's sufficient to do it once for the last child
-		emit aspectAboutToBeAdded(this, 0, newColumn);
-		emit aspectAdded(newColumn);
-	}
-
 	return columnOffset;
 }
 
 
 //TODO: use polymorphism instead  - provide Spreadsheet::create() and Matrix::create() instead of this function.
-int AbstractDataSource::create(QVector<QVector<double>*>& dataPointers, AbstractFileFilter::ImportMode mode,
-							   int actualRows, int actualCols, QStringList colNameList) {
+int AbstractDataSource::create(QVector<ImportedColumn>& dataPointers, AbstractFileFilter::ImportMode mode,
+							   int actualRows, int actualCols, QStringList colNameList, AbstractColumn::ColumnMode columnMode) {
 	QDEBUG("create() rows =" << actualRows << " cols =" << actualCols);
 	int columnOffset = 0;
 	setUndoAware(false);
 
 	Spreadsheet* spreadsheet = dynamic_cast<Spreadsheet*>(this);
 	if(spreadsheet) {
-		columnOffset = this->resize(mode, colNameList, actualCols);
+		columnOffset = this->resize(mode, colNameList, actualCols, columnMode);
 
 		// resize the spreadsheet
 		if (mode == AbstractFileFilter::Replace) {
@@ -147,14 +149,13 @@ int AbstractDataSource::create(QVector<QVector<double>*>& dataPointers, Abstract
 				spreadsheet->setRowCount(actualRows);
 		}
 
+		// the values are written directly into the storage of the columns
 		dataPointers.resize(actualCols);
 		for (int n = 0; n < actualCols; n++) {
-			QVector<double>* vector = static_cast<QVector<double>* >(this->child<Column>(columnOffset+n)->data());
-			vector->reserve(actualRows);
-			vector->resize(actualRows);
-			dataPointers[n] = vector;
+			Column* column = this->child<Column>(columnOffset+n);
+			dataPointers[n] = ImportedColumn(column->columnMode(), column->data());
+			dataPointers[n].resize(actualRows);
 		}
-		QDEBUG("dataPointers =" << dataPointers);
 
 		return columnOffset;
 	}
@@ -180,7 +181,7 @@ int AbstractDataSource::create(QVector<QVector<double>*>& dataPointers, Abstract
 			QVector<double>* vector = &matrixColumns[n];
 			vector->reserve(actualRows);
 			vector->resize(actualRows);
-			dataPointers[n] = vector;
+			dataPointers[n] = ImportedColumn(vector);
 		}
 	}
 
@@ -29,10 +29,115 @@ Copyright	: (C) 2015 Stefan Gerlach (stefan.gerlach@uni.kn)
 #define ABSTRACTDATASOURCE_H
 
 #include "backend/core/AbstractPart.h"
+#include "backend/core/AbstractColumn.h"
 #include "backend/core/AbstractScriptingEngine.h"
 #include "backend/datasources/filters/AbstractFileFilter.h"
+#include "backend/lib/ChunkedVector.h"
 
 #include <QStringList>
+#include <cmath>
+#include <limits>
+
+/*!
+	\class ImportedColumn
+	\brief Write access to a column of a data source filled by an import filter.
+
+	The values of spreadsheet columns are stored in chunks in the storage type of their column mode
+	(see ColumnPrivate::m_data), the values of matrix columns contiguously as doubles.
+	Values are converted to the storage type when written, only integral values
+	may be written into Integer and BigInt columns. A default constructed ImportedColumn is null.
+*/
+class ImportedColumn {
+	public:
+		ImportedColumn() : m_mode(AbstractColumn::Numeric), m_data(0), m_vector(0) {}
+		ImportedColumn(AbstractColumn::ColumnMode mode, void* data) : m_mode(mode), m_data(data), m_vector(0) {}
+		explicit ImportedColumn(QVector<double>* vector) : m_mode(AbstractColumn::Numeric), m_data(0), m_vector(vector) {}
+
+		bool isNull() const { return !m_data && !m_vector; }
+
+		template<typename T> void setValue(int row, T value) {
+			if (m_vector) {
+				(*m_vector)[row] = value;
+				return;
+			}
+			switch (m_mode) {
+			case AbstractColumn::Integer:
+				(*static_cast< ChunkedVector<int>* >(m_data))[row] = static_cast<int>(value);
+				break;
+			case AbstractColumn::BigInt:
+				(*static_cast< ChunkedVector<qint64>* >(m_data))[row] = static_cast<qint64>(value);
+				break;
+			case AbstractColumn::Float:
+				(*static_cast< ChunkedVector<float>* >(m_data))[row] = value;
+				break;
+			default:
+				(*static_cast< ChunkedVector<double>* >(m_data))[row] = value;
+			}
+		}
+
+		//! replaces the values of the rows \c first to \c first + \c count - 1, they have to exist
+		template<typename T> void write(int first, int count, const T* values) {
+			if (m_vector) {
+				for (int i = 0; i < count; ++i)
+					(*m_vector)[first + i] = values[i];
+				return;
+			}
+			switch (m_mode) {
+			case AbstractColumn::Integer:
+				static_cast< ChunkedVector<int>* >(m_data)->write(first, count, values);
+				break;
+			case AbstractColumn::BigInt:
+				static_cast< ChunkedVector<qint64>* >(m_data)->write(first, count, values);
+				break;
+			case AbstractColumn::Float:
+				static_cast< ChunkedVector<float>* >(m_data)->write(first, count, values);
+				break;
+			default:
+				static_cast< ChunkedVector<double>* >(m_data)->write(first, count, values);
+			}
+		}
+
+		void append(double value) {
+			if (m_vector)
+				m_vector->append(value);
+			else
+				static_cast< ChunkedVector<double>* >(m_data)->append(value);
+		}
+
+		//! resizes the column, new rows are empty
+		void resize(int size) {
+			if (m_vector) {
+				m_vector->resize(size);
+				return;
+			}
+			// the missing values of the integer modes, see ColumnPrivate::missingInt()
+			switch (m_mode) {
+			case AbstractColumn::Integer:
+				static_cast< ChunkedVector<int>* >(m_data)->resize(size, std::numeric_limits<int>::min());
+				break;
+			case AbstractColumn::BigInt:
+				static_cast< ChunkedVector<qint64>* >(m_data)->resize(size, std::numeric_limits<qint64>::min());
+				break;
+			case AbstractColumn::Float:
+				static_cast< ChunkedVector<float>* >(m_data)->resize(size, NAN);
+				break;
+			default:
+				static_cast< ChunkedVector<double>* >(m_data)->resize(size, NAN);
+			}
+		}
+
+		void clear() {
+			if (m_vector)
+				m_vector->clear();
+			else
+				resize(0);
+		}
+
+	private:
+		AbstractColumn::ColumnMode m_mode;
+		void* m_data;
+		QVector<double>* m_vector;
+};
 
 class AbstractDataSource : public AbstractPart, public scripted{
 	Q_OBJECT
@@ -41,9 +146,11 @@ class AbstractDataSource : public AbstractPart, public scripted{
    		AbstractDataSource(AbstractScriptingEngine *engine, const QString& name);
         virtual ~AbstractDataSource() {}
 		void clear();
-		int resize(AbstractFileFilter::ImportMode mode, QStringList colNameList, int cols);
-		int create(QVector<QVector<double>*>& dataPointers, AbstractFileFilter::ImportMode mode,
-				   int actualRows, int actualCols, QStringList colNameList = QStringList());
+		int resize(AbstractFileFilter::ImportMode mode, QStringList colNameList, int cols,
+				   AbstractColumn::ColumnMode columnMode = AbstractColumn::Numeric);
+		int create(QVector<ImportedColumn>& dataPointers, AbstractFileFilter::ImportMode mode,
+				   int actualRows, int actualCols, QStringList colNameList = QStringList(),
+				   AbstractColumn::ColumnMode columnMode = AbstractColumn::Numeric);
 };
 
 #endif // ifndef ABSTRACTDATASOURCE_H
@@ -373,7 +373,7 @@ QList<QStringList> AsciiFilterPrivate::readData(const QString & fileName, Abstra
 
 	int currentRow = 0; // indexes the position in the vector(column)
 	int columnOffset = 0; // indexes the "start column" in the spreadsheet. Starting from this column the data will be imported.
-	QVector<QVector<double>*> dataPointers;	// pointers to the actual data containers
+	QVector<ImportedColumn> dataPointers;	// the actual data containers
 
 	if (dataSource != NULL)
 		columnOffset = dataSource->create(dataPointers, mode, actualRows, actualCols, vectorNameList);
@@ -386,12 +386,12 @@ QList<QStringList> AsciiFilterPrivate::readData(const QString & fileName, Abstra
 			if (n < lineStringList.size()) {
 				const double value = lineStringList.at(n).toDouble(&isNumber);
 				if (dataSource != NULL)
-					isNumber ? dataPointers[n]->operator[](0) = value : dataPointers[n]->operator[](0) = NAN;
+					dataPointers[n].setValue(0, isNumber ? value : NAN);
 				else
 					isNumber ? lineString << QString::number(value) : lineString << QLatin1String("NAN");
 			} else {
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](0) = NAN;
+					dataPointers[n].setValue(0, NAN);
 				else
 					lineString << QLatin1String("NAN");
 			}
@@ -424,12 +424,12 @@ QList<QStringList> AsciiFilterPrivate::readData(const QString & fileName, Abstra
 			if (n < lineStringList.size()) {
 				const double value = lineStringList.at(n).toDouble(&isNumber);
 				if (dataSource != NULL)
-					isNumber ? dataPointers[n]->operator[](currentRow) = value : dataPointers[n]->operator[](currentRow) = NAN;
+					dataPointers[n].setValue(currentRow, isNumber ? value : NAN);
 				else
 					isNumber ? lineString += QString::number(value) : lineString += QString("NAN");
 			} else {
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](currentRow) = NAN;
+					dataPointers[n].setValue(currentRow, NAN);
 				else
 					lineString += QLatin1String("NAN");
 			}
@@ -266,10 +266,11 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 	qDebug()<<"	lines ="<<lines;
 #endif
 
-	QVector<QVector<double>*> dataPointers;
+	// integer and single precision values are read directly into columns of the matching mode
+	QVector<ImportedColumn> dataPointers;
 	int columnOffset = 0;
 	if (dataSource != NULL)
-		columnOffset = dataSource->create(dataPointers, mode, actualRows, actualCols);
+		columnOffset = dataSource->create(dataPointers, mode, actualRows, actualCols, QStringList(), columnModeForDataType());
 
 	// read data
 	for (int i = 0; i < qMin(actualRows, lines); i++) {
@@ -280,7 +281,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				qint8 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					dataPointers[n].setValue(i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -289,7 +290,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				qint16 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					dataPointers[n].setValue(i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -298,7 +299,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				qint32 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					dataPointers[n].setValue(i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -307,7 +308,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				qint64 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					dataPointers[n].setValue(i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -316,7 +317,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				quint8 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					dataPointers[n].setValue(i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -325,7 +326,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				quint16 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					dataPointers[n].setValue(i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -334,7 +335,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				quint32 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					dataPointers[n].setValue(i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -343,7 +344,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				quint64 value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					dataPointers[n].setValue(i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -352,7 +353,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				float value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					dataPointers[n].setValue(i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -361,7 +362,7 @@ QList<QStringList> BinaryFilterPrivate::readData(const QString & fileName, Abstr
 				double value;
 				in >> value;
 				if (dataSource != NULL)
-					dataPointers[n]->operator[](i) = value;
+					dataPointers[n].setValue(i, value);
 				else
 					lineString << QString::number(value);
 				break;
@@ -412,6 +413,32 @@ void BinaryFilterPrivate::read(const QString & fileName, AbstractDataSource* dat
 /*!
     writes the content of \c dataSource to the file \c fileName.
 */
+/*!
+ * returns the column mode holding the values of the selected data type without loss of precision.
+ * 64 bit integers and unsigned 32 bit integers go into BigInt columns, the other integers into Integer columns.
+ * Unsigned 64 bit integers don't fit into BigInt and stay Numeric.
+ */
+AbstractColumn::ColumnMode BinaryFilterPrivate::columnModeForDataType() const {
+	switch (dataType) {
+	case BinaryFilter::INT8:
+	case BinaryFilter::INT16:
+	case BinaryFilter::INT32:
+	case BinaryFilter::UINT8:
+	case BinaryFilter::UINT16:
+		return AbstractColumn::Integer;
+	case BinaryFilter::INT64:
+	case BinaryFilter::UINT32:
+		return AbstractColumn::BigInt;
+	case BinaryFilter::REAL32:
+		return AbstractColumn::Float;
+	case BinaryFilter::UINT64:
+	case BinaryFilter::REAL64:
+		break;
+	}
+
+	return AbstractColumn::Numeric;
+}
+
 void BinaryFilterPrivate::write(const QString & fileName, AbstractDataSource* dataSource) {
 	Q_UNUSED(fileName);
 	Q_UNUSED(dataSource);
@@ -27,6 +27,8 @@ Copyright            : (C) 2015 Stefan Gerlach (stefan.gerlach@uni.kn)
 #ifndef BINARYFILTERPRIVATE_H
 #define BINARYFILTERPRIVATE_H
 
+#include "backend/core/AbstractColumn.h"
+
 class AbstractDataSource;
 
 class BinaryFilterPrivate {
@@ -53,6 +55,7 @@ class BinaryFilterPrivate {
 
 	private:
 		void clearDataSource(AbstractDataSource*) const;
+		AbstractColumn::ColumnMode columnModeForDataType() const;
 };
 
 #endif
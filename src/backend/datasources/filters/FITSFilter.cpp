@@ -30,6 +30,7 @@ Copyright            : (C) 2016 by Fabian Kristof (fkristofszabolcs@gmail.com)
 #include "backend/datasources/FileDataSource.h"
 #include "backend/core/column/Column.h"
 #include "backend/core/datatypes/Double2StringFilter.h"
+#include "backend/lib/TextDictionary.h"
 #include "commonfrontend/matrix/MatrixView.h"
 #include "backend/matrix/MatrixModel.h"
 
@@ -343,7 +344,7 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 			return dataStrings << (QStringList() << QString("Error"));
 		}
 
-		QVector<QVector<double>*> dataPointers;
+		QVector<ImportedColumn> dataPointers;
 
 		if (endRow != -1) {
 			if (!noDataSource)
@@ -376,7 +377,7 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 				if (noDataSource)
 					line << QString::number(data[i*naxes[0] +j]);
 				else
-					dataPointers[jj++]->operator [](ii) = data[i* naxes[0] + j];
+					dataPointers[jj++].setValue(ii, data[i* naxes[0] + j]);
 			}
 			dataStrings << line;
 			j = jstart;
@@ -459,8 +460,8 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 
 		if (endRow != -1)
 			lines = endRow;
-		QVector<QStringList*> stringDataPointers;
-		QVector<QVector<double>*> numericDataPointers;
+		QVector<TextDictionary*> stringDataPointers;
+		QVector<ImportedColumn> numericDataPointers;
 		QList<bool> columnNumericTypes;
 
 		int startCol = 0;
@@ -538,13 +539,13 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 				for (int n = 0; n < actualCols - startCol; n++) {
 					if (columnNumericTypes.at(n)) {
 						spreadsheet->column(columnOffset+ n)->setColumnMode(AbstractColumn::Numeric);
-						QVector<double>* datap = static_cast<QVector<double>* >(spreadsheet->column(columnOffset+n)->data());
+						ImportedColumn datap(AbstractColumn::Numeric, spreadsheet->column(columnOffset+n)->data());
 						numericDataPointers.push_back(datap);
 						if (importMode == AbstractFileFilter::Replace)
-							datap->clear();
+							datap.clear();
 					} else {
 						spreadsheet->column(columnOffset+ n)->setColumnMode(AbstractColumn::Text);
-						QStringList* list = static_cast<QStringList* >(spreadsheet->column(columnOffset+n)->data());
+						TextDictionary* list = static_cast<TextDictionary* >(spreadsheet->column(columnOffset+n)->data());
 						stringDataPointers.push_back(list);
 						if (importMode == AbstractFileFilter::Replace)
 							list->clear();
@@ -576,7 +577,7 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 			actualCols = matrixNumericColumnIndices.last();
 			if (importMode == AbstractFileFilter::Replace) {
 				for (int i = 0; i < numericDataPointers.size(); ++i)
-					numericDataPointers[i]->clear();
+					numericDataPointers[i].clear();
 			}
 			isMatrix = true;
 		}
@@ -597,15 +598,15 @@ QList<QStringList> FITSFilterPrivate::readCHDU(const QString &fileName, Abstract
 					const QString& str = QString::fromLatin1(array);
 					if (str.isEmpty()) {
 						if (columnNumericTypes.at(col-1))
-							numericDataPointers[numericixd++]->push_back(0);
+							numericDataPointers[numericixd++].append(0);
 						else
 							stringDataPointers[stringidx++]->append(QLatin1String("NULL"));
 					} else {
 						if (columnNumericTypes.at(col-1))
-							numericDataPointers[numericixd++]->push_back(str.toDouble());
+							numericDataPointers[numericixd++].append(str.toDouble());
 						else {
 							if (!stringDataPointers.isEmpty())
-								stringDataPointers[stringidx++]->operator <<( str.simplified());
+								stringDataPointers[stringidx++]->append(str.simplified());
 						}
 					}
 				} else {
@@ -857,7 +858,10 @@ void FITSFilterPrivate::writeCHDU(const QString &fileName, AbstractDataSource *d
 					strcpy(tunit[i], "");
 				}
 				switch (column->columnMode()) {
-				case AbstractColumn::Numeric: {
+				case AbstractColumn::Numeric:
+				case AbstractColumn::Integer:
+				case AbstractColumn::BigInt:
+				case AbstractColumn::Float: {
 						int maxSize = -1;
 						for (int row = 0; row < nrows; ++row) {
 							if (QString::number(column->valueAt(row)).size() > maxSize)
@@ -948,7 +952,7 @@ void FITSFilterPrivate::writeCHDU(const QString &fileName, AbstractDataSource *d
 				const Column* c =  spreadsheet->column(col-1);
 				AbstractColumn::ColumnMode columnMode = c->columnMode();
 
-				if (columnMode == AbstractColumn::Numeric) {
+				if (AbstractColumn::isNumeric(columnMode)) {
 					for (int row = 0; row < nrows; ++row)
 						columnNumeric[row] = c->valueAt(row);
 
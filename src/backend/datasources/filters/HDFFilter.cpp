@@ -215,6 +215,29 @@ QString HDFFilterPrivate::translateHDFType(hid_t t) {
 	return type;
 }
 
+/*!
+ * returns the column mode holding the values of the HDF number type \c t without loss of precision.
+ * Integers of up to 32 bit go into Integer columns, unsigned 32 bit and signed 64 bit integers into BigInt columns
+ * and single precision values into Float columns. Everything else stays Numeric.
+ */
+AbstractColumn::ColumnMode HDFFilterPrivate::columnModeForHDFType(hid_t t) {
+	const size_t size = H5Tget_size(t);
+	const bool isSigned = (H5Tget_sign(t) == H5T_SGN_2);
+
+	switch (H5Tget_class(t)) {
+	case H5T_INTEGER:
+		if (size < 4 || (size == 4 && isSigned))
+			return AbstractColumn::Integer;
+		if (size == 4 || (size == 8 && isSigned))
+			return AbstractColumn::BigInt;
+		return AbstractColumn::Numeric;
+	case H5T_FLOAT:
+		return (size == 4) ? AbstractColumn::Float : AbstractColumn::Numeric;
+	default:
+		return AbstractColumn::Numeric;
+	}
+}
+
 QString HDFFilterPrivate::translateHDFClass(H5T_class_t c) {
 	QString dclass;
 	switch (c) {
@@ -294,7 +317,7 @@ QStringList HDFFilterPrivate::readHDFCompound(hid_t tid) {
 }
 
 template <typename T>
-QStringList HDFFilterPrivate::readHDFData1D(hid_t dataset, hid_t type, int rows, int lines, QVector<double> *dataPointer) {
+QStringList HDFFilterPrivate::readHDFData1D(hid_t dataset, hid_t type, int rows, int lines, ImportedColumn& dataPointer) {
 	DEBUG("readHDFData1D() rows =" << rows << "lines =" << lines);
 	QStringList dataString;
 
@@ -304,11 +327,10 @@ QStringList HDFFilterPrivate::readHDFData1D(hid_t dataset, hid_t type, int rows,
 	status = H5Dread(dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
 	handleError(status, "H5Dread");
 	DEBUG(" startRow =" << startRow << "endRow =" << endRow);
-	DEBUG("dataPointer =" << dataPointer);
-	for (int i = startRow-1; i < qMin(endRow, lines+startRow-1); i++) {
-		if (dataPointer != NULL)	// read to data source
-			dataPointer->operator[](i-startRow+1) = data[i];
-		else				// for preview
+	if (!dataPointer.isNull())	// read to data source
+		dataPointer.write(0, qMin(endRow, lines+startRow-1) - startRow + 1, data + startRow - 1);
+	else {				// for preview
+		for (int i = startRow-1; i < qMin(endRow, lines+startRow-1); i++)
 			dataString << QString::number(static_cast<double>(data[i]));
 	}
 	free(data);
@@ -316,12 +338,12 @@ QStringList HDFFilterPrivate::readHDFData1D(hid_t dataset, hid_t type, int rows,
 	return dataString;
 }
 
-QStringList HDFFilterPrivate::readHDFCompoundData1D(hid_t dataset, hid_t tid, int rows, int lines, QVector< QVector<double>* >& dataPointer) {
+QStringList HDFFilterPrivate::readHDFCompoundData1D(hid_t dataset, hid_t tid, int rows, int lines, QVector<ImportedColumn>& dataPointer) {
 	int members = H5Tget_nmembers(tid);
 	handleError(members, "H5Tget_nmembers");
 
 	QStringList dataString;
-	if (dataPointer[0] == NULL) {
+	if (dataPointer[0].isNull()) {
 		for (int i = 0; i < qMin(rows, lines); i++)
 			dataString <<  QLatin1String("(");
 	}
@@ -336,8 +358,8 @@ QStringList HDFFilterPrivate::readHDFCompoundData1D(hid_t dataset, hid_t tid, in
 		status = H5Tinsert(ctype, H5Tget_member_name(tid, m), 0, mtype);
 		handleError(status, "H5Tinsert");
 
-		QVector<double>* dataP = NULL;
-		if (dataPointer[0] != NULL)
+		ImportedColumn dataP;
+		if (!dataPointer[0].isNull())
 			dataP = dataPointer[m];
 
 		QStringList mdataString;
@@ -398,9 +420,9 @@ QStringList HDFFilterPrivate::readHDFCompoundData1D(hid_t dataset, hid_t tid, in
 		else if (H5Tequal(mtype, H5T_NATIVE_LDOUBLE))
 			mdataString = readHDFData1D<long double>(dataset, ctype, rows, lines, dataP);
 		else {
-			if (dataP != NULL) {
+			if (!dataP.isNull()) {
 				for (int i = startRow-1; i < qMin(endRow, lines+startRow-1); i++)
-					dataP->operator[](i-startRow+1) = 0;
+					dataP.setValue(i-startRow+1, 0);
 			} else {
 				for (int i = 0; i < qMin(rows, lines); i++)
 					mdataString << QLatin1String("_");
@@ -410,7 +432,7 @@ QStringList HDFFilterPrivate::readHDFCompoundData1D(hid_t dataset, hid_t tid, in
 			qDebug()<<"	not supported type of class" << translateHDFClass(mclass);
 		}
 
-		if (dataPointer[0] == NULL) {
+		if (dataPointer[0].isNull()) {
 			for (int i = 0; i < qMin(rows, lines); i++) {
 				dataString[i] +=  mdataString[i];
 				if (m < members-1)
@@ -421,7 +443,7 @@ QStringList HDFFilterPrivate::readHDFCompoundData1D(hid_t dataset, hid_t tid, in
 		H5Tclose(ctype);
 	}
 
-	if (dataPointer[0] == NULL) {
+	if (dataPointer[0].isNull()) {
 		for (int i = 0; i < qMin(rows, lines); i++)
 			dataString[i] +=  QLatin1String(")");
 	}
@@ -430,7 +452,7 @@ QStringList HDFFilterPrivate::readHDFCompoundData1D(hid_t dataset, hid_t tid, in
 }
 
 template <typename T>
-QList<QStringList> HDFFilterPrivate::readHDFData2D(hid_t dataset, hid_t type, int rows, int cols, int lines, QVector< QVector<double>* >& dataPointer) {
+QList<QStringList> HDFFilterPrivate::readHDFData2D(hid_t dataset, hid_t type, int rows, int cols, int lines, QVector<ImportedColumn>& dataPointer) {
 	DEBUG("readHDFData2D() rows =" << rows << "cols =" << cols << "lines =" << lines);
 	QList<QStringList> dataStrings;
 
@@ -446,8 +468,8 @@ QList<QStringList> HDFFilterPrivate::readHDFData2D(hid_t dataset, hid_t type, in
 		QStringList line;
 		line.reserve(cols);
 		for (int j = 0; j < cols; j++) {
-			if (dataPointer[0] != NULL)
-				dataPointer[j-startColumn+1]->operator[](i-startRow+1) = data[i][j];
+			if (!dataPointer[0].isNull())
+				dataPointer[j-startColumn+1].setValue(i-startRow+1, data[i][j]);
 			else {
 				line << QString::number(static_cast<double>(data[i][j]));
 			}
@@ -488,8 +510,8 @@ QList<QStringList> HDFFilterPrivate::readHDFCompoundData2D(hid_t dataset, hid_t
 		handleError(status, "H5Tinsert");
 
 		// dummy container for all data columns
-		// initially contains one pointer set to NULL
-		QVector< QVector<double>* > dummy(1, NULL);
+		// initially contains one null column
+		QVector<ImportedColumn> dummy(1);
 		QList<QStringList> mdataStrings;
 		if (H5Tequal(mtype, H5T_STD_I8LE) || H5Tequal(mtype, H5T_STD_I8BE)) {
 				mdataStrings = readHDFData2D<qint8>(dataset, H5Tget_native_type(ctype, H5T_DIR_DEFAULT), rows, cols, lines, dummy);
@@ -1248,14 +1270,19 @@ QList<QStringList> HDFFilterPrivate::readCurrentDataSet(const QString & fileName
 	handleError(rank, "H5Dget_simple_extent_ndims");
 	DEBUG(" rank =" << rank);
 
+	// integer and single precision data sets are read directly into columns of the matching mode
+	AbstractColumn::ColumnMode columnMode = AbstractColumn::Numeric;
+	if ((rank == 1 || rank == 2) && (dclass == H5T_INTEGER || dclass == H5T_FLOAT))
+		columnMode = columnModeForHDFType(dtype);
+
 	int columnOffset = 0;			// offset to import data
 	int actualRows = 0, actualCols = 0;	// rows and cols to read
 
 	// dataPointers is used to store the data read from the dataSource
 	// it contains the pointers of all columns
-	// initially there is one pointer set to NULL
-	// check for dataPointers[0] != NULL to decide if dataSource can be used
-	QVector<QVector<double>*> dataPointers(1, NULL);
+	// initially there is one null column
+	// check for !dataPointers[0].isNull() to decide if dataSource can be used
+	QVector<ImportedColumn> dataPointers(1);
 
 	// rank= 0: single value, 1: vector, 2: matrix, 3: 3D data, ...
 	switch (rank) {
@@ -1316,7 +1343,7 @@ QList<QStringList> HDFFilterPrivate::readCurrentDataSet(const QString & fileName
 				<< ", rows:" << rows << " max:" << maxSize;
 #endif
 			if (dataSource != NULL)
-				columnOffset = dataSource->create(dataPointers, mode, actualRows, actualCols);
+				columnOffset = dataSource->create(dataPointers, mode, actualRows, actualCols, QStringList(), columnMode);
 
 			QStringList dataString;	// data saved in a list
 			switch (dclass) {
@@ -1492,7 +1519,7 @@ QList<QStringList> HDFFilterPrivate::readCurrentDataSet(const QString & fileName
 #endif
 
 			if (dataSource != NULL)
-				columnOffset = dataSource->create(dataPointers, mode, actualRows, actualCols);
+				columnOffset = dataSource->create(dataPointers, mode, actualRows, actualCols, QStringList(), columnMode);
 
 			// read data
 			switch (dclass) {
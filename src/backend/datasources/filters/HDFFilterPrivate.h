@@ -28,11 +28,13 @@ Copyright            : (C) 2015 Stefan Gerlach (stefan.gerlach@uni.kn)
 #define HDFFILTERPRIVATE_H
 
 #include <QList>
+#include "backend/core/AbstractColumn.h"
 #ifdef HAVE_HDF5
 #include <hdf5.h>
 #endif
 
 class AbstractDataSource;
+class ImportedColumn;
 
 class HDFFilterPrivate {
 
@@ -63,10 +65,11 @@ class HDFFilterPrivate {
 		QString translateHDFOrder(H5T_order_t);
 		QString translateHDFType(hid_t);
 		QString translateHDFClass(H5T_class_t);
+		AbstractColumn::ColumnMode columnModeForHDFType(hid_t);
 		QStringList readHDFCompound(hid_t tid);
-		template <typename T> QStringList readHDFData1D(hid_t dataset, hid_t type, int rows, int lines, QVector<double> *dataPointer=NULL);
-		QStringList readHDFCompoundData1D(hid_t dataset, hid_t tid, int rows, int lines,QVector< QVector<double>* >& dataPointer);
-		template <typename T> QList <QStringList> readHDFData2D(hid_t dataset, hid_t ctype, int rows, int cols, int lines, QVector< QVector<double>* >& dataPointer);
+		template <typename T> QStringList readHDFData1D(hid_t dataset, hid_t type, int rows, int lines, ImportedColumn& dataPointer);
+		QStringList readHDFCompoundData1D(hid_t dataset, hid_t tid, int rows, int lines, QVector<ImportedColumn>& dataPointer);
+		template <typename T> QList <QStringList> readHDFData2D(hid_t dataset, hid_t ctype, int rows, int cols, int lines, QVector<ImportedColumn>& dataPointer);
 		QList<QStringList> readHDFCompoundData2D(hid_t dataset, hid_t tid, int rows, int cols, int lines);
 		QStringList readHDFAttr(hid_t aid);
 		QStringList scanHDFAttrs(hid_t oid);
@@ -182,7 +182,7 @@ void ImageFilterPrivate::read(const QString & fileName, AbstractDataSource* data
 
 	//make sure we have enough columns in the data source.
 	int columnOffset = 0;
-	QVector<QVector<double>*> dataPointers;
+	QVector<ImportedColumn> dataPointers;
 	if (dataSource != 0)
 		columnOffset = dataSource->create(dataPointers, mode, actualRows, actualCols);
 	else {
@@ -196,7 +196,7 @@ void ImageFilterPrivate::read(const QString & fileName, AbstractDataSource* data
 		for (int i=0; i<actualRows; i++) {
 			for ( int j=0; j<actualCols; j++ ) {
 				double value=qGray(image.pixel(j+startColumn-1,i+startRow-1));
-				dataPointers[j]->operator[](i) = value;
+				dataPointers[j].setValue(i, value);
 			}
 			emit q->completed(100*i/actualRows);
 		}
@@ -207,9 +207,9 @@ void ImageFilterPrivate::read(const QString & fileName, AbstractDataSource* data
 		for (int i=startRow-1; i<endRow; i++) {
 			for ( int j=startColumn-1; j<endColumn; j++ ) {
 				QRgb color=image.pixel(j, i);
-				dataPointers[0]->operator[](currentRow) = i+1;
-				dataPointers[1]->operator[](currentRow) = j+1;
-				dataPointers[2]->operator[](currentRow) = qGray(color);
+				dataPointers[0].setValue(currentRow, i+1);
+				dataPointers[1].setValue(currentRow, j+1);
+				dataPointers[2].setValue(currentRow, qGray(color));
 				currentRow++;
 			}
 			emit q->completed(100*i/actualRows);
@@ -221,11 +221,11 @@ void ImageFilterPrivate::read(const QString & fileName, AbstractDataSource* data
 		for (int i=startRow-1; i<endRow; i++) {
 			for ( int j=startColumn-1; j<endColumn; j++ ) {
 				QRgb color=image.pixel(j, i);
-				dataPointers[0]->operator[](currentRow) = i+1;
-				dataPointers[1]->operator[](currentRow) = j+1;
-				dataPointers[2]->operator[](currentRow) = qRed(color);
-				dataPointers[3]->operator[](currentRow) = qGreen(color);
-				dataPointers[4]->operator[](currentRow) = qBlue(color);
+				dataPointers[0].setValue(currentRow, i+1);
+				dataPointers[1].setValue(currentRow, j+1);
+				dataPointers[2].setValue(currentRow, qRed(color));
+				dataPointers[3].setValue(currentRow, qGreen(color));
+				dataPointers[4].setValue(currentRow, qBlue(color));
 				currentRow++;
 			}
 			emit q->completed(100*i/actualRows);
@@ -523,7 +523,7 @@ QList<QStringList> NetCDFFilterPrivate::readCurrentVar(const QString & fileName,
 
 	int actualRows = 0, actualCols = 0;
 	int columnOffset = 0;
-	QVector<QVector<double>*> dataPointers;
+	QVector<ImportedColumn> dataPointers;
 	switch (ndims) {
 	case 0:
 		dataStrings << (QStringList() << i18n("zero dimensions"));
@@ -547,17 +547,21 @@ QList<QStringList> NetCDFFilterPrivate::readCurrentVar(const QString & fileName,
 			if (dataSource != NULL)
 				columnOffset = dataSource->create(dataPointers, mode, actualRows, actualCols);
 
-			double* data = 0;
-			if (dataSource)
-				data = dataPointers[0]->data();
-			else
-				data = (double *)malloc(actualRows * sizeof(double));
-
-			size_t start = startRow-1, count = actualRows;
-			status = nc_get_vara_double(ncid, varid, &start, &count, data);
-			handleError(status, "nc_get_vara_double");
+			if (dataSource) {
+				// the values of a spreadsheet column are stored in chunks, read them block-wise
+				QVector<double> buffer(qMin(actualRows, (int)ChunkedVector<double>::ChunkSize));
+				for (int first = 0; first < actualRows; first += buffer.size()) {
+					size_t start = startRow-1+first, count = qMin(buffer.size(), actualRows-first);
+					status = nc_get_vara_double(ncid, varid, &start, &count, buffer.data());
+					handleError(status, "nc_get_vara_double");
+					dataPointers[0].write(first, count, buffer.constData());
+				}
+			} else {
+				double* data = (double *)malloc(actualRows * sizeof(double));
+				size_t start = startRow-1, count = actualRows;
+				status = nc_get_vara_double(ncid, varid, &start, &count, data);
+				handleError(status, "nc_get_vara_double");
 
-			if (!dataSource) {
 				for (int i = 0; i < qMin(actualRows, lines); i++)
 					dataStrings << (QStringList() << QString::number(data[i]));
 				free(data);
@@ -599,7 +603,7 @@ QList<QStringList> NetCDFFilterPrivate::readCurrentVar(const QString & fileName,
 				QStringList line;
 				for (unsigned int j = 0; j < cols; j++) {
 					if (!dataPointers.isEmpty())
-						dataPointers[j-startColumn+1]->operator[](i-startRow+1) = data[i][j];
+						dataPointers[j-startColumn+1].setValue(i-startRow+1, data[i][j]);
 					else {
 						line << QString::number(static_cast<double>(data[i][j]));
 					}
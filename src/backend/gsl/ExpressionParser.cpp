@@ -29,9 +29,13 @@
 
 #include "backend/lib/macros.h"
 #include "backend/gsl/ExpressionParser.h"
+#include "backend/core/column/Column.h"
+#include "backend/lib/ChunkedVector.h"
 
 #include <klocale.h>
 #include <QDebug>
+#include <QRunnable>
+#include <QThreadPool>
 
 #include <cmath>
 extern "C" {
@@ -44,6 +48,136 @@ extern "C" {
 
 #include <cmath>
 
+namespace {
+//number of rows evaluated with one binding of the variables, values of non-double columns are converted per block
+const int FormulaBlockSize = 4096;
+//minimal number of rows for evaluating a formula in several threads
+const int ParallelFormulaSize = 20000;
+
+/*
+	evaluates a compiled expression block-wise for \c count rows, see eval_expr_block().
+	Non-finite results are replaced by NAN.
+*/
+void evaluateBlock(const parser_expr* expr, const double* const* vars, double* result, int count) {
+	eval_expr_block(expr, vars, result, count);
+	for (int i = 0; i < count; ++i) {
+		if (!std::isfinite(result[i]))
+			result[i] = NAN;
+	}
+}
+
+//evaluates a compiled expression for the rows in [start, end)
+class FormulaTask : public QRunnable {
+	public:
+		FormulaTask(const parser_expr* expr, const QVector<const double*>& data, const QVector<const Column*>& columns,
+				double* result, int offset, int start, int end)
+			: m_expr(expr), m_data(data), m_columns(columns), m_result(result), m_offset(offset), m_start(start), m_end(end) {}
+
+		virtual void run() {
+			const int nvars = m_data.size();
+			QVector<const double*> rows(nvars);
+			QVector<QVector<double> > buffers(nvars);
+
+			for (int first = m_start; first < m_end; first += FormulaBlockSize) {
+				const int count = qMin(FormulaBlockSize, m_end - first);
+
+				//bind the variables to the vectors or to the chunks of double columns containing the whole block,
+				//read the blocks crossing a chunk boundary and the values of the other columns into buffers
+				for (int n = 0; n < nvars; ++n) {
+					if (m_data.at(n)) {
+						rows[n] = m_data.at(n) + first;
+						continue;
+					}
+
+					const Column* column = m_columns.at(n);
+					if (column->columnMode() == AbstractColumn::Numeric) {
+						const ChunkedVector<double>* vector = static_cast<const ChunkedVector<double>*>(column->data());
+						const int chunk = vector->chunkIndex(first);
+						const int offset = first - vector->chunkStart(chunk);
+						if (offset + count <= vector->chunkSize(chunk)) {
+							rows[n] = vector->chunkData(chunk) + offset;
+							continue;
+						}
+					}
+					buffers[n].resize(count);
+					column->valuesAsDouble(first, count, buffers[n].data());
+					rows[n] = buffers.at(n).constData();
+				}
+
+				evaluateBlock(m_expr, rows.constData(), m_result + first - m_offset, count);
+			}
+		}
+
+	private:
+		const parser_expr* m_expr;
+		const QVector<const double*> m_data;
+		const QVector<const Column*> m_columns;
+		double* m_result;
+		int m_offset;
+		int m_start;
+		int m_end;
+};
+
+/*
+	compiles \c expr with the variables \c vars bound to slots, see compile_expr().
+	The other symbols are looked up in \c context or in the default context of the parser if \c context is null.
+	Returns 0 if the expression contains errors.
+*/
+parser_expr* compile(const QString& expr, const QStringList& vars, parser_context* context = 0) {
+	QList<QByteArray> names;
+	QVector<const char*> varNames;
+	for (int n = 0; n < vars.size(); ++n) {
+		names << vars.at(n).toLocal8Bit();
+		varNames << names.last().constData();
+	}
+
+	gsl_set_error_handler_off();
+	const QByteArray str = expr.toLocal8Bit();
+	if (context)
+		return context_compile_expr(context, str.constData(), varNames.constData(), varNames.size());
+	return compile_expr(str.constData(), varNames.constData(), varNames.size());
+}
+
+/*
+	compiles \c expr in \c context with "x" bound to a slot.
+	The parameters are variables of \c context and are constant for all rows evaluated block-wise.
+*/
+parser_expr* compileWithParameters(const QString& expr, const QStringList& paramNames, const QVector<double>& paramValues, parser_context* context) {
+	for (int i = 0; i < paramNames.size(); ++i)
+		context_assign_variable(context, paramNames.at(i).toLocal8Bit().constData(), paramValues.at(i));
+
+	return compile(expr, QStringList("x"), context);
+}
+
+/*
+	compiles \c expr once and evaluates it for the rows \c first to \c last - 1, the result of row \c first is written to result[0].
+	Variable \c n is bound to the values in data[n] or, if data[n] is null, to the values of columns[n].
+	The other symbols are looked up in \c context, see compile().
+	Large row counts are split into one range per thread.
+*/
+bool evaluateRows(const QString& expr, const QStringList& vars, const QVector<const double*>& data,
+		const QVector<const Column*>& columns, double* result, int first, int last, parser_context* context = 0) {
+	parser_expr* compiled = compile(expr, vars, context);
+	if (!compiled)
+		return false;
+
+	//a pool of its own, waiting for the global pool would also wait for unrelated background jobs
+	QThreadPool pool;
+	const int rows = last - first;
+	if (rows < ParallelFormulaSize || pool.maxThreadCount() < 2 || !expr_is_threadsafe(compiled))
+		FormulaTask(compiled, data, columns, result, first, first, last).run();
+	else {
+		const int range = (rows + pool.maxThreadCount() - 1)/pool.maxThreadCount();
+		for (int start = first; start < last; start += range)
+			pool.start(new FormulaTask(compiled, data, columns, result, first, start, qMin(start + range, last)));
+		pool.waitForDone();
+	}
+
+	free_expr(compiled);
+	return true;
+}
+}
+
 ExpressionParser* ExpressionParser::instance = NULL;
 
 ExpressionParser::ExpressionParser() {
@@ -1100,15 +1234,18 @@ const QVector<int>& ExpressionParser::constantsGroupIndices() {
 	return m_constantsGroupIndex;
 }
 
+/*!
+	checks the syntax of \c expr with the variables \c vars.
+	The expression is only compiled in an own parser context and not evaluated,
+	the variables of the shared symbol table are left untouched and it's safe to call this from several threads.
+*/
 bool ExpressionParser::isValid(const QString& expr, const QStringList& vars) {
-	for (int i = 0; i < vars.size(); ++i)
-		assign_variable(vars.at(i).toLocal8Bit().data(), 0);
-
-	QByteArray funcba = expr.toLocal8Bit();
-	const char* data = funcba.data();
-	gsl_set_error_handler_off();
-	parse(data);
-	return !(parse_errors() > 0);
+	parser_context* context = copy_context(0);
+	parser_expr* compiled = compile(expr, vars, context);
+	const bool valid = (compiled != 0);
+	free_expr(compiled);
+	free_context(context);
+	return valid;
 }
 
 QStringList ExpressionParser::getParameter(const QString& expr, const QStringList& vars) {
@@ -1134,106 +1271,51 @@ QStringList ExpressionParser::getParameter(const QString& expr, const QStringLis
 bool ExpressionParser::evaluateCartesian(const QString& expr, const QString& min, const QString& max,
 										 int count, QVector<double>* xVector, QVector<double>* yVector,
 										 const QStringList& paramNames, const QVector<double>& paramValues) {
-	double xMin = parse(min.toLocal8Bit().data());
-	double xMax = parse(max.toLocal8Bit().data());
-	double step = (xMax - xMin)/(double)(count - 1);
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
-	gsl_set_error_handler_off();
-
-	for (int i = 0; i < paramNames.size(); ++i)
-		assign_variable(paramNames.at(i).toLocal8Bit().data(), paramValues.at(i));
-
-	for (int i = 0; i < count; i++) {
-		x = xMin + step * i;
-		assign_variable("x", x);
-		y = parse(func);
+	const double xMin = parse(min.toLocal8Bit().data());
+	const double xMax = parse(max.toLocal8Bit().data());
+	const double step = (xMax - xMin)/(double)(count - 1);
+
+	parser_context* context = copy_context(0);
+	parser_expr* compiled = compileWithParameters(expr, paramNames, paramValues, context);
+	if (!compiled) {
+		free_context(context);
+		return false;
+	}
 
-		if (parse_errors() > 0)
-			return false;
+	for (int i = 0; i < count; i++)
+		(*xVector)[i] = xMin + step * i;
 
-		(*xVector)[i] = x;
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
+	const double* x = xVector->constData();
+	evaluateBlock(compiled, &x, yVector->data(), count);
 
+	free_expr(compiled);
+	free_context(context);
 	return true;
 }
 
 bool ExpressionParser::evaluateCartesian(const QString& expr, const QString& min, const QString& max,
 										 int count, QVector<double>* xVector, QVector<double>* yVector) {
-	double xMin = parse(min.toLocal8Bit().data());
-	double xMax = parse(max.toLocal8Bit().data());
-	double step = (xMax - xMin)/(double)(count - 1);
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
-	gsl_set_error_handler_off();
-
-	for (int i = 0; i < count; i++) {
-		x = xMin + step*i;
-		assign_variable("x", x);
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
-
-		(*xVector)[i] = x;
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
-
-	return true;
+	return evaluateCartesian(expr, min, max, count, xVector, yVector, QStringList(), QVector<double>());
 }
 
 bool ExpressionParser::evaluateCartesian(const QString& expr, QVector<double>* xVector, QVector<double>* yVector) {
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
-	gsl_set_error_handler_off();
-
-	for (int i = 0; i < xVector->count(); i++) {
-		x = xVector->at(i);
-		assign_variable("x", x);
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
-
-	return true;
+	return evaluateCartesian(expr, xVector, yVector, QStringList(), QVector<double>());
 }
 
 bool ExpressionParser::evaluateCartesian(const QString& expr, QVector<double>* xVector, QVector<double>* yVector,
 		const QStringList& paramNames, const QVector<double>& paramValues) {
-	const char* func = expr.toLocal8Bit().data();
-	double x, y;
-	gsl_set_error_handler_off();
-
-	for (int i = 0; i < paramNames.size(); ++i)
-		assign_variable(paramNames.at(i).toLocal8Bit().data(), paramValues.at(i));
-
-	for (int i = 0; i < xVector->count(); i++) {
-		x = xVector->at(i);
-		assign_variable("x", x);
-		y = parse(func);
-
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
+	parser_context* context = copy_context(0);
+	parser_expr* compiled = compileWithParameters(expr, paramNames, paramValues, context);
+	if (!compiled) {
+		free_context(context);
+		return false;
 	}
 
+	const double* x = xVector->constData();
+	evaluateBlock(compiled, &x, yVector->data(), xVector->count());
+
+	free_expr(compiled);
+	free_context(context);
 	return true;
 }
 
@@ -1244,106 +1326,139 @@ bool ExpressionParser::evaluateCartesian(const QString& expr, QVector<double>* x
  */
 bool ExpressionParser::evaluateCartesian(const QString& expr, const QStringList& vars, const QVector<QVector<double>*>& xVectors, QVector<double>* yVector) {
 	Q_ASSERT(vars.size() == xVectors.size());
-	const char* func = expr.toLocal8Bit().data();
-	double y, varValue;
-	QString varName;
 
-	gsl_set_error_handler_off();
+	//stop at the end of the shortest x-vector
+	int rows = yVector->size();
+	QVector<const double*> data;
+	for (int n = 0; n < xVectors.size(); ++n) {
+		rows = qMin(rows, xVectors.at(n)->size());
+		data << xVectors.at(n)->constData();
+	}
 
-	bool stop = false;
-	for (int i = 0; i < yVector->size(); i++) {
-		//stop iterating over i if one of the x-vectors has no elements anymore.
-		for (int n = 0; n < xVectors.size(); ++n) {
-			if (i == xVectors.at(n)->size()) {
-				stop = true;
-				break;
-			}
-		}
-		if (stop)
-			break;
+	return evaluateRows(expr, vars, data, QVector<const Column*>(xVectors.size()), yVector->data(), 0, rows);
+}
 
-		for (int n = 0; n < vars.size(); ++n) {
-			varName = vars.at(n);
-			varValue = xVectors.at(n)->at(i);
-			assign_variable(varName.toLocal8Bit().data(), varValue);
-		}
+/*!
+	evaluates multivariate function y=f(x_1, x_2, ...) for the rows of the columns \c columns.
+	Variable names (x_1, x_2, ...) are stored in \c vars.
+	The expression is compiled once, the variables are bound directly to the chunks of double columns,
+	the values of integer and float columns are converted block-wise. The rows are evaluated in several threads.
+	The rows \c first to \c first + yVector->size() - 1 are evaluated,
+	rows behind the end of the shortest column are not changed in \c yVector.
+ */
+bool ExpressionParser::evaluateColumns(const QString& expr, const QStringList& vars, const QVector<const Column*>& columns,
+		QVector<double>* yVector, int first) {
+	Q_ASSERT(vars.size() == columns.size());
 
-		y = parse(func);
+	int last = first + yVector->size();
+	for (int n = 0; n < columns.size(); ++n)
+		last = qMin(last, columns.at(n)->rowCount());
+	const QVector<const double*> data(columns.size(), 0);
 
-		if (parse_errors() > 0)
-			return false;
+	if (last <= first)
+		return true;
 
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
-	}
+	return evaluateRows(expr, vars, data, columns, yVector->data(), first, last);
+}
 
-	return true;
+/*!
+	evaluates multivariate function y=f(x_1, x_2, ...) for \c count rows, variable \c n is bound to data[n][0..count-1].
+	The expression is compiled in an own parser context, this can be called from a background thread.
+ */
+bool ExpressionParser::evaluateVectors(const QString& expr, const QStringList& vars, const QVector<const double*>& data,
+		double* result, int count) {
+	Q_ASSERT(vars.size() == data.size());
+
+	parser_context* context = copy_context(0);
+	const bool valid = evaluateRows(expr, vars, data, QVector<const Column*>(data.size()), result, 0, count, context);
+	free_context(context);
+	return valid;
 }
 
 bool ExpressionParser::evaluatePolar(const QString& expr, const QString& min, const QString& max,
 										 int count, QVector<double>* xVector, QVector<double>* yVector) {
-	double minValue = parse(min.toLocal8Bit().data());
-	double maxValue = parse(max.toLocal8Bit().data());
-	double step = (maxValue - minValue)/(double)(count - 1);
-	QByteArray funcba = expr.toLocal8Bit();
-	const char* func = funcba.data();
-	double r, phi;
-	gsl_set_error_handler_off();
+	const double minValue = parse(min.toLocal8Bit().data());
+	const double maxValue = parse(max.toLocal8Bit().data());
+	const double step = (maxValue - minValue)/(double)(count - 1);
 
-	for (int i = 0; i < count; i++) {
-		phi = minValue + step * i;
-		assign_variable("phi", phi);
-		r = parse(func);
-		if (parse_errors() > 0)
-			return false;
+	QVector<double> phiVector(count);
+	for (int i = 0; i < count; i++)
+		phiVector[i] = minValue + step * i;
+
+	return evaluatePolar(expr, phiVector, xVector, yVector);
+}
+
+/*!
+	evaluates the polar function r=f(phi) for the angles in \c phiVector.
+	The expression is compiled in an own parser context, this can be called from a background thread.
+ */
+bool ExpressionParser::evaluatePolar(const QString& expr, const QVector<double>& phiVector, QVector<double>* xVector, QVector<double>* yVector) {
+	parser_context* context = copy_context(0);
+	parser_expr* compiled = compile(expr, QStringList("phi"), context);
+	if (!compiled) {
+		free_context(context);
+		return false;
+	}
+
+	const int count = phiVector.size();
+	QVector<double> rVector(count);
+	const double* phi = phiVector.constData();
+	eval_expr_block(compiled, &phi, rVector.data(), count);
 
+	for (int i = 0; i < count; i++) {
+		const double r = rVector.at(i);
 		if (std::isfinite(r)) {
-			(*xVector)[i] = r*cos(phi);
-			(*yVector)[i] = r*sin(phi);
+			(*xVector)[i] = r*cos(phi[i]);
+			(*yVector)[i] = r*sin(phi[i]);
 		} else {
 			(*xVector)[i] = NAN;
 			(*yVector)[i] = NAN;
 		}
 	}
 
+	free_expr(compiled);
+	free_context(context);
 	return true;
 }
 
 bool ExpressionParser::evaluateParametric(const QString& expr1, const QString& expr2, const QString& min, const QString& max,
 										 int count, QVector<double>* xVector, QVector<double>* yVector) {
-	double minValue = parse(min.toLocal8Bit().data());
-	double maxValue = parse(max.toLocal8Bit().data());
-	double step = (maxValue - minValue)/(double)(count - 1);
-	QByteArray xfuncba = expr1.toLocal8Bit();
-	const char* xFunc = xfuncba.data();
-	QByteArray yfuncba = expr2.toLocal8Bit();
-	const char* yFunc = yfuncba.data();
-	double x, y, t;
-	gsl_set_error_handler_off();
+	const double minValue = parse(min.toLocal8Bit().data());
+	const double maxValue = parse(max.toLocal8Bit().data());
+	const double step = (maxValue - minValue)/(double)(count - 1);
 
-	for (int i = 0; i < count; i++) {
-		t = minValue + step*i;
-		assign_variable("t", t);
-		x = parse(xFunc);
-		if (parse_errors() > 0)
-			return false;
-
-		if (std::isfinite(x))
-			(*xVector)[i] = x;
-		else
-			(*xVector)[i] = NAN;
+	QVector<double> tVector(count);
+	for (int i = 0; i < count; i++)
+		tVector[i] = minValue + step*i;
 
-		y = parse(yFunc);
-		if (parse_errors() > 0)
-			return false;
+	return evaluateParametric(expr1, expr2, tVector, xVector, yVector);
+}
 
-		if (std::isfinite(y))
-			(*yVector)[i] = y;
-		else
-			(*yVector)[i] = NAN;
+/*!
+	evaluates the parametric function x=f1(t), y=f2(t) for the parameter values in \c tVector.
+	The expressions are compiled in an own parser context, this can be called from a background thread.
+ */
+bool ExpressionParser::evaluateParametric(const QString& expr1, const QString& expr2, const QVector<double>& tVector,
+		QVector<double>* xVector, QVector<double>* yVector) {
+	parser_context* context = copy_context(0);
+	parser_expr* xCompiled = compile(expr1, QStringList("t"), context);
+	if (!xCompiled) {
+		free_context(context);
+		return false;
+	}
+	parser_expr* yCompiled = compile(expr2, QStringList("t"), context);
+	if (!yCompiled) {
+		free_expr(xCompiled);
+		free_context(context);
+		return false;
 	}
 
+	const double* t = tVector.constData();
+	evaluateBlock(xCompiled, &t, xVector->data(), tVector.size());
+	evaluateBlock(yCompiled, &t, yVector->data(), tVector.size());
+
+	free_expr(xCompiled);
+	free_expr(yCompiled);
+	free_context(context);
 	return true;
 }
@@ -32,6 +32,8 @@
 #include <QVector>
 #include <QStringList>
 
+class Column;
+
 class ExpressionParser {
 
 public:
@@ -48,10 +50,17 @@ public:
 	bool evaluateCartesian(const QString& expr, QVector<double>* xVector, QVector<double>* yVector,
 					const QStringList& paramNames, const QVector<double>& paramValues);
 	bool evaluateCartesian(const QString& expr, const QStringList& vars, const QVector<QVector<double>*>& xVectors, QVector<double>* yVector);
+	bool evaluateColumns(const QString& expr, const QStringList& vars, const QVector<const Column*>& columns,
+					QVector<double>* yVector, int first = 0);
+	bool evaluateVectors(const QString& expr, const QStringList& vars, const QVector<const double*>& data,
+					double* result, int count);
 	bool evaluatePolar(const QString& expr, const QString& min, const QString& max,
 					int count, QVector<double>* xVector, QVector<double>* yVector);
+	bool evaluatePolar(const QString& expr, const QVector<double>& phiVector, QVector<double>* xVector, QVector<double>* yVector);
 	bool evaluateParametric(const QString& expr1, const QString& expr2, const QString& min, const QString& max,
 					int count, QVector<double>* xVector, QVector<double>* yVector);
+	bool evaluateParametric(const QString& expr1, const QString& expr2, const QVector<double>& tVector,
+					QVector<double>* xVector, QVector<double>* yVector);
 
 	const QStringList& functions();
 	const QStringList& functionsGroups();
@@ -63,13 +63,36 @@ typedef struct symrec {
 	struct symrec *next;	/* next field */
 } symrec;
 
-void init_table();	/* initialize symbol table */
-void delete_table();	/* delete symbol table */
+/* compiled expression, see compile_expr() */
+typedef struct parser_node parser_node;
+typedef struct parser_expr parser_expr;
+
+/* variables of one user (thread), see create_context() */
+typedef struct parser_context parser_context;
+
+void init_table();	/* initialize built-in symbols and default context */
+void delete_table();	/* delete built-in symbols and default context */
 int parse_errors();
 symrec* assign_variable(const char* symb_name, double value);
-/*new style: symrec* assign_variable(symrec *sym_table, parser_var var);*/
+double* bind_variable(const char* symb_name);
 double parse(const char *str);
 double parse_with_vars(const char[], const parser_var[], int nvars);
+parser_expr* compile_expr(const char *str, const char * const *vars, int nvars);
+parser_expr* compile_derivative(const char *str, const char * const *vars, int nvars, const char *name);
+
+parser_context* create_context();
+parser_context* copy_context(const parser_context *context);
+void free_context(parser_context *context);
+int context_parse_errors(const parser_context *context);
+symrec* context_assign_variable(parser_context *context, const char* symb_name, double value);
+double* context_bind_variable(parser_context *context, const char* symb_name);
+double context_parse(parser_context *context, const char *str);
+parser_expr* context_compile_expr(parser_context *context, const char *str, const char * const *vars, int nvars);
+parser_expr* context_compile_derivative(parser_context *context, const char *str, const char * const *vars, int nvars, const char *name);
+double eval_expr(const parser_expr *expr, double *vars);
+void eval_expr_block(const parser_expr *expr, const double * const *vars, double *result, int n);
+int expr_is_threadsafe(const parser_expr *expr);
+void free_expr(parser_expr *expr);
 
 extern struct con _constants[];
 extern struct func _functions[];
@@ -31,6 +31,8 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <float.h>
 #include <locale.h>
 #ifndef HAVE_WINDOWS
 #include <xlocale.h>
@@ -47,30 +49,94 @@
 
 #define YYERROR_VERBOSE 1
 
+/* variables of a parser context, see create_context() */
+struct parser_context {
+	symrec *variables;	/* searched before the built-in functions and constants */
+	int errors;	/* number of errors of the last parse */
+};
+
 /* params passed to yylex (and yyerror) */
 typedef struct param {
 	unsigned int pos;	/* current position in string */
 	char *string;		/* the string to parse */
-/*	symrec *sym_table;	the symbol table (not used) */
+	parser_context *context;	/* the context whose variables are used */
+	char *symbuf;		/* buffer for reading identifiers */
+	int length;		/* size of symbuf */
+	int errors;		/* number of parse errors */
+	parser_node *result;	/* tree of the last parsed line */
+	int assigns_symbol;	/* the tree assigns a variable of the context */
+	const char * const *bound_vars;	/* variables bound to slots by compile_expr() */
+	int nbound_vars;
 } param;
 
 int yyerror(param *p, const char *err);
-int yylex(param *p);
 
-double res;
+/* node of a compiled expression */
+enum { NODE_NUM = 256, NODE_VAR, NODE_SLOT, NODE_ASSIGN, NODE_FNCT, NODE_NEG };
+struct parser_node {
+	int type;	/* NODE_* or the operator '+', '-', '*', '/', '^' */
+	double value;	/* value of a NODE_NUM */
+	symrec *sym;	/* variable of a NODE_VAR or NODE_ASSIGN, function of a NODE_FNCT */
+	int slot;	/* bound variable of a NODE_SLOT or NODE_ASSIGN */
+	int nargs;	/* number of arguments (operands) */
+	struct parser_node *args[4];
+};
+
+/* instruction of the stack machine evaluating a compiled expression */
+enum { OP_CONST, OP_SLOT, OP_VAR, OP_STORE_SLOT, OP_STORE_VAR, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_NEG,
+	OP_CALL0, OP_CALL1, OP_CALL2, OP_CALL3, OP_CALL4, OP_EXP, OP_LOG, OP_SIN, OP_COS };
+typedef struct parser_instr {
+	int op;
+	union {
+		double value;	/* OP_CONST */
+		int slot;	/* OP_SLOT, OP_STORE_SLOT */
+		double *var;	/* OP_VAR, OP_STORE_VAR */
+		func_t fnct;	/* OP_CALL*, OP_EXP, OP_LOG, OP_SIN, OP_COS */
+	} arg;
+} parser_instr;
+
+/* stack size available without allocating memory in eval_expr() */
+#define EVAL_STACK_SIZE 64
+/* number of rows evaluated at once by eval_expr_block() and blocks on its stack without allocating memory */
+#define EVAL_BLOCK_SIZE 256
+#define EVAL_BLOCK_STACK_SIZE 8
+
+struct parser_expr {
+	parser_instr *code;
+	int length;	/* number of instructions */
+	int depth;	/* maximal stack depth */
+	int threadsafe;	/* no assignments to variables of the symbol table */
+	int nvars;	/* number of bound variables */
+	int blockwise;	/* no assignments at all, rows can be evaluated block by block */
+};
+
+static parser_node* new_node(int type, int nargs, parser_node *a, parser_node *b, parser_node *c, parser_node *d);
+static symrec* putsym(parser_context *context, const char *sym_name, int sym_type);
+static int is_builtin(const symrec *sym);
+static void free_node(parser_node *node);
 %}
 
+%define api.pure full
 %lex-param {param *p}
 %parse-param {param *p}
 
 %union {
 double dval;	/* For returning numbers */
 symrec *tptr;   /* For returning symbol-table pointers */
+int ival;	/* For returning slots of bound variables */
+parser_node *nptr;	/* For returning nodes of the expression tree */
 }
 
 %token <dval>  NUM 	/* Simple double precision number */
 %token <tptr> VAR FNCT	/* VARiable and FuNCTion */
-%type  <dval>  expr
+%token <ival> SLOT	/* variable bound to a slot by compile_expr() */
+%type  <nptr>  expr
+
+%destructor { free_node($$); } expr
+
+%{
+int yylex(YYSTYPE *yylval, param *p);
+%}
 
 %right '='
 %left '-' '+'
@@ -84,46 +150,71 @@ input:   /* empty */
 ;
 
 line:	'\n'
-	| expr '\n'   { res=$1; }
+	| expr '\n'   { free_node(p->result); p->result=$1; }
 	| error '\n' { yyerrok; }
 ;
 
-expr:      NUM       { $$ = $1;                         }
-| VAR                { $$ = $1->value.var;              }
-| VAR '=' expr       { $$ = $3; $1->value.var = $3;     }
-| FNCT '(' ')'       { $$ = (*($1->value.fnctptr))();   }
-| FNCT '(' expr ')'  { $$ = (*($1->value.fnctptr))($3); }
-| FNCT '(' expr ',' expr ')'  { $$ = (*($1->value.fnctptr))($3,$5); }
-| FNCT '(' expr ',' expr ','expr ')'  { $$ = (*($1->value.fnctptr))($3,$5,$7); }
-| FNCT '(' expr ',' expr ',' expr ','expr ')'  { $$ = (*($1->value.fnctptr))($3,$5,$7,$9); }
-| expr '+' expr      { $$ = $1 + $3;                    }
-| expr '-' expr      { $$ = $1 - $3;                    }
-| expr '*' expr      { $$ = $1 * $3;                    }
-| expr '/' expr      { $$ = $1 / $3;                    }
-| '-' expr  %prec NEG{ $$ = -$2;                        }
-| expr '^' expr      { $$ = pow ($1, $3);               }
-| expr '*' '*' expr  { $$ = pow ($1, $4);               }
+expr:      NUM       { $$ = new_node(NODE_NUM, 0, 0, 0, 0, 0); $$->value = $1; }
+| VAR                { $$ = new_node(NODE_VAR, 0, 0, 0, 0, 0); $$->sym = $1; }
+| SLOT               { $$ = new_node(NODE_SLOT, 0, 0, 0, 0, 0); $$->slot = $1; }
+| VAR '=' expr       { $$ = new_node(NODE_ASSIGN, 1, $3, 0, 0, 0); p->assigns_symbol = 1;
+			/* a built-in constant is shadowed by a variable of the context like in context_assign_variable() */
+			if (is_builtin($1)) {
+				symrec *var = putsym(p->context, $1->name, VAR);
+				var->value.var = $1->value.var;
+				$$->sym = var;
+			} else
+				$$->sym = $1;
+		}
+| SLOT '=' expr      { $$ = new_node(NODE_ASSIGN, 1, $3, 0, 0, 0); $$->slot = $1; }
+| FNCT '(' ')'       { $$ = new_node(NODE_FNCT, 0, 0, 0, 0, 0); $$->sym = $1; }
+| FNCT '(' expr ')'  { $$ = new_node(NODE_FNCT, 1, $3, 0, 0, 0); $$->sym = $1; }
+| FNCT '(' expr ',' expr ')'  { $$ = new_node(NODE_FNCT, 2, $3, $5, 0, 0); $$->sym = $1; }
+| FNCT '(' expr ',' expr ','expr ')'  { $$ = new_node(NODE_FNCT, 3, $3, $5, $7, 0); $$->sym = $1; }
+| FNCT '(' expr ',' expr ',' expr ','expr ')'  { $$ = new_node(NODE_FNCT, 4, $3, $5, $7, $9); $$->sym = $1; }
+| expr '+' expr      { $$ = new_node('+', 2, $1, $3, 0, 0); }
+| expr '-' expr      { $$ = new_node('-', 2, $1, $3, 0, 0); }
+| expr '*' expr      { $$ = new_node('*', 2, $1, $3, 0, 0); }
+| expr '/' expr      { $$ = new_node('/', 2, $1, $3, 0, 0); }
+| '-' expr  %prec NEG{ $$ = new_node(NODE_NEG, 1, $2, 0, 0, 0); }
+| expr '^' expr      { $$ = new_node('^', 2, $1, $3, 0, 0); }
+| expr '*' '*' expr  { $$ = new_node('^', 2, $1, $4, 0, 0); }
 | '(' expr ')'       { $$ = $2;                         }
 ;
 
 %%
 
-/* global symbol table */
-symrec *sym_table = 0;
+/*
+ * built-in functions and constants, shared by all contexts.
+ * They are stored in one array and never changed after init_table().
+ */
+static symrec *builtins = 0;
+static int nbuiltins = 0;
+/* open addressing hash table of the built-in symbols: index into builtins + 1, 0 marks an empty entry */
+static int *builtin_hash = 0;
+static unsigned int builtin_hash_mask = 0;
+#if !defined(_WIN32) && !defined(__APPLE__)
+/* use same locale for all languages: '.' as decimal point */
+static locale_t c_locale;
+#endif
+
+/* context used by the functions without context parameter */
+static parser_context *default_context = 0;
 
 int parse_errors() {
-	return yynerrs;
+	return default_context ? default_context->errors : 0;
 }
 
 int yyerror(param *p, const char *s) {
+	p->errors++;
 	/* remove trailing newline */
 	p->string[strcspn(p->string, "\n")] = 0;
 	printf("PARSER ERROR: %s @ position %d of string \'%s\'\n", s, p->pos, p->string);
 	return 0;
 }
 
-/* save symbol in symbol table */
-symrec* putsym(const char *sym_name, int sym_type) {
+/* save symbol in the symbol table of a context */
+static symrec* putsym(parser_context *context, const char *sym_name, int sym_type) {
 	pdebug("PARSER: putsym(): sym_name = %s\n", sym_name);
 
 	symrec *ptr = (symrec *) malloc(sizeof (symrec));
@@ -131,75 +222,222 @@ symrec* putsym(const char *sym_name, int sym_type) {
 	strcpy(ptr->name, sym_name);
 	ptr->type = sym_type;
 	ptr->value.var = 0;	/* set value to 0 even if fctn */
-	ptr->next = (struct symrec *)sym_table;
-	sym_table = ptr;
-	
+	ptr->next = context->variables;
+	context->variables = ptr;
+
 	pdebug("PARSER: putsym() DONE\n");
 	return ptr;
 }
 
-/* get symbol from symbol table */
-symrec* getsym(const char *sym_name) {
+/* FNV-1a hash of a symbol name */
+static unsigned int hash_name(const char *name) {
+	unsigned int hash = 2166136261u;
+	for (; *name != '\0'; name++)
+		hash = (hash ^ (unsigned char)*name) * 16777619u;
+	return hash;
+}
+
+/* adds builtins[index] to the hash table, an earlier built-in symbol with the same name is replaced */
+static void hash_builtin(int index) {
+	unsigned int i = hash_name(builtins[index].name) & builtin_hash_mask;
+	while (builtin_hash[i] != 0 && strcmp(builtins[builtin_hash[i] - 1].name, builtins[index].name) != 0)
+		i = (i + 1) & builtin_hash_mask;
+	builtin_hash[i] = index + 1;
+}
+
+/* get built-in function or constant */
+static symrec* find_builtin(const char *sym_name) {
+	unsigned int i;
+	for (i = hash_name(sym_name) & builtin_hash_mask; builtin_hash[i] != 0; i = (i + 1) & builtin_hash_mask) {
+		if (strcmp(builtins[builtin_hash[i] - 1].name, sym_name) == 0) {
+			pdebug("PARSER: built-in symbol \'%s\' found\n", sym_name);
+			return &builtins[builtin_hash[i] - 1];
+		}
+	}
+	return 0;
+}
+
+/* get symbol from the symbol table of a context or from the built-in symbols */
+static symrec* getsym(const parser_context *context, const char *sym_name) {
 	pdebug("PARSER: getsym(): sym_name = %s\n", sym_name);
-	
+
 	symrec *ptr;
-	for (ptr = sym_table; ptr != 0; ptr = (symrec *)ptr->next) {
-		/* pdebug("%s ", ptr->name); */
+	for (ptr = context->variables; ptr != 0; ptr = ptr->next) {
 		if (strcmp(ptr->name, sym_name) == 0) {
-			pdebug("PARSER: symbol \'%s\' found\n", sym_name);
+			pdebug("PARSER: variable \'%s\' found\n", sym_name);
 			return ptr;
 		}
 	}
+	ptr = find_builtin(sym_name);
+	if (ptr)
+		return ptr;
 
 	pdebug("PARSER: symbol \'%s\' not found\n", sym_name);
 	return 0;
 }
 
+/* returns 1 if sym is a built-in function or constant */
+static int is_builtin(const symrec *sym) {
+	return sym >= builtins && sym < builtins + nbuiltins;
+}
+
+/*
+ * initializes the built-in symbols and the default context.
+ * Has to be called once before contexts are used in several threads.
+ */
 void init_table(void) {
 	pdebug("PARSER: init_table()\n");
 
-	symrec *ptr = 0;
-	int i;
-	/* add functions */
-	for (i = 0; _functions[i].name != 0; i++) {
-		ptr = putsym (_functions[i].name, FNCT);
-		ptr->value.fnctptr = _functions[i].fnct;
-	}
-	/* add constants */
-	for (i = 0; _constants[i].name != 0; i++) {
-		ptr = putsym (_constants[i].name, VAR);
-		ptr->value.var = _constants[i].value;
+	if (!builtins) {
+		int nfunctions = 0, nconstants = 0, i;
+		while (_functions[nfunctions].name != 0)
+			nfunctions++;
+		while (_constants[nconstants].name != 0)
+			nconstants++;
+
+		builtins = (symrec *) malloc((nfunctions + nconstants) * sizeof(symrec));
+		for (i = 0; i < nfunctions; i++) {
+			builtins[i].name = (char *) _functions[i].name;
+			builtins[i].type = FNCT;
+			builtins[i].value.fnctptr = _functions[i].fnct;
+			builtins[i].next = 0;
+		}
+		for (i = 0; i < nconstants; i++) {
+			builtins[nfunctions + i].name = (char *) _constants[i].name;
+			builtins[nfunctions + i].type = VAR;
+			builtins[nfunctions + i].value.var = _constants[i].value;
+			builtins[nfunctions + i].next = 0;
+		}
+		nbuiltins = nfunctions + nconstants;
+
+		/* keep the load factor of the hash table below 1/2 */
+		unsigned int size = 16;
+		while (size < 2 * (unsigned int)nbuiltins)
+			size *= 2;
+		builtin_hash = (int *) calloc(size, sizeof(int));
+		builtin_hash_mask = size - 1;
+		/* as in the former symbol list, later entries hide earlier ones and constants hide functions */
+		for (i = 0; i < nbuiltins; i++)
+			hash_builtin(i);
+#if !defined(_WIN32) && !defined(__APPLE__)
+		c_locale = newlocale(LC_NUMERIC_MASK, "C", NULL);
+#endif
 	}
 
-	pdebug("PARSER: init_table() DONE sym_table = %p\n", ptr);
+	if (!default_context)
+		default_context = create_context();
+
+	pdebug("PARSER: init_table() DONE\n");
 }
 
 void delete_table(void) {
-	while(sym_table) {
-		symrec *tmp = sym_table;
-		sym_table = sym_table->next;
+	free_context(default_context);
+	default_context = 0;
+	free(builtins);
+	builtins = 0;
+	nbuiltins = 0;
+	free(builtin_hash);
+	builtin_hash = 0;
+	builtin_hash_mask = 0;
+#if !defined(_WIN32) && !defined(__APPLE__)
+	freelocale(c_locale);
+#endif
+}
+
+/*
+ * creates a context with an own symbol table for the variables.
+ * Functions and constants are shared with all other contexts.
+ * Different contexts can be used in different threads at the same time.
+ */
+parser_context* create_context(void) {
+	if (!builtins)
+		init_table();
+
+	parser_context *context = (parser_context *) malloc(sizeof(parser_context));
+	context->variables = 0;
+	context->errors = 0;
+	return context;
+}
+
+/* creates a context with copies of the variables of context (of the default context if context is 0) */
+parser_context* copy_context(const parser_context *context) {
+	if (!context) {
+		if (!default_context)
+			init_table();
+		context = default_context;
+	}
+
+	parser_context *copy = create_context();
+	symrec *ptr;
+	for (ptr = context->variables; ptr != 0; ptr = ptr->next) {
+		/* variable names are unique within a context, the order does not matter */
+		putsym(copy, ptr->name, ptr->type)->value = ptr->value;
+	}
+	return copy;
+}
+
+void free_context(parser_context *context) {
+	if (!context)
+		return;
+	while (context->variables) {
+		symrec *tmp = context->variables;
+		context->variables = tmp->next;
 		free(tmp->name);
 		free(tmp);
 	}
+	free(context);
 }
 
-symrec* assign_variable(const char* symb_name, double value) {
-	/* new style: pdebug("PARSER: assign_variable(): symb_name = %s value = %g sym_table = %p\n", var.name, var.value, sym_table);*/
-	pdebug("PARSER: assign_variable() : symb_name = %s value=%g\n", symb_name, value);
+/* returns the number of errors of the last parse in context */
+int context_parse_errors(const parser_context *context) {
+	return context->errors;
+}
 
-	/* be sure that the symbol table has been initialized */
-	if (!sym_table)
-		init_table();
+/*
+ * sets the variable symb_name of context to value, the variable is added if not present yet.
+ * Variables hide built-in constants with the same name.
+ */
+symrec* context_assign_variable(parser_context *context, const char* symb_name, double value) {
+	pdebug("PARSER: assign_variable() : symb_name = %s value=%g\n", symb_name, value);
 
-	symrec* ptr = getsym(symb_name);
-	if (!ptr) {
+	symrec* ptr = getsym(context, symb_name);
+	if (!ptr || is_builtin(ptr)) {
 		pdebug("PARSER: calling putsym(): symb_name = %s\n", symb_name);
-		ptr = putsym(symb_name, VAR);
+		ptr = putsym(context, symb_name, VAR);
 	}
 	ptr->value.var = value;
 
 	return ptr;
-};
+}
+
+/*
+ * returns a handle to the value of the variable symb_name of context, the variable is added if not present yet.
+ * The handle stays valid until the context is freed. Setting a variable through it
+ * in a loop avoids the lookup by name done in context_assign_variable().
+ */
+double* context_bind_variable(parser_context *context, const char* symb_name) {
+	symrec* ptr = getsym(context, symb_name);
+	if (!ptr || is_builtin(ptr))
+		ptr = putsym(context, symb_name, VAR);
+
+	return &ptr->value.var;
+}
+
+double* bind_variable(const char* symb_name) {
+	/* be sure that the symbol table has been initialized */
+	if (!default_context)
+		init_table();
+
+	return context_bind_variable(default_context, symb_name);
+}
+
+symrec* assign_variable(const char* symb_name, double value) {
+	/* be sure that the symbol table has been initialized */
+	if (!default_context)
+		init_table();
+
+	return context_assign_variable(default_context, symb_name, value);
+}
 
 static int getcharstr(param *p) {
 	pdebug("PARSER: getcharstr() pos = %d\n", p->pos);
@@ -215,13 +453,378 @@ static void ungetcstr(unsigned int *pos) {
         (*pos)--;
 }
 
-double parse(const char *str) {
-	pdebug("\nPARSER: parse(\"%s\") len=%zu\n", str, strlen(str));
+static parser_node* new_node(int type, int nargs, parser_node *a, parser_node *b, parser_node *c, parser_node *d) {
+	parser_node *node = (parser_node *) malloc(sizeof(parser_node));
+	node->type = type;
+	node->value = 0;
+	node->sym = 0;
+	node->slot = -1;
+	node->nargs = nargs;
+	node->args[0] = a;
+	node->args[1] = b;
+	node->args[2] = c;
+	node->args[3] = d;
+	return node;
+}
 
-	/* be sure that the symbol table has been initialized */
-	if (!sym_table)
-		init_table();
+static void free_node(parser_node *node) {
+	int i;
+	if (!node)
+		return;
+	for (i = 0; i < node->nargs; i++)
+		free_node(node->args[i]);
+	free(node);
+}
+
+static double apply_op(int type, double a, double b) {
+	switch (type) {
+	case '+':
+		return a + b;
+	case '-':
+		return a - b;
+	case '*':
+		return a * b;
+	case '/':
+		return a / b;
+	case '^':
+		return pow(a, b);
+	default:	/* NODE_NEG */
+		return -a;
+	}
+}
+
+/*
+ * replaces constant subexpressions by their values.
+ * Functions without arguments (rand(), random() and drand()) are not constant.
+ */
+static void fold_node(parser_node *node) {
+	int i, constant = 1;
+	for (i = 0; i < node->nargs; i++) {
+		fold_node(node->args[i]);
+		if (node->args[i]->type != NODE_NUM)
+			constant = 0;
+	}
+
+	double a = node->nargs > 0 ? node->args[0]->value : 0;
+	double b = node->nargs > 1 ? node->args[1]->value : 0;
+	double c = node->nargs > 2 ? node->args[2]->value : 0;
+	double d = node->nargs > 3 ? node->args[3]->value : 0;
+	switch (node->type) {
+	case NODE_NUM:
+	case NODE_SLOT:
+	case NODE_ASSIGN:
+		return;
+	case NODE_VAR:
+		if (!is_builtin(node->sym))
+			return;
+		node->value = node->sym->value.var;
+		break;
+	case NODE_FNCT:
+		if (!constant || node->nargs == 0)
+			return;
+		switch (node->nargs) {
+		case 1:
+			node->value = (*(node->sym->value.fnctptr))(a);
+			break;
+		case 2:
+			node->value = (*(node->sym->value.fnctptr))(a, b);
+			break;
+		case 3:
+			node->value = (*(node->sym->value.fnctptr))(a, b, c);
+			break;
+		default:
+			node->value = (*(node->sym->value.fnctptr))(a, b, c, d);
+		}
+		break;
+	default:
+		if (!constant)
+			return;
+		node->value = apply_op(node->type, a, b);
+	}
+
+	for (i = 0; i < node->nargs; i++)
+		free_node(node->args[i]);
+	node->type = NODE_NUM;
+	node->nargs = 0;
+	node->sym = 0;
+}
+
+/* returns the number of instructions needed for node */
+static int count_instr(const parser_node *node) {
+	int i, n = 1;
+	for (i = 0; i < node->nargs; i++)
+		n += count_instr(node->args[i]);
+	return n;
+}
+
+/* appends the instructions of node in postfix order, returns the stack depth needed */
+static int emit_node(const parser_node *node, parser_expr *expr) {
+	int i, depth = 0;
+	/* the arguments are evaluated from left to right like the grammar does */
+	for (i = 0; i < node->nargs; i++) {
+		int d = i + emit_node(node->args[i], expr);
+		if (d > depth)
+			depth = d;
+	}
+
+	parser_instr *instr = &expr->code[expr->length++];
+	switch (node->type) {
+	case NODE_NUM:
+		instr->op = OP_CONST;
+		instr->arg.value = node->value;
+		return 1;
+	case NODE_SLOT:
+		instr->op = OP_SLOT;
+		instr->arg.slot = node->slot;
+		return 1;
+	case NODE_VAR:
+		instr->op = OP_VAR;
+		instr->arg.var = &node->sym->value.var;
+		return 1;
+	case NODE_ASSIGN:
+		if (node->sym) {
+			instr->op = OP_STORE_VAR;
+			instr->arg.var = &node->sym->value.var;
+		} else {
+			instr->op = OP_STORE_SLOT;
+			instr->arg.slot = node->slot;
+		}
+		return depth;
+	case NODE_FNCT:
+		instr->op = OP_CALL0 + node->nargs;
+		instr->arg.fnct = node->sym->value.fnctptr;
+		/* functions with a vectorized kernel in eval_block() */
+		if (instr->arg.fnct == (func_t) gsl_sf_exp)
+			instr->op = OP_EXP;
+		else if (instr->arg.fnct == (func_t) gsl_sf_log)
+			instr->op = OP_LOG;
+		else if (instr->arg.fnct == (func_t) gsl_sf_sin)
+			instr->op = OP_SIN;
+		else if (instr->arg.fnct == (func_t) gsl_sf_cos)
+			instr->op = OP_COS;
+		return depth > 1 ? depth : 1;
+	case NODE_NEG:
+		instr->op = OP_NEG;
+		return depth;
+	case '+':
+		instr->op = OP_ADD;
+		break;
+	case '-':
+		instr->op = OP_SUB;
+		break;
+	case '*':
+		instr->op = OP_MUL;
+		break;
+	case '/':
+		instr->op = OP_DIV;
+		break;
+	default:
+		instr->op = OP_POW;
+	}
+	return depth;
+}
+
+/*
+ * helpers building the tree of a derivative.
+ * They take the ownership of their arguments and drop terms that are 0 or factors that are 1.
+ */
+static parser_node* num_node(double value) {
+	parser_node *node = new_node(NODE_NUM, 0, 0, 0, 0, 0);
+	node->value = value;
+	return node;
+}
+
+static int is_num(const parser_node *node, double value) {
+	return node->type == NODE_NUM && node->value == value;
+}
+
+static parser_node* copy_node(const parser_node *node) {
+	parser_node *copy = new_node(node->type, node->nargs, 0, 0, 0, 0);
+	int i;
+	copy->value = node->value;
+	copy->sym = node->sym;
+	copy->slot = node->slot;
+	for (i = 0; i < node->nargs; i++)
+		copy->args[i] = copy_node(node->args[i]);
+	return copy;
+}
+
+static parser_node* op_node(int type, parser_node *a, parser_node *b) {
+	switch (type) {
+	case '+':
+		if (is_num(a, 0)) {
+			free_node(a);
+			return b;
+		}
+		if (is_num(b, 0)) {
+			free_node(b);
+			return a;
+		}
+		break;
+	case '-':
+		if (is_num(b, 0)) {
+			free_node(b);
+			return a;
+		}
+		if (is_num(a, 0)) {
+			free_node(a);
+			return new_node(NODE_NEG, 1, b, 0, 0, 0);
+		}
+		break;
+	case '*':
+		if (is_num(a, 0) || is_num(b, 0)) {
+			free_node(a);
+			free_node(b);
+			return num_node(0);
+		}
+		if (is_num(a, 1)) {
+			free_node(a);
+			return b;
+		}
+		if (is_num(b, 1)) {
+			free_node(b);
+			return a;
+		}
+		break;
+	case '/':
+		if (is_num(a, 0)) {
+			free_node(a);
+			free_node(b);
+			return num_node(0);
+		}
+		if (is_num(b, 1)) {
+			free_node(b);
+			return a;
+		}
+		break;
+	}
+	return new_node(type, 2, a, b, 0, 0);
+}
 
+static parser_node* fnct_node(const char *name, parser_node *a) {
+	parser_node *node = new_node(NODE_FNCT, 1, a, 0, 0, 0);
+	node->sym = find_builtin(name);
+	return node;
+}
+
+/* returns f'(u) for the built-in function name or 0 if its derivative is not known */
+static parser_node* diff_function(const char *name, const parser_node *u) {
+	if (strcmp(name, "sin") == 0)
+		return fnct_node("cos", copy_node(u));
+	if (strcmp(name, "cos") == 0)
+		return new_node(NODE_NEG, 1, fnct_node("sin", copy_node(u)), 0, 0, 0);
+	if (strcmp(name, "tan") == 0)
+		return op_node('/', num_node(1), op_node('^', fnct_node("cos", copy_node(u)), num_node(2)));
+	if (strcmp(name, "exp") == 0)
+		return fnct_node("exp", copy_node(u));
+	if (strcmp(name, "log") == 0 || strcmp(name, "ln") == 0)
+		return op_node('/', num_node(1), copy_node(u));
+	if (strcmp(name, "log10") == 0)
+		return op_node('/', num_node(1), op_node('*', copy_node(u), num_node(log(10.))));
+	if (strcmp(name, "sqrt") == 0)
+		return op_node('/', num_node(0.5), fnct_node("sqrt", copy_node(u)));
+	if (strcmp(name, "sinh") == 0)
+		return fnct_node("cosh", copy_node(u));
+	if (strcmp(name, "cosh") == 0)
+		return fnct_node("sinh", copy_node(u));
+	if (strcmp(name, "tanh") == 0)
+		return op_node('/', num_node(1), op_node('^', fnct_node("cosh", copy_node(u)), num_node(2)));
+	if (strcmp(name, "asin") == 0)
+		return op_node('/', num_node(1), fnct_node("sqrt", op_node('-', num_node(1), op_node('^', copy_node(u), num_node(2)))));
+	if (strcmp(name, "acos") == 0)
+		return op_node('/', num_node(-1), fnct_node("sqrt", op_node('-', num_node(1), op_node('^', copy_node(u), num_node(2)))));
+	if (strcmp(name, "atan") == 0)
+		return op_node('/', num_node(1), op_node('+', num_node(1), op_node('^', copy_node(u), num_node(2))));
+	return 0;
+}
+
+static parser_node* diff_node(const parser_node *node, int slot, const symrec *sym, int *error);
+
+/* derivative of a^b */
+static parser_node* diff_pow(const parser_node *a, const parser_node *b, int slot, const symrec *sym, int *error) {
+	parser_node *da = diff_node(a, slot, sym, error);
+	parser_node *db = diff_node(b, slot, sym, error);
+
+	/* constant exponent: b*a^(b-1)*a' */
+	if (is_num(db, 0)) {
+		free_node(db);
+		return op_node('*', op_node('*', copy_node(b), op_node('^', copy_node(a), op_node('-', copy_node(b), num_node(1)))), da);
+	}
+
+	/* a^b*(b'*log(a) + b*a'/a) */
+	return op_node('*', op_node('^', copy_node(a), copy_node(b)),
+		op_node('+', op_node('*', db, fnct_node("log", copy_node(a))), op_node('/', op_node('*', copy_node(b), da), copy_node(a))));
+}
+
+/*
+ * returns the derivative of node with respect to the bound variable slot or the variable sym.
+ * error is set if the node contains assignments or functions whose derivative is not known.
+ */
+static parser_node* diff_node(const parser_node *node, int slot, const symrec *sym, int *error) {
+	parser_node *da, *db, *fprime;
+	int i, constant = 1;
+
+	switch (node->type) {
+	case NODE_NUM:
+		return num_node(0);
+	case NODE_VAR:
+		return num_node(sym != 0 && node->sym == sym ? 1 : 0);
+	case NODE_SLOT:
+		return num_node(slot >= 0 && node->slot == slot ? 1 : 0);
+	case NODE_ASSIGN:
+		*error = 1;
+		return num_node(0);
+	case NODE_NEG:
+		da = diff_node(node->args[0], slot, sym, error);
+		return is_num(da, 0) ? da : new_node(NODE_NEG, 1, da, 0, 0, 0);
+	case '+':
+	case '-':
+		da = diff_node(node->args[0], slot, sym, error);
+		db = diff_node(node->args[1], slot, sym, error);
+		return op_node(node->type, da, db);
+	case '*':
+		da = diff_node(node->args[0], slot, sym, error);
+		db = diff_node(node->args[1], slot, sym, error);
+		return op_node('+', op_node('*', da, copy_node(node->args[1])), op_node('*', copy_node(node->args[0]), db));
+	case '/':
+		/* a'/b - a*b'/b^2 */
+		da = diff_node(node->args[0], slot, sym, error);
+		db = diff_node(node->args[1], slot, sym, error);
+		return op_node('-', op_node('/', da, copy_node(node->args[1])),
+			op_node('/', op_node('*', copy_node(node->args[0]), db), op_node('^', copy_node(node->args[1]), num_node(2))));
+	case '^':
+		return diff_pow(node->args[0], node->args[1], slot, sym, error);
+	case NODE_FNCT:
+		/* functions of arguments not depending on the variable are constant */
+		for (i = 0; i < node->nargs; i++) {
+			da = diff_node(node->args[i], slot, sym, error);
+			if (!is_num(da, 0))
+				constant = 0;
+			free_node(da);
+		}
+		if (constant)
+			return num_node(0);
+
+		if (node->nargs == 2 && strcmp(node->sym->name, "pow") == 0)
+			return diff_pow(node->args[0], node->args[1], slot, sym, error);
+		fprime = node->nargs == 1 ? diff_function(node->sym->name, node->args[0]) : 0;
+		if (!fprime) {
+			pdebug("PARSER: derivative of %s() not known\n", node->sym->name);
+			*error = 1;
+			return num_node(0);
+		}
+		return op_node('*', fprime, diff_node(node->args[0], slot, sym, error));
+	}
+
+	*error = 1;
+	return num_node(0);
+}
+
+/*
+ * runs the grammar on str in context and returns the tree of the last parsed line (0 on errors).
+ * vars[0..nvars-1] are bound to slots, assigns_symbol is set if the tree assigns a variable of the context.
+ */
+static parser_node* parse_tree(parser_context *context, const char *str, const char * const *vars, int nvars, int *assigns_symbol) {
 	param p;
 	p.pos = 0;
 	/* leave space to terminate string by "\n\0" */
@@ -232,14 +835,540 @@ double parse(const char *str) {
 	p.string[strlen(p.string)] = '\n';
 	pdebug("\nPARSER: yyparse(\"%s\") len=%zu\n", p.string, strlen(p.string));
 
+	p.context = context;
+	p.symbuf = 0;
+	p.length = 0;
+	p.errors = 0;
+	p.result = 0;
+	p.assigns_symbol = 0;
+	p.bound_vars = vars;
+	p.nbound_vars = nvars;
+
 	/* parameter for yylex */
 	yyparse(&p);
 
-	pdebug("PARSER: parse() DONE (res = %g, parse errors = %d)\n", res, parse_errors());
 	free(p.string);
-	p.string = 0;
+	free(p.symbuf);
+
+	context->errors = p.errors;
+	if (p.errors > 0) {
+		free_node(p.result);
+		return 0;
+	}
+	*assigns_symbol = p.assigns_symbol;
+	return p.result;
+}
+
+double context_parse(parser_context *context, const char *str) {
+	pdebug("\nPARSER: parse(\"%s\") len=%zu\n", str, strlen(str));
+
+	double result = 0;
+	parser_expr *expr = context_compile_expr(context, str, 0, 0);
+	if (expr) {
+		result = eval_expr(expr, 0);
+		free_expr(expr);
+	}
+
+	pdebug("PARSER: parse() DONE (result = %g, parse errors = %d)\n", result, context->errors);
+	return result;
+}
+
+double parse(const char *str) {
+	/* be sure that the symbol table has been initialized */
+	if (!default_context)
+		init_table();
+
+	return context_parse(default_context, str);
+}
+
+/* folds the constants of tree and translates it into the bytecode, tree is freed */
+static parser_expr* compile_tree(parser_node *tree, int assigns_symbol, int nvars) {
+	fold_node(tree);
+
+	parser_expr *expr = (parser_expr *) malloc(sizeof(parser_expr));
+	expr->code = (parser_instr *) malloc(count_instr(tree) * sizeof(parser_instr));
+	expr->length = 0;
+	expr->depth = emit_node(tree, expr);
+	expr->threadsafe = !assigns_symbol;
+	expr->nvars = nvars;
+	expr->blockwise = 1;
+	int i;
+	for (i = 0; i < expr->length; i++) {
+		if (expr->code[i].op == OP_STORE_SLOT || expr->code[i].op == OP_STORE_VAR)
+			expr->blockwise = 0;
+	}
+	free_node(tree);
+
+	return expr;
+}
+
+/*
+ * compiles the expression str once for repeated evaluation with eval_expr().
+ * The variables vars[0..nvars-1] are bound to slots, eval_expr() reads their values
+ * from the array passed to it instead of the symbol table.
+ * Constant subexpressions are folded and the expression is translated into a
+ * bytecode for a stack machine with the function pointers resolved.
+ * Returns 0 if the expression contains errors, context_parse_errors() gives their number.
+ */
+parser_expr* context_compile_expr(parser_context *context, const char *str, const char * const *vars, int nvars) {
+	pdebug("\nPARSER: compile_expr(\"%s\") nvars=%d\n", str, nvars);
+
+	int assigns_symbol = 0;
+	parser_node *tree = parse_tree(context, str, vars, nvars, &assigns_symbol);
+	if (!tree)
+		return 0;
+
+	return compile_tree(tree, assigns_symbol, nvars);
+}
+
+parser_expr* compile_expr(const char *str, const char * const *vars, int nvars) {
+	/* be sure that the symbol table has been initialized */
+	if (!default_context)
+		init_table();
+
+	return context_compile_expr(default_context, str, vars, nvars);
+}
+
+/*
+ * compiles the partial derivative of the expression str with respect to the variable name,
+ * which is either one of the bound variables vars[0..nvars-1] or a variable of context.
+ * The derivative is built symbolically from the tree of the expression and compiled like compile_expr() does.
+ * Returns 0 if the expression contains errors or assignments, if name is not a variable,
+ * or if the expression contains functions whose derivative is not known.
+ */
+parser_expr* context_compile_derivative(parser_context *context, const char *str, const char * const *vars, int nvars, const char *name) {
+	pdebug("\nPARSER: compile_derivative(\"%s\", \"%s\")\n", str, name);
+
+	int slot = -1, i;
+	const symrec *sym = 0;
+	for (i = 0; i < nvars; i++) {
+		if (strcmp(vars[i], name) == 0)
+			slot = i;
+	}
+	if (slot == -1) {
+		sym = getsym(context, name);
+		if (!sym || sym->type != VAR || is_builtin(sym))
+			return 0;
+	}
 
-	return res;
+	int assigns_symbol = 0;
+	parser_node *tree = parse_tree(context, str, vars, nvars, &assigns_symbol);
+	if (!tree)
+		return 0;
+
+	int error = 0;
+	parser_node *derivative = diff_node(tree, slot, sym, &error);
+	free_node(tree);
+	if (error) {
+		free_node(derivative);
+		return 0;
+	}
+
+	return compile_tree(derivative, 0, nvars);
+}
+
+parser_expr* compile_derivative(const char *str, const char * const *vars, int nvars, const char *name) {
+	/* be sure that the symbol table has been initialized */
+	if (!default_context)
+		init_table();
+
+	return context_compile_derivative(default_context, str, vars, nvars, name);
+}
+
+/*
+ * evaluates a compiled expression, vars holds the values of the bound variables.
+ * Only reads the symbol table of the context it was compiled in and can be called from
+ * several threads at once with different vars arrays as long as expr_is_threadsafe() is true.
+ */
+double eval_expr(const parser_expr *expr, double *vars) {
+	double buffer[EVAL_STACK_SIZE];
+	double *stack = expr->depth <= EVAL_STACK_SIZE ? buffer : (double *) malloc(expr->depth * sizeof(double));
+	double *top = stack - 1;
+	const parser_instr *instr = expr->code;
+	const parser_instr *end = instr + expr->length;
+
+	for (; instr != end; instr++) {
+		switch (instr->op) {
+		case OP_CONST:
+			*++top = instr->arg.value;
+			break;
+		case OP_SLOT:
+			*++top = vars[instr->arg.slot];
+			break;
+		case OP_VAR:
+			*++top = *instr->arg.var;
+			break;
+		case OP_STORE_SLOT:
+			vars[instr->arg.slot] = *top;
+			break;
+		case OP_STORE_VAR:
+			*instr->arg.var = *top;
+			break;
+		case OP_ADD:
+			top--;
+			top[0] += top[1];
+			break;
+		case OP_SUB:
+			top--;
+			top[0] -= top[1];
+			break;
+		case OP_MUL:
+			top--;
+			top[0] *= top[1];
+			break;
+		case OP_DIV:
+			top--;
+			top[0] /= top[1];
+			break;
+		case OP_POW:
+			top--;
+			top[0] = pow(top[0], top[1]);
+			break;
+		case OP_NEG:
+			top[0] = -top[0];
+			break;
+		case OP_CALL0:
+			*++top = (*instr->arg.fnct)();
+			break;
+		case OP_CALL1:
+		case OP_EXP:
+		case OP_LOG:
+		case OP_SIN:
+		case OP_COS:
+			top[0] = (*instr->arg.fnct)(top[0]);
+			break;
+		case OP_CALL2:
+			top--;
+			top[0] = (*instr->arg.fnct)(top[0], top[1]);
+			break;
+		case OP_CALL3:
+			top -= 2;
+			top[0] = (*instr->arg.fnct)(top[0], top[1], top[2]);
+			break;
+		case OP_CALL4:
+			top -= 3;
+			top[0] = (*instr->arg.fnct)(top[0], top[1], top[2], top[3]);
+			break;
+		}
+	}
+
+	double result = *top;
+	if (stack != buffer)
+		free(stack);
+	return result;
+}
+
+/*
+ * vectorized kernels of eval_block() for exp(), log(), sin() and cos().
+ * Each kernel is a loop without branches and calls over the block, which the compiler vectorizes.
+ * The arguments are reduced to a small interval by integer multiples of ln(2) resp. pi/2
+ * and the reduced function is evaluated by a polynomial, its truncation error is below 1e-17.
+ * The maximal errors measured against the exact results are:
+ *	exp(x), |x| <= 708:	1.2 ulp
+ *	log(x), x normal:	2 ulp
+ *	sin(x), cos(x), |x| <= 1e5:	2.5 ulp, close to the zeros (except sin(0)) the absolute error
+ *		of the reduction (below 1e-26) dominates
+ * The rows outside these ranges (including NaN and inf) are evaluated by the scalar function fnct afterwards,
+ * so overflow, underflow and domain errors are handled like in eval_expr().
+ */
+
+/* adding it to a double rounds to an integer which is stored in the low bits of the mantissa */
+#define ROUND_SHIFTER 6755399441055744.0	/* 1.5*2^52 */
+#define LN2_HI 6.93147180369123816490e-01	/* ln(2) split into a part with 32 bits and the rest */
+#define LN2_LO 1.90821492927058770002e-10
+#define PIO2_1 1.57079632673412561417e+00	/* pi/2 split into parts with 33 bits */
+#define PIO2_2 6.07710050630396597660e-11
+#define PIO2_3 2.02226624871116645580e-21
+
+static double bits_to_double(uint64_t bits) {
+	double d;
+	memcpy(&d, &bits, sizeof(d));
+	return d;
+}
+
+static uint64_t double_to_bits(double d) {
+	uint64_t bits;
+	memcpy(&bits, &d, sizeof(bits));
+	return bits;
+}
+
+/* a if the lowest bit of condition is set, b otherwise. Selecting by the bits keeps the loops free of branches,
+   conditional expressions on doubles aren't vectorized since evaluating both of them may raise floating point exceptions */
+static double select_double(uint64_t condition, double a, double b) {
+	const uint64_t mask = -(condition & 1);
+	return bits_to_double((double_to_bits(a) & mask) | (double_to_bits(b) & ~mask));
+}
+
+static void block_exp(double *x, int n, func_t fnct) {
+	double y[EVAL_BLOCK_SIZE];
+	int i;
+	for (i = 0; i < n; i++) {
+		/* x = k*ln(2) + r, |r| <= ln(2)/2. The results of larger |x| are replaced below */
+		const double v = x[i];
+		const double t = v * M_LOG2E + ROUND_SHIFTER;
+		const double k = t - ROUND_SHIFTER;
+		const double r = (v - k * LN2_HI) - k * LN2_LO;
+		/* exp(r) by its Taylor series up to r^13 */
+		double p = 1./6227020800.;
+		p = p * r + 1./479001600.;
+		p = p * r + 1./39916800.;
+		p = p * r + 1./3628800.;
+		p = p * r + 1./362880.;
+		p = p * r + 1./40320.;
+		p = p * r + 1./5040.;
+		p = p * r + 1./720.;
+		p = p * r + 1./120.;
+		p = p * r + 1./24.;
+		p = p * r + 1./6.;
+		p = p * r + 0.5;
+		p = p * r + 1.;
+		p = p * r + 1.;
+		/* 2^k, k is in the low bits of t */
+		const uint64_t scale = (double_to_bits(t) - double_to_bits(ROUND_SHIFTER) + 1023) << 52;
+		y[i] = p * bits_to_double(scale);
+	}
+	for (i = 0; i < n; i++)
+		x[i] = fabs(x[i]) <= 708. ? y[i] : (*fnct)(x[i]);
+}
+
+static void block_log(double *x, int n, func_t fnct) {
+	double y[EVAL_BLOCK_SIZE];
+	int i;
+	for (i = 0; i < n; i++) {
+		/* x = 2^e * m, sqrt(2)/2 < m <= sqrt(2) */
+		const uint64_t bits = double_to_bits(x[i]);
+		double m = bits_to_double((bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+		/* e from the biased exponent, by the same trick as ROUND_SHIFTER */
+		double e = bits_to_double(0x4330000000000000ULL | (bits >> 52 & 0x7ff)) - (4503599627370496. + 1023.);
+		/* m > sqrt(2): both are in [1, 2), the difference of their bits is negative */
+		const uint64_t reduce = (double_to_bits(M_SQRT2) - double_to_bits(m)) >> 63;
+		m = bits_to_double(double_to_bits(m) - (reduce << 52));
+		e += select_double(reduce, 1., 0.);
+		/* log(m) = 2 atanh(f) with f = (m - 1)/(m + 1), |f| <= 0.172, by its series up to f^21 */
+		const double f = (m - 1.)/(m + 1.);
+		const double s = f * f;
+		double p = 1./21.;
+		p = p * s + 1./19.;
+		p = p * s + 1./17.;
+		p = p * s + 1./15.;
+		p = p * s + 1./13.;
+		p = p * s + 1./11.;
+		p = p * s + 1./9.;
+		p = p * s + 1./7.;
+		p = p * s + 1./5.;
+		p = p * s + 1./3.;
+		const double logm = 2. * f + 2. * f * s * p;
+		y[i] = e * LN2_HI + (logm + e * LN2_LO);
+	}
+	for (i = 0; i < n; i++)
+		x[i] = x[i] >= DBL_MIN && x[i] <= DBL_MAX ? y[i] : (*fnct)(x[i]);
+}
+
+/* sin(x) for quadrant = 0 and cos(x) for quadrant = 1 */
+static void block_sincos(double *x, int n, func_t fnct, uint64_t quadrant) {
+	double y[EVAL_BLOCK_SIZE];
+	int i;
+	for (i = 0; i < n; i++) {
+		/* x = k*pi/2 + r, |r| <= pi/4, k*PIO2_1 and k*PIO2_2 are exact. The results of larger |x| are replaced below */
+		const double v = x[i];
+		const double t = v * M_2_PI + ROUND_SHIFTER;
+		const double k = t - ROUND_SHIFTER;
+		const double r = ((v - k * PIO2_1) - k * PIO2_2) - k * PIO2_3;
+		const double r2 = r * r;
+		/* Taylor series up to r^17 resp. r^18 */
+		double ps = -1./355687428096000.;
+		ps = ps * r2 + 1./1307674368000.;
+		ps = ps * r2 - 1./6227020800.;
+		ps = ps * r2 + 1./39916800.;
+		ps = ps * r2 - 1./362880.;
+		ps = ps * r2 + 1./5040.;
+		ps = ps * r2 - 1./120.;
+		ps = ps * r2 + 1./6.;
+		const double sine = r - r * r2 * ps;
+		double pc = 1./6402373705728000.;
+		pc = pc * r2 - 1./20922789888000.;
+		pc = pc * r2 + 1./87178291200.;
+		pc = pc * r2 - 1./479001600.;
+		pc = pc * r2 + 1./3628800.;
+		pc = pc * r2 - 1./40320.;
+		pc = pc * r2 + 1./720.;
+		pc = pc * r2 - 1./24.;
+		const double cosine = 1. - 0.5 * r2 - r2 * r2 * pc;
+		/* the quadrant is in the low bits of t */
+		const uint64_t q = double_to_bits(t) + quadrant;
+		const double value = select_double(q, cosine, sine);
+		y[i] = bits_to_double(double_to_bits(value) ^ (q & 2) << 62);
+	}
+	for (i = 0; i < n; i++)
+		x[i] = fabs(x[i]) <= 1e5 ? y[i] : (*fnct)(x[i]);
+}
+
+/*
+ * evaluates the compiled expression for n rows of a block (n <= EVAL_BLOCK_SIZE) starting at row first.
+ * Every stack entry holds the values of all rows, so each instruction is one tight loop over the block:
+ * the arithmetic loops are vectorized by the compiler and the function pointers are resolved once per block.
+ * exp(), log(), sin() and cos() use the vectorized kernels above, their results agree with the ones
+ * of eval_expr() within the documented accuracy. The other functions (e.g. the GSL special functions)
+ * are called element-wise and give identical results.
+ */
+static void eval_block(const parser_expr *expr, const double * const *vars, int first, int n, double *stack, double *result) {
+	double *top = stack - EVAL_BLOCK_SIZE;
+	const double *a, *b, *c;
+	double value;
+	func_t fnct;
+	int i;
+	const parser_instr *instr = expr->code;
+	const parser_instr *end = instr + expr->length;
+
+	for (; instr != end; instr++) {
+		switch (instr->op) {
+		case OP_CONST:
+			top += EVAL_BLOCK_SIZE;
+			value = instr->arg.value;
+			for (i = 0; i < n; i++)
+				top[i] = value;
+			break;
+		case OP_SLOT:
+			top += EVAL_BLOCK_SIZE;
+			memcpy(top, vars[instr->arg.slot] + first, n * sizeof(double));
+			break;
+		case OP_VAR:
+			top += EVAL_BLOCK_SIZE;
+			value = *instr->arg.var;
+			for (i = 0; i < n; i++)
+				top[i] = value;
+			break;
+		case OP_STORE_SLOT:
+		case OP_STORE_VAR:
+			/* not blockwise, handled by eval_expr_block() */
+			break;
+		case OP_ADD:
+			a = top;
+			top -= EVAL_BLOCK_SIZE;
+			for (i = 0; i < n; i++)
+				top[i] += a[i];
+			break;
+		case OP_SUB:
+			a = top;
+			top -= EVAL_BLOCK_SIZE;
+			for (i = 0; i < n; i++)
+				top[i] -= a[i];
+			break;
+		case OP_MUL:
+			a = top;
+			top -= EVAL_BLOCK_SIZE;
+			for (i = 0; i < n; i++)
+				top[i] *= a[i];
+			break;
+		case OP_DIV:
+			a = top;
+			top -= EVAL_BLOCK_SIZE;
+			for (i = 0; i < n; i++)
+				top[i] /= a[i];
+			break;
+		case OP_POW:
+			a = top;
+			top -= EVAL_BLOCK_SIZE;
+			for (i = 0; i < n; i++)
+				top[i] = pow(top[i], a[i]);
+			break;
+		case OP_NEG:
+			for (i = 0; i < n; i++)
+				top[i] = -top[i];
+			break;
+		case OP_CALL0:
+			top += EVAL_BLOCK_SIZE;
+			fnct = instr->arg.fnct;
+			for (i = 0; i < n; i++)
+				top[i] = (*fnct)();
+			break;
+		case OP_CALL1:
+			fnct = instr->arg.fnct;
+			for (i = 0; i < n; i++)
+				top[i] = (*fnct)(top[i]);
+			break;
+		case OP_EXP:
+			block_exp(top, n, instr->arg.fnct);
+			break;
+		case OP_LOG:
+			block_log(top, n, instr->arg.fnct);
+			break;
+		case OP_SIN:
+			block_sincos(top, n, instr->arg.fnct, 0);
+			break;
+		case OP_COS:
+			block_sincos(top, n, instr->arg.fnct, 1);
+			break;
+		case OP_CALL2:
+			a = top;
+			top -= EVAL_BLOCK_SIZE;
+			fnct = instr->arg.fnct;
+			for (i = 0; i < n; i++)
+				top[i] = (*fnct)(top[i], a[i]);
+			break;
+		case OP_CALL3:
+			b = top;
+			a = top - EVAL_BLOCK_SIZE;
+			top -= 2 * EVAL_BLOCK_SIZE;
+			fnct = instr->arg.fnct;
+			for (i = 0; i < n; i++)
+				top[i] = (*fnct)(top[i], a[i], b[i]);
+			break;
+		case OP_CALL4:
+			c = top;
+			b = top - EVAL_BLOCK_SIZE;
+			a = top - 2 * EVAL_BLOCK_SIZE;
+			top -= 3 * EVAL_BLOCK_SIZE;
+			fnct = instr->arg.fnct;
+			for (i = 0; i < n; i++)
+				top[i] = (*fnct)(top[i], a[i], b[i], c[i]);
+			break;
+		}
+	}
+
+	memcpy(result, top, n * sizeof(double));
+}
+
+/*
+ * evaluates a compiled expression for n rows, vars[k] points to the n values of the bound variable k.
+ * The rows are processed in blocks of EVAL_BLOCK_SIZE, see eval_block().
+ * Expressions containing assignments depend on the order of the rows and are evaluated row by row.
+ */
+void eval_expr_block(const parser_expr *expr, const double * const *vars, double *result, int n) {
+	int first, k;
+	if (!expr->blockwise) {
+		double buffer[EVAL_STACK_SIZE];
+		double *values = expr->nvars <= EVAL_STACK_SIZE ? buffer : (double *) malloc(expr->nvars * sizeof(double));
+		for (first = 0; first < n; first++) {
+			for (k = 0; k < expr->nvars; k++)
+				values[k] = vars[k][first];
+			result[first] = eval_expr(expr, values);
+		}
+		if (values != buffer)
+			free(values);
+		return;
+	}
+
+	double buffer[EVAL_BLOCK_STACK_SIZE * EVAL_BLOCK_SIZE];
+	double *stack = expr->depth <= EVAL_BLOCK_STACK_SIZE ? buffer : (double *) malloc(expr->depth * EVAL_BLOCK_SIZE * sizeof(double));
+	for (first = 0; first < n; first += EVAL_BLOCK_SIZE) {
+		const int count = n - first < EVAL_BLOCK_SIZE ? n - first : EVAL_BLOCK_SIZE;
+		eval_block(expr, vars, first, count, stack, result + first);
+	}
+	if (stack != buffer)
+		free(stack);
+}
+
+/* returns 0 if evaluating expr assigns a variable of the context it was compiled in */
+int expr_is_threadsafe(const parser_expr *expr) {
+	return expr->threadsafe;
+}
+
+void free_expr(parser_expr *expr) {
+	if (!expr)
+		return;
+	free(expr->code);
+	free(expr);
 }
 
 double parse_with_vars(const char *str, const parser_var *vars, int nvars) {
@@ -253,7 +1382,7 @@ double parse_with_vars(const char *str, const parser_var *vars, int nvars) {
 	return parse(str);
 }
 
-int yylex(param *p) {
+int yylex(YYSTYPE *yylval, param *p) {
 	pdebug("PARSER: yylex()\n");
 	int c;
 
@@ -268,7 +1397,7 @@ int yylex(param *p) {
 	/* check for non-ASCII chars */
 	if (!isascii(c)) {
 		pdebug("non-ASCII character found. Giving up\n");
-		yynerrs++;
+		p->errors++;
 		return 0;
 	}
 
@@ -285,11 +1414,7 @@ int yylex(param *p) {
 #if defined(_WIN32) || defined(__APPLE__)
 		double result = strtod(s, &remain);
 #else
-		/* use same locale for all languages: '.' as decimal point */
-		locale_t locale = newlocale(LC_NUMERIC_MASK, "C", NULL);
-
-		double result = strtod_l(s, &remain, locale);
-		freelocale(locale);
+		double result = strtod_l(s, &remain, c_locale);
 #endif
 		pdebug("PARSER: reading: %s", s);
 		pdebug("PARSER: remain = %s", remain);
@@ -300,7 +1425,7 @@ int yylex(param *p) {
 
 		pdebug("PARSER: result = %g\n", result);
 
-		yylval.dval = result;
+		yylval->dval = result;
 
                 p->pos += strlen(s) - strlen(remain);
 
@@ -309,8 +1434,8 @@ int yylex(param *p) {
 
 	if (isalpha (c) || c == '.') {
 		pdebug("PARSER: reading identifier (starts with alpha: %c)\n", c);
-		static char *symbuf = 0;
-		static int length = 0;
+		char *symbuf = p->symbuf;
+		int length = p->length;
 		int i = 0;
 
 		/* Initially make the buffer long enough for a 10-character symbol name */
@@ -334,18 +1459,29 @@ int yylex(param *p) {
 		if (c != EOF)
 			ungetcstr(&(p->pos));
 		symbuf[i] = '\0';
+		/* the buffer is reused for the next identifier and freed after parsing */
+		p->symbuf = symbuf;
+		p->length = length;
+
+		/* variables bound by compile_expr() hide the symbol table */
+		for (i = 0; i < p->nbound_vars; i++) {
+			if (strcmp(p->bound_vars[i], symbuf) == 0) {
+				yylval->ival = i;
+				return SLOT;
+			}
+		}
 
-		symrec *s = getsym(symbuf);
+		symrec *s = getsym(p->context, symbuf);
 		if(s == 0) {	/* symbol unknown */
 			pdebug("PARSER: ERROR: symbol \"%s\" UNKNOWN\n", symbuf);
-			yynerrs++;
+			p->errors++;
 			return 0;
 		}
 		/* old behavior */
 		/* if (s == 0)
 			 s = putsym (symbuf, VAR);
 		*/
-		yylval.tptr = s;
+		yylval->tptr = s;
 		return s->type;
 	}
 
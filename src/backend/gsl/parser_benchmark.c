@@ -0,0 +1,201 @@
+/***************************************************************************
+    File                 : parser_benchmark.c
+    Project              : LabPlot
+    Description          : Parser benchmark
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+/*
+ * measures for the expressions of parser_test_corpus.h the time for
+ * - parsing and compiling an expression
+ * - evaluating it for an array of values with the interpreter (assign x and parse()),
+ *   with the compiled expression row by row and block-wise
+ * - the evaluation of the compiled expression in several threads
+ * and the time for assigning variables by name and through handles.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <pthread.h>
+#include "parser.h"
+#include "parser_test_corpus.h"
+
+#define N 1000000	/* number of values to evaluate */
+#define NINTERP 100000	/* number of values to evaluate with the interpreter */
+#define NCOMPILE 10000	/* number of compilations */
+#define NASSIGN 10000000	/* number of assignments */
+#define MAXTHREADS 8
+
+static volatile double sink;
+
+static double seconds() {
+	struct timeval time;
+	gettimeofday(&time, NULL);
+	return time.tv_sec + 1.e-6*time.tv_usec;
+}
+
+typedef struct {
+	const parser_expr *expr;
+	const double *x;
+	double *y;
+	int n;
+} thread_data;
+
+static void* evaluate_chunk(void *arg) {
+	thread_data *data = (thread_data *)arg;
+	const double *vars[1] = {data->x};
+	eval_expr_block(data->expr, vars, data->y, data->n);
+	return NULL;
+}
+
+/* evaluates expr for all values in nthreads threads, returns the run time in seconds */
+static double evaluate_parallel(const parser_expr *expr, const double *x, double *y, int nthreads) {
+	pthread_t threads[MAXTHREADS];
+	thread_data data[MAXTHREADS];
+	int i;
+
+	const double start = seconds();
+	for (i = 0; i < nthreads; i++) {
+		const int first = (int)((long)i*N/nthreads);
+		data[i].expr = expr;
+		data[i].x = x + first;
+		data[i].y = y + first;
+		data[i].n = (int)((long)(i + 1)*N/nthreads) - first;
+		pthread_create(&threads[i], NULL, evaluate_chunk, &data[i]);
+	}
+	for (i = 0; i < nthreads; i++)
+		pthread_join(threads[i], NULL);
+
+	return seconds() - start;
+}
+
+static parser_context* benchmark_context() {
+	parser_context *context = create_context();
+	int i;
+	for (i = 0; i < NPARAMS; i++)
+		context_assign_variable(context, param_names[i], param_values[i]);
+	return context;
+}
+
+int main() {
+	const char *vars[] = {"x"};
+	double *x = (double *)malloc(N*sizeof(double));
+	double *y = (double *)malloc(N*sizeof(double));
+	double start;
+	size_t c;
+	int i, nthreads;
+
+	init_table();
+
+	printf("times per expression (compile) or per value (evaluation) in ns\n");
+	printf("%-70s %9s %9s %9s %9s", "expression", "compile", "parse", "eval", "block");
+	for (nthreads = 1; nthreads <= MAXTHREADS; nthreads *= 2)
+		printf(" %6d thr", nthreads);
+	puts("");
+
+	for (c = 0; c < NCORPUS; c++) {
+		const parser_testcase *t = &corpus[c];
+		parser_context *context = benchmark_context();
+		for (i = 0; i < N; i++)
+			x[i] = t->xmin + (t->xmax - t->xmin)*i/(N - 1);
+
+		/* parsing and compiling only */
+		start = seconds();
+		for (i = 0; i < NCOMPILE; i++)
+			free_expr(context_compile_expr(context, t->expr, vars, 1));
+		const double compileTime = (seconds() - start)/NCOMPILE;
+
+		/* interpreter: assign the variable and parse the expression for every value */
+		start = seconds();
+		for (i = 0; i < NINTERP; i++) {
+			context_assign_variable(context, "x", x[i]);
+			sink = context_parse(context, t->expr);
+		}
+		const double parseTime = (seconds() - start)/NINTERP;
+
+		parser_expr *expr = context_compile_expr(context, t->expr, vars, 1);
+		if (!expr) {
+			printf("%-70s compilation failed\n", t->expr);
+			free_context(context);
+			continue;
+		}
+
+		/* compiled expression, row by row */
+		start = seconds();
+		for (i = 0; i < N; i++)
+			y[i] = eval_expr(expr, &x[i]);
+		const double evalTime = (seconds() - start)/N;
+
+		/* compiled expression, block-wise */
+		const double *columns[1] = {x};
+		start = seconds();
+		eval_expr_block(expr, columns, y, N);
+		const double blockTime = (seconds() - start)/N;
+
+		printf("%-70s %9.1f %9.1f %9.1f %9.1f", t->expr, 1.e9*compileTime, 1.e9*parseTime, 1.e9*evalTime, 1.e9*blockTime);
+		for (nthreads = 1; nthreads <= MAXTHREADS; nthreads *= 2)
+			printf(" %10.2f", 1.e9*evaluate_parallel(expr, x, y, nthreads)/N);
+		puts("");
+
+		free_expr(expr);
+		free_context(context);
+	}
+
+	/* assignment of variables, the lookup by name depends on the number of variables */
+	puts("");
+	printf("times per assignment in ns\n");
+	printf("%-10s %9s %9s\n", "variables", "by name", "handle");
+	int nvars;
+	for (nvars = 1; nvars <= 1000; nvars *= 10) {
+		parser_context *context = create_context();
+		char name[MAX_VARNAME_LENGTH];
+		for (i = 0; i < nvars; i++) {
+			snprintf(name, MAX_VARNAME_LENGTH, "v%d", i);
+			context_assign_variable(context, name, i);
+		}
+
+		/* the variable added first is found last */
+		const int nassign = NASSIGN/nvars;
+		start = seconds();
+		for (i = 0; i < nassign; i++)
+			context_assign_variable(context, "v0", i);
+		const double nameTime = (seconds() - start)/nassign;
+
+		volatile double *handle = context_bind_variable(context, "v0");
+		start = seconds();
+		for (i = 0; i < NASSIGN; i++)
+			*handle = i;
+		const double handleTime = (seconds() - start)/NASSIGN;
+
+		printf("%-10d %9.2f %9.2f\n", nvars, 1.e9*nameTime, 1.e9*handleTime);
+		free_context(context);
+	}
+
+	delete_table();
+	free(x);
+	free(y);
+
+	return 0;
+}
@@ -0,0 +1,205 @@
+/***************************************************************************
+    File                 : parser_test.c
+    Project              : LabPlot
+    Description          : Parser correctness tests
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+/*
+ * compares all evaluation paths of the parser (interpreted parse(), compiled row-wise and block-wise,
+ * multi-threaded and symbolic derivatives) with reference implementations of the expressions in C.
+ * Returns the number of failed tests.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <gsl/gsl_const_mksa.h>
+#include "parser.h"
+#include "parser_test_corpus.h"
+
+#define N 1000
+#define NTHREADS 4
+#define TOL 1.e-12
+#define DERIV_TOL 1.e-6
+
+static int failed = 0;
+
+static int equal(double value, double ref, double tol) {
+	if (isnan(ref))
+		return isnan(value);
+	return fabs(value - ref) <= tol*(1. + fabs(ref));
+}
+
+static void check(const char *test, const char *expr, int ok) {
+	if (!ok)
+		failed++;
+	printf("%-12s %-70s %s\n", test, expr, ok ? "PASSED" : "FAILED");
+}
+
+typedef struct {
+	const parser_expr *expr;
+	const double *x;
+	double *y;
+	int n;
+} thread_data;
+
+static void* evaluate_chunk(void *arg) {
+	thread_data *data = (thread_data *)arg;
+	const double *vars[1] = {data->x};
+	eval_expr_block(data->expr, vars, data->y, data->n);
+	return NULL;
+}
+
+static parser_context* test_context() {
+	parser_context *context = create_context();
+	int i;
+	for (i = 0; i < NPARAMS; i++)
+		context_assign_variable(context, param_names[i], param_values[i]);
+	return context;
+}
+
+int main() {
+	const char *vars[] = {"x"};
+	double x[N], ref[N], y[N];
+	size_t c;
+	int i;
+
+	init_table();
+
+	for (c = 0; c < NCORPUS; c++) {
+		const parser_testcase *t = &corpus[c];
+		parser_context *context = test_context();
+		for (i = 0; i < N; i++) {
+			x[i] = t->xmin + (t->xmax - t->xmin)*i/(N - 1);
+			ref[i] = t->ref(x[i], param_values);
+		}
+
+		/* interpreter */
+		int ok = 1;
+		for (i = 0; i < N; i++) {
+			context_assign_variable(context, "x", x[i]);
+			ok = ok && equal(context_parse(context, t->expr), ref[i], TOL);
+		}
+		check("parse", t->expr, ok && context_parse_errors(context) == 0);
+
+		parser_expr *expr = context_compile_expr(context, t->expr, vars, 1);
+		check("compile", t->expr, expr != NULL && expr_is_threadsafe(expr));
+		if (!expr) {
+			free_context(context);
+			continue;
+		}
+
+		/* compiled, row by row */
+		ok = 1;
+		for (i = 0; i < N; i++)
+			ok = ok && equal(eval_expr(expr, &x[i]), ref[i], TOL);
+		check("eval", t->expr, ok);
+
+		/* compiled, block-wise */
+		const double *columns[1] = {x};
+		eval_expr_block(expr, columns, y, N);
+		ok = 1;
+		for (i = 0; i < N; i++)
+			ok = ok && equal(y[i], ref[i], TOL);
+		check("eval_block", t->expr, ok);
+
+		/* compiled expression shared by several threads */
+		pthread_t threads[NTHREADS];
+		thread_data data[NTHREADS];
+		for (i = 0; i < NTHREADS; i++) {
+			const int start = i*N/NTHREADS;
+			data[i].expr = expr;
+			data[i].x = x + start;
+			data[i].y = y + start;
+			data[i].n = (i + 1)*N/NTHREADS - start;
+			pthread_create(&threads[i], NULL, evaluate_chunk, &data[i]);
+		}
+		for (i = 0; i < NTHREADS; i++)
+			pthread_join(threads[i], NULL);
+		ok = 1;
+		for (i = 0; i < N; i++)
+			ok = ok && equal(y[i], ref[i], TOL);
+		check("threads", t->expr, ok);
+
+		free_expr(expr);
+
+		/* symbolic derivative compared to the central difference of the reference */
+		if (t->derivative) {
+			parser_expr *deriv = context_compile_derivative(context, t->expr, vars, 1, "x");
+			ok = (deriv != NULL);
+			for (i = 0; ok && i < N; i++) {
+				const double h = 1.e-5*(1. + fabs(x[i]));
+				const double diff = (t->ref(x[i] + h, param_values) - t->ref(x[i] - h, param_values))/(2*h);
+				ok = equal(eval_expr(deriv, &x[i]), diff, DERIV_TOL);
+			}
+			check("derivative", t->expr, ok);
+			if (deriv)
+				free_expr(deriv);
+		}
+
+		free_context(context);
+	}
+
+	/* syntax errors */
+	const char *invalid[] = {"1 +", "sin(x", "2*)x", "x^^2"};
+	parser_context *context = test_context();
+	for (c = 0; c < sizeof(invalid)/sizeof(invalid[0]); c++) {
+		parser_expr *expr = context_compile_expr(context, invalid[c], vars, 1);
+		check("invalid", invalid[c], expr == NULL && context_parse_errors(context) > 0);
+		if (expr)
+			free_expr(expr);
+	}
+
+	/* assignments change the context and are not thread-safe */
+	parser_expr *expr = context_compile_expr(context, "p0 = 2*x", vars, 1);
+	check("assign", "p0 = 2*x", expr != NULL && !expr_is_threadsafe(expr));
+	if (expr) {
+		double value = 21.;
+		eval_expr(expr, &value);
+		check("assign", "p0", context_parse(context, "p0") == 42.);
+		free_expr(expr);
+	}
+
+	/* variables of different contexts are independent */
+	parser_context *other = copy_context(context);
+	context_assign_variable(other, "p0", -1.);
+	check("contexts", "p0", context_parse(context, "p0") == 42. && context_parse(other, "p0") == -1.);
+	free_context(other);
+
+	/* handles to variables */
+	double *handle = context_bind_variable(context, "p1");
+	*handle = 7.;
+	check("bind", "p1", context_parse(context, "2*p1") == 14.);
+
+	/* constants hide the built-in functions of the same name */
+	check("builtins", "gamma", context_parse(context, "gamma") == GSL_CONST_MKSA_GRAVITATIONAL_CONSTANT
+		&& context_parse_errors(context) == 0);
+	free_context(context);
+
+	delete_table();
+
+	printf("%d test(s) failed\n", failed);
+	return failed;
+}
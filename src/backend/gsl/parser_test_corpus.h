@@ -0,0 +1,96 @@
+/***************************************************************************
+    File                 : parser_test_corpus.h
+    Project              : LabPlot
+    Description          : Expressions for the parser tests and benchmark
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PARSER_TEST_CORPUS_H
+#define PARSER_TEST_CORPUS_H
+
+#include <math.h>
+#include <gsl/gsl_sf.h>
+
+/* parameters of the expressions, assigned as variables of the parser context */
+#define NPARAMS 8
+static const char *param_names[NPARAMS] = {"p0", "p1", "p2", "p3", "p4", "p5", "p6", "p7"};
+static const double param_values[NPARAMS] = {1.5, -0.5, 0.25, 2., 0.75, -1.25, 3., 0.1};
+
+/* reference implementations of the expressions in C */
+static double ref_poly(double x, const double *p) {
+	(void)p;
+	return 1 + 2*x + 3*x*x - 4*x*x*x + 0.5*x*x*x*x;
+}
+static double ref_horner(double x, const double *p) {
+	(void)p;
+	return (((0.5*x - 4)*x + 3)*x + 2)*x + 1;
+}
+static double ref_pow(double x, const double *p) {
+	(void)p;
+	return pow(x, 5) - 3*pow(x, 3) + x - 7 - x*x + pow(2, pow(fabs(x), 0.5));
+}
+static double ref_trig(double x, const double *p) {
+	(void)p;
+	return sin(x)*cos(x) + exp(-x*x/2);
+}
+static double ref_log(double x, const double *p) {
+	(void)p;
+	return sqrt(1 + x*x)*log(2 + x*x);
+}
+static double ref_nested(double x, const double *p) {
+	(void)p;
+	return gsl_sf_erf(sin(x))*gsl_sf_gamma(1.5 + cos(x)*cos(x));
+}
+static double ref_bessel(double x, const double *p) {
+	(void)p;
+	return gsl_sf_bessel_J0(2*x) + gsl_sf_lngamma(2 + x*x);
+}
+static double ref_params_poly(double x, const double *p) {
+	return p[0] + p[1]*x + p[2]*x*x + p[3]*pow(x, 3) + p[4]*pow(x, 4) + p[5]*pow(x, 5) + p[6]*pow(x, 6) + p[7]*pow(x, 7);
+}
+static double ref_params_model(double x, const double *p) {
+	return p[0]*exp(-(x - p[1])*(x - p[1])/(2*p[2]*p[2])) + p[3]*sin(p[4]*x + p[5]) + p[6]/(1 + p[7]*x*x);
+}
+
+typedef struct {
+	const char *expr;
+	double (*ref)(double, const double *);
+	double xmin, xmax;	/* range of x to evaluate the expression in */
+	int derivative;		/* 1 if compile_derivative() supports all functions used */
+} parser_testcase;
+
+static const parser_testcase corpus[] = {
+	{"1 + 2*x + 3*x^2 - 4*x^3 + 0.5*x^4", ref_poly, -3., 3., 1},
+	{"(((0.5*x - 4)*x + 3)*x + 2)*x + 1", ref_horner, -3., 3., 1},
+	{"-x^2 + x^5 - 3*x^3 + x - 7 + 2^fabs(x)^0.5", ref_pow, -3., 3., 0},
+	{"sin(x)*cos(x) + exp(-x^2/2)", ref_trig, -3., 3., 1},
+	{"sqrt(1 + x^2)*ln(2 + x^2)", ref_log, -3., 3., 1},
+	{"erf(sin(x))*tgamma(1.5 + cos(x)^2)", ref_nested, -3., 3., 0},
+	{"J0(2*x) + lgamma(2 + x^2)", ref_bessel, -3., 3., 0},
+	{"p0 + p1*x + p2*x^2 + p3*x^3 + p4*x^4 + p5*x^5 + p6*x^6 + p7*x^7", ref_params_poly, -1., 1., 1},
+	{"p0*exp(-(x - p1)^2/(2*p2^2)) + p3*sin(p4*x + p5) + p6/(1 + p7*x^2)", ref_params_model, -3., 3., 1}
+};
+#define NCORPUS (sizeof(corpus)/sizeof(corpus[0]))
+
+#endif /* PARSER_TEST_CORPUS_H */
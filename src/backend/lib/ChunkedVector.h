@@ -0,0 +1,448 @@
+/***************************************************************************
+    File                 : ChunkedVector.h
+    Project              : LabPlot
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+    Description          : vector of implicitly shared chunks
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef CHUNKEDVECTOR_H
+#define CHUNKEDVECTOR_H
+
+#include <QVector>
+#include <QtAlgorithms>
+#include <cstring>
+
+/*!
+	\class ChunkedVector
+	\brief Vector whose elements are stored in implicitly shared chunks.
+
+	Copying a ChunkedVector only copies the list of chunks, the chunks themselves
+	are reference counted and copied on write. Modifying a single value of a copy
+	therefore only detaches the chunk containing this value, all other chunks stay
+	shared with the original. This makes undo backups and copies of large columns cheap.
+
+	A chunk holds at most \c ChunkSize elements. Inserting or removing values only
+	changes the chunks containing the affected positions: a chunk growing beyond
+	\c ChunkSize is split, small chunks are merged with their neighbours.
+	The values behind the affected chunks are not moved, only the start positions
+	of the following chunks are updated.
+
+	The elements of one chunk are stored contiguously, use chunkCount(), chunkStart(),
+	chunkSize() and chunkData() to process the values chunk by chunk.
+
+	\ingroup backend
+*/
+template<class T> class ChunkedVector {
+	public:
+		enum {
+			ChunkSize = 16384,
+			MinChunkSize = ChunkSize/4	//!< smaller chunks are merged with a neighbour if possible
+		};
+
+		ChunkedVector() : m_size(0) {}
+		explicit ChunkedVector(int size, const T& value = T()) : m_size(0) {
+			resize(size, value);
+		}
+		explicit ChunkedVector(const QVector<T>& vector) : m_size(0) {
+			append(vector.constData(), vector.size());
+		}
+
+		int size() const { return m_size; }
+		bool isEmpty() const { return m_size == 0; }
+
+		const T& at(int i) const {
+			const int chunk = chunkIndex(i);
+			return m_chunks.at(chunk).at(i - m_starts.at(chunk));
+		}
+		T value(int i, const T& defaultValue) const {
+			return (i < 0 || i >= m_size) ? defaultValue : at(i);
+		}
+		void replace(int i, const T& value) {
+			const int chunk = chunkIndex(i);
+			m_chunks[chunk][i - m_starts.at(chunk)] = value;
+		}
+		//! detaches the chunk containing position \c i if it is shared
+		T& operator[](int i) {
+			const int chunk = chunkIndex(i);
+			return m_chunks[chunk][i - m_starts.at(chunk)];
+		}
+		const T& operator[](int i) const { return at(i); }
+
+		int chunkCount() const { return m_chunks.size(); }
+		int chunkSize(int chunk) const { return m_chunks.at(chunk).size(); }
+		int chunkStart(int chunk) const { return m_starts.at(chunk); }
+		const T* chunkData(int chunk) const { return m_chunks.at(chunk).constData(); }
+		//! detaches the chunk if it is shared
+		T* chunkData(int chunk) { return m_chunks[chunk].data(); }
+
+		/*!
+			returns the index of the chunk containing position \c i.
+		*/
+		int chunkIndex(int i) const {
+			//as long as no rows were inserted or removed all chunks but the last one are full
+			const int chunk = i/ChunkSize;
+			if (chunk < m_starts.size() && m_starts.at(chunk) <= i
+			        && (chunk == m_starts.size() - 1 || m_starts.at(chunk + 1) > i))
+				return chunk;
+			return int(qUpperBound(m_starts.constBegin(), m_starts.constEnd(), i) - m_starts.constBegin()) - 1;
+		}
+
+		/*!
+			writes \c count values starting at \c first to \c dest,
+			converted to the type of \c dest.
+		*/
+		template<class D> void read(int first, int count, D* dest) const {
+			if (count <= 0)
+				return;
+			int chunk = chunkIndex(first);
+			int offset = first - m_starts.at(chunk);
+			while (count > 0) {
+				const int n = qMin(count, m_chunks.at(chunk).size() - offset);
+				const T* src = m_chunks.at(chunk).constData() + offset;
+				for (int i = 0; i < n; ++i)
+					dest[i] = src[i];
+				dest += n;
+				count -= n;
+				++chunk;
+				offset = 0;
+			}
+		}
+
+		/*!
+			replaces \c count values starting at \c first with the values of \c src, converted to \c T.
+			The range has to be within the current size, only the affected chunks are detached.
+		*/
+		template<class S> void write(int first, int count, const S* src) {
+			if (count <= 0)
+				return;
+			int chunk = chunkIndex(first);
+			int offset = first - m_starts.at(chunk);
+			while (count > 0) {
+				const int n = qMin(count, m_chunks.at(chunk).size() - offset);
+				T* dest = m_chunks[chunk].data() + offset;
+				for (int i = 0; i < n; ++i)
+					dest[i] = src[i];
+				src += n;
+				count -= n;
+				++chunk;
+				offset = 0;
+			}
+		}
+
+		/*!
+			appends \c count values, converted to \c T.
+		*/
+		template<class S> void append(const S* src, int count) {
+			while (count > 0) {
+				QVector<T>& chunk = lastChunk();
+				const int n = qMin(count, ChunkSize - chunk.size());
+				const int oldSize = chunk.size();
+				chunk.resize(oldSize + n);
+				T* dest = chunk.data() + oldSize;
+				for (int i = 0; i < n; ++i)
+					dest[i] = src[i];
+				src += n;
+				count -= n;
+				m_size += n;
+			}
+		}
+
+		void append(const T& value) { append(&value, 1); }
+
+		/*!
+			appends \c count values of \c other starting at \c first.
+			Complete chunks of \c other are shared and not copied.
+		*/
+		void append(const ChunkedVector& other, int first, int count) {
+			if (count <= 0)
+				return;
+			int chunk = other.chunkIndex(first);
+			int offset = first - other.m_starts.at(chunk);
+			while (count > 0) {
+				const int chunkSize = other.m_chunks.at(chunk).size();
+				const int n = qMin(count, chunkSize - offset);
+				if (offset == 0 && n == chunkSize) {
+					m_starts.append(m_size);
+					m_chunks.append(other.m_chunks.at(chunk));
+					m_size += n;
+				} else
+					append(other.m_chunks.at(chunk).constData() + offset, n);
+				count -= n;
+				++chunk;
+				offset = 0;
+			}
+		}
+
+		/*!
+			returns \c count values starting at \c first.
+			The complete chunks within this range are shared with this vector.
+		*/
+		ChunkedVector mid(int first, int count) const {
+			ChunkedVector result;
+			result.append(*this, first, count);
+			return result;
+		}
+
+		/*!
+			replaces \c count values starting at \c first with the values of \c other starting at \c otherFirst.
+			The range has to be within the current size. Chunks that are replaced completely
+			are shared with \c other if the chunk boundaries of both ranges match.
+		*/
+		void replace(int first, const ChunkedVector& other, int otherFirst, int count) {
+			if (count <= 0)
+				return;
+			int chunk = chunkIndex(first);
+			int offset = first - m_starts.at(chunk);
+			int otherChunk = other.chunkIndex(otherFirst);
+			int otherOffset = otherFirst - other.m_starts.at(otherChunk);
+			while (count > 0) {
+				const int size = m_chunks.at(chunk).size();
+				const int otherSize = other.m_chunks.at(otherChunk).size();
+				const int n = qMin(count, qMin(size - offset, otherSize - otherOffset));
+				if (offset == 0 && otherOffset == 0 && n == size && n == otherSize)
+					m_chunks[chunk] = other.m_chunks.at(otherChunk);
+				else {
+					T* dest = m_chunks[chunk].data() + offset;
+					const T* src = other.m_chunks.at(otherChunk).constData() + otherOffset;
+					for (int i = 0; i < n; ++i)
+						dest[i] = src[i];
+				}
+				count -= n;
+				offset += n;
+				otherOffset += n;
+				if (offset == size) {
+					++chunk;
+					offset = 0;
+				}
+				if (otherOffset == otherSize) {
+					++otherChunk;
+					otherOffset = 0;
+				}
+			}
+		}
+
+		/*!
+			inserts \c count copies of \c value before position \c before.
+			Only the chunk containing \c before is modified.
+		*/
+		void insert(int before, int count, const T& value) {
+			if (count <= 0)
+				return;
+			if (before >= m_size) {
+				appendCopies(count, value);
+				return;
+			}
+
+			const int chunk = chunkIndex(before);
+			m_chunks[chunk].insert(before - m_starts.at(chunk), count, value);
+			m_size += count;
+			split(chunk);
+			updateStarts(chunk + 1);
+		}
+
+		/*!
+			removes \c count values starting at \c first.
+			Chunks that are removed completely are dropped without touching their values.
+		*/
+		void remove(int first, int count) {
+			if (count <= 0)
+				return;
+			if (first + count >= m_size) {
+				truncate(first);
+				return;
+			}
+
+			const int firstChunk = chunkIndex(first);
+			int chunk = firstChunk;
+			int offset = first - m_starts.at(chunk);
+			while (count > 0) {
+				const int n = qMin(count, m_chunks.at(chunk).size() - offset);
+				if (n == m_chunks.at(chunk).size()) {
+					m_chunks.remove(chunk);
+					m_starts.remove(chunk);
+				} else {
+					m_chunks[chunk].remove(offset, n);
+					++chunk;
+				}
+				count -= n;
+				m_size -= n;
+				offset = 0;
+			}
+
+			//the chunks at the boundaries of the removed range might have become small
+			merge(firstChunk);
+			merge(firstChunk - 1);
+			updateStarts(firstChunk - 1);
+		}
+
+		/*!
+			reorders the values, position \c i gets the value at position \c permutation[i].
+			Positions beyond the size of \c permutation are not changed.
+			Chunks whose values don't change stay shared with copies of this vector.
+		*/
+		void permute(const QVector<int>& permutation) {
+			const ChunkedVector source = *this;
+			detachChunkList();
+			for (int chunk = 0; chunk < m_chunks.size(); ++chunk)
+				gatherChunk(chunk, source, permutation);
+		}
+
+		/*!
+			sets the values of the chunk \c chunk to the values of \c source at the positions given by
+			\c permutation, see permute(). The chunk is only detached if one of its values changes.
+			After detachChunkList() different chunks can be gathered in parallel.
+		*/
+		void gatherChunk(int chunk, const ChunkedVector& source, const QVector<int>& permutation) {
+			const int start = m_starts.at(chunk);
+			const int size = qMin(m_chunks.at(chunk).size(), permutation.size() - start);
+			const int* perm = permutation.constData() + start;
+			const T* current = m_chunks.at(chunk).constData();
+			int i = 0;
+			//values are compared bitwise, NAN is equal to itself
+			while (i < size && memcmp(current + i, &source.at(perm[i]), sizeof(T)) == 0)
+				++i;
+			if (i >= size)
+				return;
+
+			T* dest = m_chunks[chunk].data();
+			for (; i < size; ++i)
+				dest[i] = source.at(perm[i]);
+		}
+
+		//! makes the list of chunks unshared, the chunks themselves stay shared
+		void detachChunkList() {
+			m_chunks.detach();
+			m_starts.detach();
+		}
+
+		void resize(int size, const T& value = T()) {
+			if (size < m_size)
+				truncate(size);
+			else
+				appendCopies(size - m_size, value);
+		}
+
+		void clear() {
+			m_chunks.clear();
+			m_starts.clear();
+			m_size = 0;
+		}
+
+		QVector<T> toVector() const {
+			QVector<T> vector(m_size);
+			read(0, m_size, vector.data());
+			return vector;
+		}
+
+	private:
+		//returns the last chunk, a new one is appended if it is full
+		QVector<T>& lastChunk() {
+			if (m_chunks.isEmpty() || m_chunks.last().size() >= ChunkSize) {
+				m_starts.append(m_size);
+				m_chunks.append(QVector<T>());
+			}
+			return m_chunks.last();
+		}
+
+		//full chunks of copies share one chunk, e.g. a large column of missing values
+		void appendCopies(int count, const T& value) {
+			QVector<T> full;
+			while (count > 0) {
+				if (count >= ChunkSize && (m_chunks.isEmpty() || m_chunks.last().size() >= ChunkSize)) {
+					if (full.isEmpty())
+						full.fill(value, ChunkSize);
+					m_starts.append(m_size);
+					m_chunks.append(full);
+					count -= ChunkSize;
+					m_size += ChunkSize;
+					continue;
+				}
+				QVector<T>& chunk = lastChunk();
+				const int n = qMin(count, ChunkSize - chunk.size());
+				chunk.insert(chunk.size(), n, value);
+				count -= n;
+				m_size += n;
+			}
+		}
+
+		void truncate(int size) {
+			if (size >= m_size)
+				return;
+			if (size <= 0) {
+				clear();
+				return;
+			}
+			const int chunk = chunkIndex(size - 1);
+			m_chunks.resize(chunk + 1);
+			m_starts.resize(chunk + 1);
+			m_chunks.last().resize(size - m_starts.at(chunk));
+			m_size = size;
+		}
+
+		//splits a chunk larger than ChunkSize into parts of equal size
+		void split(int chunk) {
+			const int size = m_chunks.at(chunk).size();
+			if (size <= ChunkSize)
+				return;
+
+			const int parts = (size + ChunkSize - 1)/ChunkSize;
+			const int partSize = (size + parts - 1)/parts;
+			const QVector<T> values = m_chunks.at(chunk);
+			m_chunks.insert(chunk + 1, parts - 1, QVector<T>());
+			m_starts.insert(chunk + 1, parts - 1, 0);
+			for (int i = 0; i < parts; ++i)
+				m_chunks[chunk + i] = values.mid(i*partSize, qMin(partSize, size - i*partSize));
+		}
+
+		//merges a chunk with its successor if one of them is small and both fit into one chunk
+		void merge(int chunk) {
+			if (chunk < 0 || chunk + 1 >= m_chunks.size())
+				return;
+			const int size = m_chunks.at(chunk).size();
+			const int nextSize = m_chunks.at(chunk + 1).size();
+			if ((size < MinChunkSize || nextSize < MinChunkSize) && size + nextSize <= ChunkSize) {
+				m_chunks[chunk] += m_chunks.at(chunk + 1);
+				m_chunks.remove(chunk + 1);
+				m_starts.remove(chunk + 1);
+			}
+		}
+
+		//recalculates the start positions beginning with the chunk \c chunk
+		void updateStarts(int chunk) {
+			if (m_starts.isEmpty())
+				return;
+			if (chunk <= 0) {
+				m_starts[0] = 0;
+				chunk = 1;
+			}
+			for (int i = chunk; i < m_chunks.size(); ++i)
+				m_starts[i] = m_starts.at(i - 1) + m_chunks.at(i - 1).size();
+		}
+
+		QVector< QVector<T> > m_chunks;
+		QVector<int> m_starts;	// position of the first element of every chunk
+		int m_size;
+};
+
+#endif
@@ -0,0 +1,244 @@
+/***************************************************************************
+    File                 : TextDictionary.cpp
+    Project              : LabPlot
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+    Description          : dictionary-encoded storage for text columns
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "TextDictionary.h"
+
+#include <QtAlgorithms>
+
+namespace {
+//orders dictionary codes by their strings
+class CodeLess {
+	public:
+		explicit CodeLess(const QVector<QString>& strings) : m_strings(strings) {}
+		bool operator()(int a, int b) const {
+			return m_strings.at(a) < m_strings.at(b);
+		}
+
+	private:
+		const QVector<QString>& m_strings;
+};
+}
+
+/*!
+	\class TextDictionary
+	\brief Dictionary-encoded list of strings, used as the data container of text columns.
+
+	Every row only holds an integer code. The distinct strings are stored once in a table
+	together with a reference count, so that columns with many rows but only a few
+	different values (status codes, channel names etc.) need about four bytes per row.
+	Codes of strings that are not referenced anymore are reused.
+	The codes are kept in a ChunkedVector, inserting or removing rows only moves the codes of one chunk.
+
+	Null strings are not put into the dictionary, they are represented by \c NullCode.
+	This keeps the distinction between null and empty strings that AbstractColumn::isValid() relies on.
+
+	\ingroup backend
+*/
+
+TextDictionary::TextDictionary() {
+}
+
+TextDictionary::TextDictionary(const QStringList& list) {
+	foreach (const QString& str, list)
+		m_codes.append(acquire(str));
+}
+
+/*!
+	returns the string in row \c row or a null string if \c row is out of range.
+*/
+QString TextDictionary::value(int row) const {
+	if (row < 0 || row >= m_codes.size())
+		return QString();
+	return text(m_codes.at(row));
+}
+
+/*!
+	returns \c count strings starting at row \c first, same semantics as QStringList::mid().
+*/
+QStringList TextDictionary::mid(int first, int count) const {
+	if (first < 0 || first >= m_codes.size())
+		return QStringList();
+	if (count < 0 || first + count > m_codes.size())
+		count = m_codes.size() - first;
+
+	QStringList list;
+	list.reserve(count);
+	for (int i = first; i < first + count; ++i)
+		list << text(m_codes.at(i));
+	return list;
+}
+
+QStringList TextDictionary::toStringList() const {
+	return mid(0);
+}
+
+/*!
+	returns the code used for the rows containing \c str.
+	\c NoCode is returned if no row contains \c str, \c NullCode for a null string.
+	Since equal strings share the same code, testing a whole column for equality
+	with a string only requires integer comparisons against codes().
+*/
+int TextDictionary::codeOf(const QString& str) const {
+	if (str.isNull())
+		return NullCode;
+	return m_lookup.value(str, NoCode);
+}
+
+/*!
+	returns the number of distinct non-null strings currently stored.
+*/
+int TextDictionary::dictionarySize() const {
+	return m_lookup.size();
+}
+
+/*!
+	returns for every row an integer key such that comparing the keys of two rows gives
+	the same result as comparing their strings with QString::operator<().
+	The keys are the ranks of the strings among the distinct strings, the strings are sorted
+	once per distinct value and not per row. Rows containing a null string get the key -1,
+	like invalid values in the sort keys of the other column modes.
+*/
+QVector<int> TextDictionary::sortKeys() const {
+	QVector<int> sortedCodes;
+	sortedCodes.reserve(m_lookup.size());
+	for (QHash<QString, int>::const_iterator it = m_lookup.constBegin(); it != m_lookup.constEnd(); ++it)
+		sortedCodes << it.value();
+
+	qSort(sortedCodes.begin(), sortedCodes.end(), CodeLess(m_strings));
+
+	QVector<int> ranks(m_strings.size(), -1);
+	for (int i = 0; i < sortedCodes.size(); ++i)
+		ranks[sortedCodes.at(i)] = i;
+
+	QVector<int> keys(m_codes.size());
+	m_codes.read(0, m_codes.size(), keys.data());
+	int* k = keys.data();
+	for (int i = 0; i < keys.size(); ++i)
+		k[i] = (k[i] < 0) ? -1 : ranks.at(k[i]);
+
+	return keys;
+}
+
+void TextDictionary::replace(int row, const QString& str) {
+	const int code = acquire(str);
+	release(m_codes.at(row));
+	m_codes.replace(row, code);
+}
+
+void TextDictionary::append(const QString& str) {
+	m_codes.append(acquire(str));
+}
+
+/*!
+	inserts \c count rows containing null strings before row \c before.
+*/
+void TextDictionary::insert(int before, int count) {
+	if (count > 0)
+		m_codes.insert(before, count, NullCode);
+}
+
+void TextDictionary::remove(int first, int count) {
+	if (count <= 0)
+		return;
+	for (int i = first; i < first + count; ++i)
+		release(m_codes.at(i));
+	m_codes.remove(first, count);
+}
+
+/*!
+	reorders the rows, row \c i gets the string of row \c permutation[i].
+	Only the codes are moved, the dictionary itself is not changed.
+	Chunks of codes that don't change stay shared with copies of this dictionary.
+*/
+void TextDictionary::permute(const QVector<int>& permutation) {
+	m_codes.permute(permutation);
+}
+
+/*!
+	resizes the list to \c size rows, new rows contain null strings.
+*/
+void TextDictionary::resize(int size) {
+	const int oldSize = m_codes.size();
+	if (size < oldSize)
+		remove(size, oldSize - size);
+	else if (size > oldSize)
+		m_codes.resize(size, NullCode);
+}
+
+void TextDictionary::clear() {
+	m_codes.clear();
+	m_strings.clear();
+	m_refCounts.clear();
+	m_freeCodes.clear();
+	m_lookup.clear();
+}
+
+/*!
+	returns the code for \c str and increases its reference count,
+	adds the string to the dictionary if not present yet.
+*/
+int TextDictionary::acquire(const QString& str) {
+	if (str.isNull())
+		return NullCode;
+
+	QHash<QString, int>::const_iterator it = m_lookup.constFind(str);
+	if (it != m_lookup.constEnd()) {
+		++m_refCounts[it.value()];
+		return it.value();
+	}
+
+	int code;
+	if (!m_freeCodes.isEmpty()) {
+		code = m_freeCodes.last();
+		m_freeCodes.removeLast();
+		m_strings[code] = str;
+		m_refCounts[code] = 1;
+	} else {
+		code = m_strings.size();
+		m_strings.append(str);
+		m_refCounts.append(1);
+	}
+	m_lookup.insert(str, code);
+
+	return code;
+}
+
+/*!
+	decreases the reference count of \c code and drops the string
+	from the dictionary if no row refers to it anymore.
+*/
+void TextDictionary::release(int code) {
+	if (code < 0)
+		return;
+
+	if (--m_refCounts[code] == 0) {
+		m_lookup.remove(m_strings.at(code));
+		m_strings[code] = QString();
+		m_freeCodes.append(code);
+	}
+}
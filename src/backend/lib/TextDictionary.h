@@ -0,0 +1,83 @@
+/***************************************************************************
+    File                 : TextDictionary.h
+    Project              : LabPlot
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+    Description          : dictionary-encoded storage for text columns
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TEXTDICTIONARY_H
+#define TEXTDICTIONARY_H
+
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+#include "backend/lib/ChunkedVector.h"
+
+//! Dictionary-encoded list of strings
+class TextDictionary {
+	public:
+		enum {
+			NullCode = -1,	//!< code of a row containing a null string
+			NoCode = -2	//!< returned by codeOf() for strings not contained in the dictionary
+		};
+
+		TextDictionary();
+		explicit TextDictionary(const QStringList&);
+
+		int size() const { return m_codes.size(); }
+		bool isEmpty() const { return m_codes.isEmpty(); }
+		QString at(int row) const { return text(m_codes.at(row)); }
+		QString value(int row) const;
+		QStringList mid(int first, int count = -1) const;
+		QStringList toStringList() const;
+
+		int codeAt(int row) const { return m_codes.at(row); }
+		const ChunkedVector<int>& codes() const { return m_codes; }
+		QString text(int code) const { return (code < 0) ? QString() : m_strings.at(code); }
+		int codeOf(const QString&) const;
+		int dictionarySize() const;
+		QVector<int> sortKeys() const;
+
+		void replace(int row, const QString&);
+		void append(const QString&);
+		TextDictionary& operator<<(const QString& str) { append(str); return *this; }
+		void insert(int before, int count);
+		void remove(int first, int count);
+		void permute(const QVector<int>& permutation);
+		void resize(int size);
+		void clear();
+
+	private:
+		int acquire(const QString&);
+		void release(int code);
+
+		ChunkedVector<int> m_codes;
+		QVector<QString> m_strings;
+		QVector<int> m_refCounts;
+		QVector<int> m_freeCodes;
+		QHash<QString, int> m_lookup;
+};
+
+#endif
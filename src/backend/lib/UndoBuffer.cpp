@@ -0,0 +1,103 @@
+/***************************************************************************
+    File                 : UndoBuffer.cpp
+    Project              : LabPlot
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+    Description          : compressed storage for the values of undo commands
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "UndoBuffer.h"
+
+#include <cstring>
+
+/*!
+	\class UndoBuffer
+	\brief Compressed values of an undo command.
+
+	Undo commands replacing large ranges of values store the values they need
+	to restore here instead of keeping them uncompressed. The values are compressed
+	with qCompress() in blocks of at most \c BlockSize values, so that the size of
+	a block always fits into a QByteArray, whatever the number of values.
+
+	\ingroup backend
+*/
+
+/*!
+	appends \c count values to the buffer.
+*/
+void UndoBuffer::append(const double* values, qint64 count) {
+	while (count > 0) {
+		const int n = (int)qMin(count, (qint64)BlockSize);
+		const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char*>(values), n*(int)sizeof(double));
+		m_blocks << qCompress(data, 1);
+		m_blockSizes << n;
+		m_size += n;
+		values += n;
+		count -= n;
+	}
+}
+
+/*!
+	uncompresses all values of the buffer to \c values, which has to hold size() values.
+*/
+void UndoBuffer::read(double* values) const {
+	read(0, m_size, values);
+}
+
+/*!
+	uncompresses the \c count values starting with value \c first to \c values.
+	Only the blocks containing these values are uncompressed.
+*/
+void UndoBuffer::read(qint64 first, qint64 count, double* values) const {
+	qint64 start = 0;	// index of the first value of the block
+	for (int i = 0; i < m_blocks.size() && count > 0; ++i) {
+		const int n = m_blockSizes.at(i);
+		if (start + n > first) {
+			const QByteArray data = qUncompress(m_blocks.at(i));
+			const int offset = (int)(first - start);
+			const int copy = (int)qMin(count, (qint64)(n - offset));
+			if (data.size() == n*(int)sizeof(double))
+				memcpy(values, data.constData() + offset*sizeof(double), copy*sizeof(double));
+			values += copy;
+			first += copy;
+			count -= copy;
+		}
+		start += n;
+	}
+}
+
+void UndoBuffer::clear() {
+	m_blocks.clear();
+	m_blockSizes.clear();
+	m_size = 0;
+}
+
+/*!
+	returns the number of bytes of the compressed values.
+*/
+qint64 UndoBuffer::memoryUsage() const {
+	qint64 usage = 0;
+	foreach (const QByteArray& block, m_blocks)
+		usage += block.size();
+	return usage;
+}
@@ -0,0 +1,60 @@
+/***************************************************************************
+    File                 : UndoBuffer.h
+    Project              : LabPlot
+    --------------------------------------------------------------------
+    Copyright            : (C) 2026 agent (agent@local)
+    Description          : compressed storage for the values of undo commands
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef UNDOBUFFER_H
+#define UNDOBUFFER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+//! Compressed values of an undo command
+class UndoBuffer {
+	public:
+		enum {
+			BlockSize = 1024*1024	//!< maximal number of values compressed together
+		};
+
+		UndoBuffer() : m_size(0) {}
+
+		void append(const double* values, qint64 count);
+		void read(double* values) const;
+		void read(qint64 first, qint64 count, double* values) const;
+		void clear();
+		qint64 size() const { return m_size; }
+		qint64 memoryUsage() const;
+
+	private:
+		Q_DISABLE_COPY(UndoBuffer)
+
+		QList<QByteArray> m_blocks;
+		QVector<int> m_blockSizes;	// number of values in the blocks
+		qint64 m_size;
+};
+
+#endif
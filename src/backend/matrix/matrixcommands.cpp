@@ -354,19 +354,46 @@ void MatrixMirrorVerticallyCmd::undo() {
 
 //replace values
 MatrixReplaceValuesCmd::MatrixReplaceValuesCmd(MatrixPrivate* private_obj, const QVector<QVector<double> >& new_values, QUndoCommand* parent)
- : QUndoCommand(parent), m_private_obj(private_obj), m_new_values(new_values)
+ : QUndoCommand(parent), m_private_obj(private_obj), m_new_values(new_values), m_executed(false)
 {
 	setText(i18n("%1: replace values", m_private_obj->name()));
 }
 
 void MatrixReplaceValuesCmd::redo() {
-	m_old_values = m_private_obj->matrixData;
-	m_private_obj->matrixData = m_new_values;
+	if (!m_executed) {
+		// only keep the compressed old and new values
+		store(m_private_obj->matrixData, m_old_data, m_old_sizes);
+		store(m_new_values, m_new_data, m_new_sizes);
+		m_private_obj->matrixData = m_new_values;
+		m_new_values.clear();
+		m_executed = true;
+	} else
+		m_private_obj->matrixData = restore(m_new_data, m_new_sizes);
+
 	m_private_obj->emitDataChanged(0, 0, m_private_obj->rowCount -1, m_private_obj->columnCount-1);
 }
 
 void MatrixReplaceValuesCmd::undo() {
-	m_new_values = m_private_obj->matrixData;
-	m_private_obj->matrixData = m_old_values;
+	m_private_obj->matrixData = restore(m_old_data, m_old_sizes);
 	m_private_obj->emitDataChanged(0, 0, m_private_obj->rowCount -1, m_private_obj->columnCount-1);
 }
+
+//compresses the columns of data into buffer, every column is compressed separately
+void MatrixReplaceValuesCmd::store(const QVector<QVector<double> >& data, UndoBuffer& buffer, QVector<int>& sizes) {
+	sizes.resize(data.size());
+	for (int i = 0; i < data.size(); ++i) {
+		sizes[i] = data.at(i).size();
+		buffer.append(data.at(i).constData(), data.at(i).size());
+	}
+}
+
+QVector<QVector<double> > MatrixReplaceValuesCmd::restore(const UndoBuffer& buffer, const QVector<int>& sizes) {
+	QVector<QVector<double> > data(sizes.size());
+	qint64 offset = 0;
+	for (int i = 0; i < sizes.size(); ++i) {
+		data[i].resize(sizes.at(i));
+		buffer.read(offset, sizes.at(i), data[i].data());
+		offset += sizes.at(i);
+	}
+	return data;
+}
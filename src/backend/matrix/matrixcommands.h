@@ -33,6 +33,7 @@
 #include <QUndoCommand>
 #include <QVector>
 #include "Matrix.h"
+#include "backend/lib/UndoBuffer.h"
 
 //! Insert columns
 class MatrixInsertColumnsCmd : public QUndoCommand {
@@ -246,9 +247,16 @@ class MatrixReplaceValuesCmd : public QUndoCommand {
 		virtual void undo();
 
 	private:
+		static void store(const QVector<QVector<double> >&, UndoBuffer&, QVector<int>& sizes);
+		static QVector<QVector<double> > restore(const UndoBuffer&, const QVector<int>& sizes);
+
 		MatrixPrivate* m_private_obj;
-		QVector<QVector<double> > m_old_values;
-		QVector<QVector<double> > m_new_values;
+		QVector<QVector<double> > m_new_values; // only kept until the command is executed the first time
+		UndoBuffer m_old_data;
+		UndoBuffer m_new_data;
+		QVector<int> m_old_sizes; // number of rows of the columns
+		QVector<int> m_new_sizes;
+		bool m_executed;
 };
 
 
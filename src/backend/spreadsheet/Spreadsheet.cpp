@@ -34,6 +34,8 @@
 #include "kdefrontend/spreadsheet/ExportSpreadsheetDialog.h"
 
 #include <QPrinter>
+#include <QRunnable>
+#include <QThreadPool>
 #include <QPrintDialog>
 #include <QPrintPreviewDialog>
 
@@ -41,6 +43,8 @@
 #include <KConfigGroup>
 #include <KLocale>
 
+#include <algorithm>
+
 /*!
   \class Spreadsheet
   \brief Aspect providing a spreadsheet table with column logic.
@@ -108,7 +112,7 @@ bool Spreadsheet::exportView() const {
 
 	dlg->setExportTo(QStringList() << i18n("FITS image") << i18n("FITS table"));
 	for (int i = 0; i < columnCount();++i) {
-		if (column(i)->columnMode() != AbstractColumn::Numeric) {
+		if (!AbstractColumn::isNumeric(column(i)->columnMode())) {
 			dlg->setExportToImage(false);
 			break;
         	}
@@ -283,12 +287,14 @@ void Spreadsheet::insertColumns(int before, int count)
 	beginMacro( i18np("%1: insert 1 column", "%1: insert %2 columns", name(), count) );
 	Column * before_col = column(before);
 	int rows = rowCount();
+	QList<AbstractAspect*> new_cols;
 	for (int i=0; i<count; i++) {
 		Column * new_col = new Column(QString::number(i+1), AbstractColumn::Numeric);
 		new_col->setPlotDesignation(AbstractColumn::Y);
 		new_col->insertRows(0, rows);
-		insertChildBefore(new_col, before_col);
+		new_cols << new_col;
 	}
+	insertChildrenBefore(new_cols, before_col);
 	endMacro();
 	RESET_CURSOR;
 }
@@ -430,6 +436,82 @@ int Spreadsheet::colY(int col)
 	return -1;
 }
 
+namespace {
+//computes the sort keys of one column
+class SortKeysTask : public QRunnable {
+	public:
+		SortKeysTask(const Column* column, QVector<int>* keys) : m_column(column), m_keys(keys) {}
+		virtual void run() {
+			*m_keys = m_column->sortKeys();
+		}
+
+	private:
+		const Column* m_column;
+		QVector<int>* m_keys;
+};
+
+//orders two rows by the sort keys of several columns, invalid values (key -1) are put at the end
+class RowLess {
+	public:
+		RowLess(const QVector< QVector<int> >& keys, const QList<bool>& ascending)
+			: m_keys(keys), m_ascending(ascending) {}
+
+		bool operator()(int a, int b) const {
+			for (int k = 0; k < m_keys.size(); ++k) {
+				const int keyA = m_keys.at(k).at(a);
+				const int keyB = m_keys.at(k).at(b);
+				if (keyA == keyB)
+					continue;
+				if (keyA == -1)
+					return false;
+				if (keyB == -1)
+					return true;
+				return m_ascending.at(k) ? (keyA < keyB) : (keyA > keyB);
+			}
+			return false;
+		}
+
+	private:
+		const QVector< QVector<int> >& m_keys;
+		const QList<bool>& m_ascending;
+};
+
+//sorts the rows in [start, end)
+class SortTask : public QRunnable {
+	public:
+		SortTask(int* rows, int start, int end, const RowLess& less)
+			: m_rows(rows), m_start(start), m_end(end), m_less(less) {}
+		virtual void run() {
+			qStableSort(m_rows + m_start, m_rows + m_end, m_less);
+		}
+
+	private:
+		int* m_rows;
+		int m_start;
+		int m_end;
+		RowLess m_less;
+};
+
+//merges the sorted ranges [start, middle) and [middle, end) of src into dest
+class MergeTask : public QRunnable {
+	public:
+		MergeTask(const int* src, int* dest, int start, int middle, int end, const RowLess& less)
+			: m_src(src), m_dest(dest), m_start(start), m_middle(middle), m_end(end), m_less(less) {}
+		virtual void run() {
+			// std::merge takes equal elements from the first range first, the merge is stable
+			std::merge(m_src + m_start, m_src + m_middle, m_src + m_middle, m_src + m_end, m_dest + m_start, m_less);
+		}
+
+	private:
+		const int* m_src;
+		int* m_dest;
+		int m_start;
+		int m_middle;
+		int m_end;
+		RowLess m_less;
+};
+}
+
 /*! Sorts the given list of column.
   If 'leading' is a null pointer, each column is sorted separately.
 */
@@ -437,226 +519,80 @@ void Spreadsheet::sortColumns(Column *leading, QList<Column*> cols, bool ascendi
 {
 	if(cols.isEmpty()) return;
 
-	// the normal QPair comparison does not work properly with descending sorting
-	// thefore we use our own compare functions
-	class CompareFunctions {
-		public:
-			static bool doubleLess(const QPair<double, int>& a, const QPair<double, int>& b)
-			{
-				return a.first < b.first;
-			}
-			static bool doubleGreater(const QPair<double, int>& a, const QPair<double, int>& b)
-			{
-				return a.first > b.first;
-			}
-			static bool QStringLess(const QPair<QString, int>& a, const QPair<QString, int>& b)
-			{
-				return a < b;
-			}
-			static bool QStringGreater(const QPair<QString, int>& a, const QPair<QString, int>& b)
-			{
-				return a > b;
-			}
-			static bool QDateTimeLess(const QPair<QDateTime, int>& a, const QPair<QDateTime, int>& b)
-			{
-				return a < b;
-			}
-			static bool QDateTimeGreater(const QPair<QDateTime, int>& a, const QPair<QDateTime, int>& b)
-			{
-				return a > b;
-			}
-	};
+	if(leading != 0) {
+		sortColumns(QList<Column*>() << leading, QList<bool>() << ascending, cols);
+		return;
+	}
+
+	WAIT_CURSOR;
+	beginMacro(i18n("%1: sort columns", name()));
+	foreach(Column *col, cols)
+		col->permuteRows(col->sortPermutation(ascending));
+	endMacro();
+	RESET_CURSOR;
+} // end of sortColumns()
+
+/*! Sorts the rows of the columns 'cols' by the values in the columns 'keys'.
+  Rows with equal values in the first key column are ordered by the second key column and so on,
+  'ascending' contains the sort order for every key column. Rows that are equal in all keys keep their order.
+*/
+void Spreadsheet::sortColumns(const QList<Column*>& keys, const QList<bool>& ascending, QList<Column*> cols)
+{
+	if(cols.isEmpty() || keys.isEmpty() || keys.size() != ascending.size()) return;
 
 	WAIT_CURSOR;
 	beginMacro(i18n("%1: sort columns", name()));
 
-	if(leading == 0) { // sort separately
-		foreach(Column *col, cols) {
-			switch (col->columnMode()) {
-				case AbstractColumn::Numeric:
-					{
-						int rows = col->rowCount();
-						QList< QPair<double, int> > map;
-
-						for(int j=0; j<rows; j++)
-							map.append(QPair<double, int>(col->valueAt(j), j));
-
-						if(ascending)
-							qStableSort(map.begin(), map.end(), CompareFunctions::doubleLess);
-						else
-							qStableSort(map.begin(), map.end(), CompareFunctions::doubleGreater);
-
-						QListIterator< QPair<double, int> > it(map);
-						Column *temp_col = new Column("temp", col->columnMode());
-
-						int k=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, k, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							k++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-						break;
-					}
-				case AbstractColumn::Text:
-					{
-						int rows = col->rowCount();
-						QList< QPair<QString, int> > map;
-
-						for(int j=0; j<rows; j++)
-							map.append(QPair<QString, int>(col->textAt(j), j));
-
-						if(ascending)
-							qStableSort(map.begin(), map.end(), CompareFunctions::QStringLess);
-						else
-							qStableSort(map.begin(), map.end(), CompareFunctions::QStringGreater);
-
-						QListIterator< QPair<QString, int> > it(map);
-						Column *temp_col = new Column("temp", col->columnMode());
-
-						int k=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, k, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							k++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-						break;
-					}
-				case AbstractColumn::DateTime:
-				case AbstractColumn::Month:
-				case AbstractColumn::Day:
-					{
-						int rows = col->rowCount();
-						QList< QPair<QDateTime, int> > map;
-
-						for(int j=0; j<rows; j++)
-							map.append(QPair<QDateTime, int>(col->dateTimeAt(j), j));
-
-						if(ascending)
-							qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeLess);
-						else
-							qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeGreater);
-
-						QListIterator< QPair<QDateTime, int> > it(map);
-						Column *temp_col = new Column("temp", col->columnMode());
-
-						int k=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, k, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							k++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-						break;
-					}
-			}
+	QVector<int> permutation;
+	if(keys.size() == 1) {
+		permutation = keys.first()->sortPermutation(ascending.first());
+	} else {
+		// the sort keys of the key columns are independent from each other and are calculated in parallel
+		// (in a pool of their own, waiting for the global pool would also wait for unrelated background jobs)
+		QThreadPool pool;
+		QVector< QVector<int> > sortKeys(keys.size());
+		for(int k = 0; k < keys.size(); ++k)
+			pool.start(new SortKeysTask(keys.at(k), &sortKeys[k]));
+		pool.waitForDone();
+
+		int rows = 0;
+		for(int k = 0; k < sortKeys.size(); ++k)
+			rows = qMax(rows, sortKeys.at(k).size());
+		for(int k = 0; k < sortKeys.size(); ++k)
+			sortKeys[k].resize(rows);
+		// rows beyond the end of a shorter key column have no value
+		for(int k = 0; k < keys.size(); ++k) {
+			for(int i = keys.at(k)->rowCount(); i < rows; ++i)
+				sortKeys[k][i] = -1;
 		}
-	} else { // sort with leading column
-		switch (leading->columnMode()) {
-			case AbstractColumn::Numeric:
-				{
-					QList< QPair<double, int> > map;
-					int rows = leading->rowCount();
-
-					for(int i=0; i<rows; i++)
-						map.append(QPair<double, int>(leading->valueAt(i), i));
-
-					if(ascending)
-						qStableSort(map.begin(), map.end(), CompareFunctions::doubleLess);
-					else
-						qStableSort(map.begin(), map.end(), CompareFunctions::doubleGreater);
-					QListIterator< QPair<double, int> > it(map);
-
-					foreach (Column *col, cols) {
-						Column *temp_col = new Column("temp", col->columnMode());
-						it.toFront();
-						int j=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, j, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							j++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-					}
-					break;
-				}
-			case AbstractColumn::Text:
-				{
-					QList< QPair<QString, int> > map;
-					int rows = leading->rowCount();
-
-					for(int i=0; i<rows; i++)
-						map.append(QPair<QString, int>(leading->textAt(i), i));
-
-					if(ascending)
-						qStableSort(map.begin(), map.end(), CompareFunctions::QStringLess);
-					else
-						qStableSort(map.begin(), map.end(), CompareFunctions::QStringGreater);
-					QListIterator< QPair<QString, int> > it(map);
-
-					foreach (Column *col, cols) {
-						Column *temp_col = new Column("temp", col->columnMode());
-						it.toFront();
-						int j=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, j, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							j++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-					}
-					break;
-				}
-			case AbstractColumn::DateTime:
-			case AbstractColumn::Month:
-			case AbstractColumn::Day:
-				{
-					QList< QPair<QDateTime, int> > map;
-					int rows = leading->rowCount();
-
-					for(int i=0; i<rows; i++)
-						map.append(QPair<QDateTime, int>(leading->dateTimeAt(i), i));
-
-					if(ascending)
-						qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeLess);
-					else
-						qStableSort(map.begin(), map.end(), CompareFunctions::QDateTimeGreater);
-					QListIterator< QPair<QDateTime, int> > it(map);
-
-					foreach (Column *col, cols) {
-						Column *temp_col = new Column("temp", col->columnMode());
-						it.toFront();
-						int j=0;
-						// put the values in the right order into temp_col
-						while(it.hasNext()) {
-							temp_col->copy(col, it.peekNext().second, j, 1);
-							temp_col->setMasked(col->isMasked(it.next().second));
-							j++;
-						}
-						// copy the sorted column
-						col->copy(temp_col, 0, 0, rows);
-						delete temp_col;
-					}
-					break;
-				}
+
+		// stable merge sort of the row indices: the blocks are sorted in parallel and then merged pairwise
+		const RowLess less(sortKeys, ascending);
+		permutation.resize(rows);
+		for(int i = 0; i < rows; ++i)
+			permutation[i] = i;
+
+		const int blockSize = qMax(1, (rows + pool.maxThreadCount() - 1)/pool.maxThreadCount());
+		for(int start = 0; start < rows; start += blockSize)
+			pool.start(new SortTask(permutation.data(), start, qMin(start + blockSize, rows), less));
+		pool.waitForDone();
+
+		QVector<int> buffer(rows);
+		for(int width = blockSize; width < rows; width *= 2) {
+			for(int start = 0; start < rows; start += 2*width) {
+				const int middle = qMin(start + width, rows);
+				const int end = qMin(start + 2*width, rows);
+				pool.start(new MergeTask(permutation.constData(), buffer.data(), start, middle, end, less));
+			}
+			pool.waitForDone();
+			permutation.swap(buffer);
 		}
 	}
+
+	// the row order is determined once, the columns are permuted in parallel
+	// and the undo commands of all columns share it
+	Column::permuteRows(cols, permutation);
+
 	endMacro();
 	RESET_CURSOR;
 } // end of sortColumns()
@@ -88,6 +88,7 @@ class Spreadsheet : public AbstractDataSource {
 
 		void moveColumn(int from, int to);
 		void sortColumns(Column* leading, QList<Column*> cols, bool ascending);
+		void sortColumns(const QList<Column*>& keys, const QList<bool>& ascending, QList<Column*> cols);
 
 	private:
 		void init();
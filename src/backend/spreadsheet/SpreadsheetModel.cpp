@@ -29,12 +29,15 @@
  ***************************************************************************/
 
 #include "backend/core/column/Column.h"
+#include "backend/core/datatypes/Double2StringFilter.h"
 #include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/spreadsheet/SpreadsheetModel.h"
 
 #include <QBrush>
 #include <QIcon>
 #include <QFontMetrics>
+#include <QLocale>
+#include <QTimer>
 
 #include <KLocale>
 
@@ -50,12 +53,25 @@
 	is obtained by calling Spreadsheet::column() and the manipulation is done using the
 	public API of column.
 
+	The formatted texts of the cells are cached in blocks of \c TextBlockSize rows of one column.
+	A block is formatted at once when the view requests one of its cells, so only the visible
+	blocks are formatted. The least recently used blocks are dropped when the cache is full,
+	the blocks of a column are invalidated when its data or its format changes.
+
+	Changes of the spreadsheet are forwarded as precise notifications: inserted and removed columns,
+	rows added or removed at the end and the changed range of the affected column.
+	The model keeps its own row and column counts, they are updated between the begin and end
+	calls of these notifications. The texts of the horizontal header are recalculated on demand,
+	changes of several columns are announced with one headerDataChanged() per event loop iteration.
+
 	\ingroup backend
 */
 SpreadsheetModel::SpreadsheetModel(Spreadsheet* spreadsheet)
-	: QAbstractItemModel(0), m_spreadsheet(spreadsheet), m_formula_mode(false) {
-	updateVerticalHeader();
-	updateHorizontalHeader();
+	: QAbstractItemModel(0), m_spreadsheet(spreadsheet), m_formula_mode(false),
+	  m_rowCount(spreadsheet->rowCount()), m_columnCount(spreadsheet->columnCount()),
+	  m_removedColumn(-1), m_removedColumnCount(0), m_headerChangeFirst(-1), m_headerChangeLast(-1), m_textCache(TextCacheSize) {
+	for (int i = 0; i < m_columnCount; ++i)
+		m_horizontal_header_data << QString();
 
 	connect(m_spreadsheet, SIGNAL(aspectAboutToBeAdded(const AbstractAspect*,const AbstractAspect*,const AbstractAspect*)),
 	        this, SLOT(handleAspectAboutToBeAdded(const AbstractAspect*,const AbstractAspect*,const AbstractAspect*)));
@@ -65,13 +81,17 @@ SpreadsheetModel::SpreadsheetModel(Spreadsheet* spreadsheet)
 	        this, SLOT(handleAspectAboutToBeRemoved(const AbstractAspect*)));
 	connect(m_spreadsheet, SIGNAL(aspectRemoved(const AbstractAspect*,const AbstractAspect*,const AbstractAspect*)),
 	        this, SLOT(handleAspectRemoved(const AbstractAspect*,const AbstractAspect*,const AbstractAspect*)));
+	connect(m_spreadsheet, SIGNAL(aspectsAdded(const AbstractAspect*,int,int)),
+	        this, SLOT(handleAspectsAdded(const AbstractAspect*,int,int)));
+	connect(m_spreadsheet, SIGNAL(aspectsAboutToBeRemoved(const AbstractAspect*,int,int)),
+	        this, SLOT(handleAspectsAboutToBeRemoved(const AbstractAspect*,int,int)));
+	connect(m_spreadsheet, SIGNAL(aspectsRemoved(const AbstractAspect*,int,int)),
+	        this, SLOT(handleAspectsRemoved(const AbstractAspect*,int,int)));
 	connect(m_spreadsheet, SIGNAL(aspectDescriptionChanged(const AbstractAspect*)),
 	        this, SLOT(handleDescriptionChange(const AbstractAspect*)));
 
-	for (int i=0; i < spreadsheet->columnCount(); i++) {
-		beginInsertColumns(QModelIndex(), i, i);
-		handleAspectAdded(spreadsheet->column(i));
-	}
+	for (int i = 0; i < m_columnCount; ++i)
+		connectColumn(spreadsheet->column(i));
 }
 
 Qt::ItemFlags SpreadsheetModel::flags(const QModelIndex& index) const {
@@ -96,9 +116,9 @@ QVariant SpreadsheetModel::data(const QModelIndex& index, int role) const {
 		case Qt::ToolTipRole: {
 			if(col_ptr->isValid(row)) {
 				if(col_ptr->isMasked(row))
-					return QVariant(i18n("%1, masked (ignored in all operations)").arg(col_ptr->asStringColumn()->textAt(row)));
+					return QVariant(i18n("%1, masked (ignored in all operations)").arg(text(col_ptr, row)));
 				else
-					return QVariant(col_ptr->asStringColumn()->textAt(row));
+					return QVariant(text(col_ptr, row));
 			} else {
 				if(col_ptr->isMasked(row))
 					return QVariant(i18n("invalid cell, masked (ignored in all operations)"));
@@ -108,7 +128,7 @@ QVariant SpreadsheetModel::data(const QModelIndex& index, int role) const {
 		}
 		case Qt::EditRole: {
 			if(col_ptr->isValid(row))
-				return QVariant(col_ptr->asStringColumn()->textAt(row));
+				return QVariant(text(col_ptr, row));
 
 			//m_formula_mode is not used at the moment
 			//if(m_formula_mode)
@@ -124,7 +144,7 @@ QVariant SpreadsheetModel::data(const QModelIndex& index, int role) const {
 			//if(m_formula_mode)
 			//	return QVariant(col_ptr->formula(row));
 
-			return QVariant(col_ptr->asStringColumn()->textAt(row));
+			return QVariant(text(col_ptr, row));
 		}
 		case Qt::ForegroundRole: {
 			if(!col_ptr->isValid(index.row()))
@@ -143,8 +163,8 @@ QVariant SpreadsheetModel::data(const QModelIndex& index, int role) const {
 }
 
 QVariant SpreadsheetModel::headerData(int section, Qt::Orientation orientation, int role) const {
-	if ( (orientation == Qt::Horizontal && section > m_spreadsheet->columnCount()-1)
-		|| (orientation == Qt::Vertical && section > m_spreadsheet->rowCount()-1) )
+	if ( (orientation == Qt::Horizontal && section > m_columnCount-1)
+		|| (orientation == Qt::Vertical && section > m_rowCount-1) )
 		return QVariant();
 
 	switch(orientation) {
@@ -153,7 +173,7 @@ QVariant SpreadsheetModel::headerData(int section, Qt::Orientation orientation,
 				case Qt::DisplayRole:
 				case Qt::ToolTipRole:
 				case Qt::EditRole:
-					return m_horizontal_header_data.at(section);
+					return horizontalHeaderText(section);
 				case Qt::DecorationRole:
 					return m_spreadsheet->child<Column>(section)->icon();
 				case SpreadsheetModel::CommentRole:
@@ -164,7 +184,7 @@ QVariant SpreadsheetModel::headerData(int section, Qt::Orientation orientation,
 			switch(role) {
 				case Qt::DisplayRole:
 				case Qt::ToolTipRole:
-					return m_vertical_header_data.at(section);
+					return section + 1;
 			}
 	}
 
@@ -173,12 +193,12 @@ QVariant SpreadsheetModel::headerData(int section, Qt::Orientation orientation,
 
 int SpreadsheetModel::rowCount(const QModelIndex& parent) const {
 	Q_UNUSED(parent)
-	return m_spreadsheet->rowCount();
+	return m_rowCount;
 }
 
 int SpreadsheetModel::columnCount(const QModelIndex& parent) const {
 	Q_UNUSED(parent)
-	return m_spreadsheet->columnCount();
+	return m_columnCount;
 }
 
 bool SpreadsheetModel::setData(const QModelIndex& index, const QVariant& value, int role) {
@@ -228,15 +248,9 @@ bool SpreadsheetModel::hasChildren(const QModelIndex& parent) const {
 }
 
 void SpreadsheetModel::handleAspectAboutToBeAdded(const AbstractAspect* parent, const AbstractAspect* before, const AbstractAspect* new_child) {
-	const Column* col = qobject_cast<const Column*>(new_child);
-
-	if (!col || parent != static_cast<AbstractAspect*>(m_spreadsheet))
-		return;
-
-	//TODO: breaks undo/redo
-	Q_UNUSED(before);
-// 	int index = before ? m_spreadsheet->indexOfChild<Column>(before) : 0;
-	//beginInsertColumns(QModelIndex(), index, index);
+	//the model keeps reporting the old column count until handleAspectAdded(),
+	//where the position of the new column is known
+	Q_UNUSED(parent) Q_UNUSED(before) Q_UNUSED(new_child)
 }
 
 void SpreadsheetModel::handleAspectAdded(const AbstractAspect * aspect) {
@@ -245,29 +259,35 @@ void SpreadsheetModel::handleAspectAdded(const AbstractAspect * aspect) {
 	if (!col || aspect->parentAspect() != static_cast<AbstractAspect*>(m_spreadsheet))
 		return;
 
-	updateVerticalHeader();
-	updateHorizontalHeader();
+	const int index = m_spreadsheet->indexOfChild<Column>(col);
+	insertColumns(index, index);
+}
 
-	connect(col, SIGNAL(plotDesignationChanged(const AbstractColumn*)), this,
-	        SLOT(handlePlotDesignationChange(const AbstractColumn*)));
-	connect(col, SIGNAL(modeChanged(const AbstractColumn*)), this,
-	        SLOT(handleDataChange(const AbstractColumn*)));
-	connect(col, SIGNAL(dataChanged(const AbstractColumn*)), this,
-	        SLOT(handleDataChange(const AbstractColumn*)));
-	connect(col, SIGNAL(modeChanged(const AbstractColumn*)), this,
-	        SLOT(handleModeChange(const AbstractColumn*)));
-	connect(col, SIGNAL(rowsInserted(const AbstractColumn*,int,int)), this,
-	        SLOT(handleRowsInserted(const AbstractColumn*,int,int)));
-	connect(col, SIGNAL(rowsRemoved(const AbstractColumn*,int,int)), this,
-	        SLOT(handleRowsRemoved(const AbstractColumn*,int,int)));
-	connect(col, SIGNAL(maskingChanged(const AbstractColumn*)), this,
-	        SLOT(handleDataChange(const AbstractColumn*)));
+/*!
+	columns added with AbstractAspect::insertChildrenBefore() are announced as one range
+ */
+void SpreadsheetModel::handleAspectsAdded(const AbstractAspect* parent, int first, int last) {
+	if (parent != static_cast<AbstractAspect*>(m_spreadsheet))
+		return;
 
-	beginResetModel();
-	//TODO: breaks undo/redo
-	//endInsertColumns();
-	endResetModel();
+	const int firstColumn = m_spreadsheet->indexOfChild<Column>(parent->child<AbstractAspect>(first));
+	const int lastColumn = m_spreadsheet->indexOfChild<Column>(parent->child<AbstractAspect>(last));
+	if (firstColumn == -1 || lastColumn == -1)
+		return;
 
+	insertColumns(firstColumn, lastColumn);
+}
+
+void SpreadsheetModel::insertColumns(int first, int last) {
+	beginInsertColumns(QModelIndex(), first, last);
+	for (int i = first; i <= last; ++i) {
+		m_horizontal_header_data.insert(i, QString());
+		connectColumn(m_spreadsheet->column(i));
+	}
+	m_columnCount += last - first + 1;
+	endInsertColumns();
+
+	updateVerticalHeader();
 	m_spreadsheet->emitColumnCountChanged();
 }
 
@@ -280,6 +300,9 @@ void SpreadsheetModel::handleAspectAboutToBeRemoved(const AbstractAspect* aspect
 	int index = m_spreadsheet->indexOfChild<Column>(col);
 	beginRemoveColumns(QModelIndex(), index, index);
 	disconnect(col, 0, this, 0);
+	invalidateTextCache(col);
+	m_removedColumn = index;
+	m_removedColumnCount = 1;
 }
 
 void SpreadsheetModel::handleAspectRemoved(const AbstractAspect* parent, const AbstractAspect* before, const AbstractAspect* child) {
@@ -289,13 +312,45 @@ void SpreadsheetModel::handleAspectRemoved(const AbstractAspect* parent, const A
 	if (!col || parent != static_cast<AbstractAspect*>(m_spreadsheet))
 		return;
 
-	updateVerticalHeader();
-	updateHorizontalHeader();
+	removeColumns();
+}
+
+void SpreadsheetModel::handleAspectsAboutToBeRemoved(const AbstractAspect* parent, int first, int last) {
+	if (parent != static_cast<AbstractAspect*>(m_spreadsheet))
+		return;
 
-	beginResetModel();
+	const int firstColumn = m_spreadsheet->indexOfChild<Column>(parent->child<AbstractAspect>(first));
+	const int lastColumn = m_spreadsheet->indexOfChild<Column>(parent->child<AbstractAspect>(last));
+	if (firstColumn == -1 || lastColumn == -1)
+		return;
+
+	beginRemoveColumns(QModelIndex(), firstColumn, lastColumn);
+	for (int i = firstColumn; i <= lastColumn; ++i) {
+		const Column* col = m_spreadsheet->column(i);
+		disconnect(col, 0, this, 0);
+		invalidateTextCache(col);
+	}
+	m_removedColumn = firstColumn;
+	m_removedColumnCount = lastColumn - firstColumn + 1;
+}
+
+void SpreadsheetModel::handleAspectsRemoved(const AbstractAspect* parent, int first, int last) {
+	Q_UNUSED(first) Q_UNUSED(last)
+	if (parent != static_cast<AbstractAspect*>(m_spreadsheet) || m_removedColumnCount == 0)
+		return;
+
+	removeColumns();
+}
+
+//finishes the removal of the columns started in handleAspectAboutToBeRemoved() or handleAspectsAboutToBeRemoved()
+void SpreadsheetModel::removeColumns() {
+	for (int i = 0; i < m_removedColumnCount; ++i)
+		m_horizontal_header_data.removeAt(m_removedColumn);
+	m_columnCount -= m_removedColumnCount;
+	m_removedColumnCount = 0;
 	endRemoveColumns();
-	endResetModel();
 
+	updateVerticalHeader();
 	m_spreadsheet->emitColumnCountChanged();
 }
 
@@ -305,98 +360,237 @@ void SpreadsheetModel::handleDescriptionChange(const AbstractAspect* aspect) {
 	if (!col || aspect->parentAspect() != static_cast<AbstractAspect*>(m_spreadsheet))
 		return;
 
-	updateHorizontalHeader();
 	int index = m_spreadsheet->indexOfChild<Column>(col);
-	emit headerDataChanged(Qt::Horizontal, index, index);
+	invalidateHorizontalHeader(index, index);
 }
 
 void SpreadsheetModel::handleModeChange(const AbstractColumn* col) {
-	updateHorizontalHeader();
 	int index = m_spreadsheet->indexOfChild<Column>(col);
-	emit headerDataChanged(Qt::Horizontal, index, index);
+	invalidateHorizontalHeader(index, index);
 }
 
 void SpreadsheetModel::handlePlotDesignationChange(const AbstractColumn* col) {
-	updateHorizontalHeader();
 	int index = m_spreadsheet->indexOfChild<Column>(col);
-	emit headerDataChanged(Qt::Horizontal, index, m_spreadsheet->columnCount()-1);
+	invalidateHorizontalHeader(index, m_columnCount-1);
 }
 
 void SpreadsheetModel::handleDataChange(const AbstractColumn* col) {
+	handleDataRangeChange(col, 0, -1);
+}
+
+/*!
+	the rows \c first to \c last (-1 for the last row) of \c col have changed, only these rows are repainted.
+	The number of rows of the column might have changed, too.
+*/
+void SpreadsheetModel::handleDataRangeChange(const AbstractColumn* col, int first, int last) {
+	invalidateTextCache(col, first, last);
+	if (col->rowCount() != m_rowCount)
+		updateVerticalHeader();
+
 	int i = m_spreadsheet->indexOfChild<Column>(col);
-	emit dataChanged(index(0, i), index(col->rowCount()-1, i));
+	if (last == -1 || last >= m_rowCount)
+		last = m_rowCount - 1;
+	if (first <= last)
+		emit dataChanged(index(first, i), index(last, i));
 }
 
 void SpreadsheetModel::handleRowsInserted(const AbstractColumn* col, int before, int count) {
-	Q_UNUSED(before) Q_UNUSED(count)
+	Q_UNUSED(count)
+	invalidateTextCache(col, before);
 	updateVerticalHeader();
+
+	//only the rows from the insertion on have changed in this column
 	int i = m_spreadsheet->indexOfChild<Column>(col);
-	emit dataChanged(index(0, i), index(col->rowCount()-1, i));
-	m_spreadsheet->emitRowCountChanged();
+	const int last = qMin(col->rowCount(), m_rowCount) - 1;
+	if (before <= last)
+		emit dataChanged(index(before, i), index(last, i));
 }
 
 void SpreadsheetModel::handleRowsRemoved(const AbstractColumn* col, int first, int count) {
-	Q_UNUSED(first) Q_UNUSED(count)
+	invalidateTextCache(col, first);
 	updateVerticalHeader();
+
+	//the rows from the first removed one up to the old end of this column have changed
 	int i = m_spreadsheet->indexOfChild<Column>(col);
-	emit dataChanged(index(0, i), index(col->rowCount()-1, i));
-	m_spreadsheet->emitRowCountChanged();
+	const int last = qMin(col->rowCount() + count, m_rowCount) - 1;
+	if (first <= last)
+		emit dataChanged(index(first, i), index(last, i));
 }
 
+void SpreadsheetModel::connectColumn(const Column* col) {
+	connect(col, SIGNAL(plotDesignationChanged(const AbstractColumn*)), this,
+	        SLOT(handlePlotDesignationChange(const AbstractColumn*)), Qt::UniqueConnection);
+	connect(col, SIGNAL(modeChanged(const AbstractColumn*)), this,
+	        SLOT(handleDataChange(const AbstractColumn*)), Qt::UniqueConnection);
+	connect(col, SIGNAL(dataRangeChanged(const AbstractColumn*,int,int)), this,
+	        SLOT(handleDataRangeChange(const AbstractColumn*,int,int)), Qt::UniqueConnection);
+	connect(col, SIGNAL(modeChanged(const AbstractColumn*)), this,
+	        SLOT(handleModeChange(const AbstractColumn*)), Qt::UniqueConnection);
+	connect(col, SIGNAL(rowsInserted(const AbstractColumn*,int,int)), this,
+	        SLOT(handleRowsInserted(const AbstractColumn*,int,int)), Qt::UniqueConnection);
+	connect(col, SIGNAL(rowsRemoved(const AbstractColumn*,int,int)), this,
+	        SLOT(handleRowsRemoved(const AbstractColumn*,int,int)), Qt::UniqueConnection);
+	connect(col, SIGNAL(maskingChanged(const AbstractColumn*)), this,
+	        SLOT(handleDataChange(const AbstractColumn*)), Qt::UniqueConnection);
+}
+
+/*!
+	returns the formatted text of the cell \c row of \c col.
+	The texts of all cells in the block containing \c row are formatted and cached.
+*/
+QString SpreadsheetModel::text(const Column* col, int row) const {
+	const int block = row/TextBlockSize;
+	const TextBlockKey key(col, block);
+	const QVector<QString>* texts = m_textCache.object(key);
+	if (texts)
+		return texts->value(row - block*TextBlockSize);
+
+	const int first = block*TextBlockSize;
+	const int count = qMax(0, qMin(TextBlockSize, col->rowCount() - first));
+	QVector<QString>* blockTexts = new QVector<QString>(count);
+	QString* dest = blockTexts->data();
+
+	switch(col->columnMode()) {
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float: {
+			// format the whole block with one locale instead of going through the output filter for every cell
+			const Double2StringFilter* filter = static_cast<const Double2StringFilter*>(col->outputFilter());
+			const char format = filter->numericFormat();
+			const int digits = filter->numDigits();
+			const QLocale locale;
+			QVector<double> values(count);
+			col->valuesAsDouble(first, count, values.data());
+			for (int i = 0; i < count; ++i) {
+				if (!std::isnan(values.at(i)))
+					dest[i] = locale.toString(values.at(i), format, digits);
+			}
+			break;
+		}
+		case AbstractColumn::Text:
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day: {
+			const AbstractColumn* strings = col->asStringColumn();
+			for (int i = 0; i < count; ++i)
+				dest[i] = strings->textAt(first + i);
+			break;
+		}
+	}
+
+	const QString result = blockTexts->value(row - first);
+	m_textCache.insert(key, blockTexts, qMax(1, count));
+	return result;
+}
+
+/*!
+	drops the cached texts of \c col of the blocks containing the rows \c firstRow to \c lastRow (-1 for the last row).
+*/
+void SpreadsheetModel::invalidateTextCache(const AbstractColumn* col, int firstRow, int lastRow) {
+	const int firstBlock = firstRow/TextBlockSize;
+	const int lastBlock = lastRow/TextBlockSize;
+	foreach (const TextBlockKey& key, m_textCache.keys()) {
+		if (key.first == col && key.second >= firstBlock && (lastRow == -1 || key.second <= lastBlock))
+			m_textCache.remove(key);
+	}
+}
+
+/*!
+	adds or removes rows at the end if the row count of the spreadsheet has changed.
+*/
 void SpreadsheetModel::updateVerticalHeader() {
-	int old_rows = m_vertical_header_data.size();
-	int new_rows = m_spreadsheet->rowCount();
+	const int old_rows = m_rowCount;
+	const int new_rows = m_spreadsheet->rowCount();
 
 	if (new_rows > old_rows) {
 		beginInsertRows(QModelIndex(), old_rows, new_rows-1);
-
-		for(int i=old_rows+1; i<=new_rows; i++)
-			m_vertical_header_data << i;
-
+		m_rowCount = new_rows;
 		endInsertRows();
 	} else if (new_rows < old_rows) {
 		beginRemoveRows(QModelIndex(), new_rows, old_rows-1);
+		m_rowCount = new_rows;
+		endRemoveRows();
+	} else
+		return;
 
-		while (m_vertical_header_data.size() > new_rows)
-			m_vertical_header_data.removeLast();
+	m_spreadsheet->emitRowCountChanged();
+}
 
-		endRemoveRows();
+/*!
+	marks the header texts of the columns \c first to \c last as outdated.
+	The views are notified once for all columns changed until the control returns to the event loop.
+*/
+void SpreadsheetModel::invalidateHorizontalHeader(int first, int last) {
+	last = qMin(last, m_columnCount - 1);
+	if (first < 0 || first > last)
+		return;
+
+	for (int i = first; i <= last; ++i)
+		m_horizontal_header_data[i] = QString();
+
+	if (m_headerChangeFirst == -1) {
+		m_headerChangeFirst = first;
+		m_headerChangeLast = last;
+		QTimer::singleShot(0, this, SLOT(updateHorizontalHeader()));
+	} else {
+		m_headerChangeFirst = qMin(m_headerChangeFirst, first);
+		m_headerChangeLast = qMax(m_headerChangeLast, last);
 	}
 }
 
+/*!
+	notifies the views about the header texts invalidated since the last call.
+*/
 void SpreadsheetModel::updateHorizontalHeader() {
-	int column_count = m_spreadsheet->childCount<Column>();
+	const int first = m_headerChangeFirst;
+	const int last = qMin(m_headerChangeLast, m_columnCount - 1);
+	m_headerChangeFirst = -1;
+	m_headerChangeLast = -1;
 
-	while(m_horizontal_header_data.size() < column_count)
-		m_horizontal_header_data << QString();
+	if (first != -1 && first <= last)
+		emit headerDataChanged(Qt::Horizontal, first, last);
+}
 
-	while(m_horizontal_header_data.size() > column_count)
-		m_horizontal_header_data.removeLast();
-
-	for (int i=0; i<column_count; i++) {
-		Column* col = m_spreadsheet->child<Column>(i);
-
-		QString type;
-		switch(col->columnMode()) {
-			case AbstractColumn::Numeric:
-				type = QLatin1String(" {") + i18n("Numeric") + QLatin1Char('}');
-				break;
-			case AbstractColumn::Text:
-				type = QLatin1String(" {") + i18n("Text") + QLatin1Char('}');
-				break;
-			case AbstractColumn::Month:
-				type = QLatin1String(" {") + i18n("Month names") + QLatin1Char('}');
-				break;
-			case AbstractColumn::Day:
-				type = QLatin1String(" {") + i18n("Day names") + QLatin1Char('}');
-				break;
-			case AbstractColumn::DateTime:
-				type = QLatin1String(" {") + i18n("Date and time") + QLatin1Char('}');
-				break;
-		}
+/*!
+	returns the header text of the column \c section, calculates it if it is outdated.
+*/
+QString SpreadsheetModel::horizontalHeaderText(int section) const {
+	if (!m_horizontal_header_data.at(section).isNull())
+		return m_horizontal_header_data.at(section);
+
+	const Column* col = m_spreadsheet->child<Column>(section);
 
-		m_horizontal_header_data.replace(i, col->name() + type);
+	QString type;
+	switch(col->columnMode()) {
+		case AbstractColumn::Numeric:
+			type = QLatin1String(" {") + i18n("Numeric") + QLatin1Char('}');
+			break;
+		case AbstractColumn::Integer:
+			type = QLatin1String(" {") + i18n("Integer") + QLatin1Char('}');
+			break;
+		case AbstractColumn::BigInt:
+			type = QLatin1String(" {") + i18n("Big integer") + QLatin1Char('}');
+			break;
+		case AbstractColumn::Float:
+			type = QLatin1String(" {") + i18n("Float") + QLatin1Char('}');
+			break;
+		case AbstractColumn::Text:
+			type = QLatin1String(" {") + i18n("Text") + QLatin1Char('}');
+			break;
+		case AbstractColumn::Month:
+			type = QLatin1String(" {") + i18n("Month names") + QLatin1Char('}');
+			break;
+		case AbstractColumn::Day:
+			type = QLatin1String(" {") + i18n("Day names") + QLatin1Char('}');
+			break;
+		case AbstractColumn::DateTime:
+			type = QLatin1String(" {") + i18n("Date and time") + QLatin1Char('}');
+			break;
 	}
+
+	m_horizontal_header_data[section] = col->name() + type;
+	return m_horizontal_header_data.at(section);
 }
 
 Column* SpreadsheetModel::column(int index) {
@@ -407,8 +601,8 @@ void SpreadsheetModel::activateFormulaMode(bool on) {
 	if (m_formula_mode == on) return;
 
 	m_formula_mode = on;
-	int rows = m_spreadsheet->rowCount();
-	int cols = m_spreadsheet->columnCount();
+	int rows = m_rowCount;
+	int cols = m_columnCount;
 
 	if (rows > 0 && cols > 0)
 		emit dataChanged(index(0,0), index(rows-1,cols-1));
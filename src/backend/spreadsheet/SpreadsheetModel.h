@@ -32,7 +32,9 @@
 #define SPREADSHEETMODEL_H
 
 #include <QAbstractItemModel>
+#include <QCache>
 #include <QStringList>
+#include <QVector>
 
 class Column;
 class Spreadsheet;
@@ -71,24 +73,47 @@ private slots:
 	void handleAspectAdded(const AbstractAspect*);
 	void handleAspectAboutToBeRemoved(const AbstractAspect*);
 	void handleAspectRemoved(const AbstractAspect* parent, const AbstractAspect* before, const AbstractAspect* child);
+	void handleAspectsAdded(const AbstractAspect* parent, int first, int last);
+	void handleAspectsAboutToBeRemoved(const AbstractAspect* parent, int first, int last);
+	void handleAspectsRemoved(const AbstractAspect* parent, int first, int last);
 
 	void handleDescriptionChange(const AbstractAspect*);
 	void handleModeChange(const AbstractColumn*);
 	void handlePlotDesignationChange(const AbstractColumn*);
 	void handleDataChange(const AbstractColumn*);
+	void handleDataRangeChange(const AbstractColumn*, int first, int last);
 	void handleRowsInserted(const AbstractColumn* col, int before, int count);
 	void handleRowsRemoved(const AbstractColumn* col, int first, int count);
 
+protected slots:
+	void updateHorizontalHeader();
+
 protected:
 	void updateVerticalHeader();
-	void updateHorizontalHeader();
+	void invalidateHorizontalHeader(int first, int last);
 
 private:
+	enum { TextBlockSize = 128, TextCacheSize = 128*2048 };
+	typedef QPair<const AbstractColumn*, int> TextBlockKey;
+
+	QString text(const Column*, int row) const;
+	QString horizontalHeaderText(int section) const;
+	void connectColumn(const Column*);
+	void insertColumns(int first, int last);
+	void removeColumns();
+	void invalidateTextCache(const AbstractColumn*, int firstRow = 0, int lastRow = -1);
+
 	Spreadsheet* m_spreadsheet;
 	bool m_formula_mode;
-	QList<int> m_vertical_header_data;
-	QStringList m_horizontal_header_data;
+	int m_rowCount;
+	int m_columnCount;
+	int m_removedColumn;
+	int m_removedColumnCount;
+	mutable QStringList m_horizontal_header_data; // null strings for outdated header texts
+	int m_headerChangeFirst;
+	int m_headerChangeLast;
 	int m_defaultHeaderHeight;
+	mutable QCache<TextBlockKey, QVector<QString> > m_textCache;
 };
 
 #endif
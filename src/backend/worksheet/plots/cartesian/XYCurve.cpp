@@ -44,6 +44,7 @@
 #include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/worksheet/Worksheet.h"
 #include "backend/lib/XmlStreamReader.h"
+#include "backend/lib/TextDictionary.h"
 #include "backend/lib/macros.h"
 
 #include <QPainter>
@@ -911,34 +912,82 @@ void XYCurvePrivate::retransform() {
 	AbstractColumn::ColumnMode xColMode = xColumn->columnMode();
 	AbstractColumn::ColumnMode yColMode = yColumn->columnMode();
 
+	//text columns are plotted as categories, the position of a category is the rank of its string
+	//among the distinct strings of the column. Unlike the dictionary codes this doesn't depend on the order of edits.
+	QVector<int> xCategories;
+	QVector<int> yCategories;
+	if (xColMode == AbstractColumn::Text) {
+		const Column* col = dynamic_cast<const Column*>(xColumn);
+		if (col)
+			xCategories = static_cast<const TextDictionary*>(col->data())->sortKeys();
+	}
+	if (yColMode == AbstractColumn::Text) {
+		const Column* col = dynamic_cast<const Column*>(yColumn);
+		if (col)
+			yCategories = static_cast<const TextDictionary*>(col->data())->sortKeys();
+	}
+
+	//date and time columns are converted to Julian days for all rows at once
+	QVector<double> xJulianDays;
+	QVector<double> yJulianDays;
+	if (xColMode == AbstractColumn::DateTime || xColMode == AbstractColumn::Month || xColMode == AbstractColumn::Day) {
+		const Column* col = dynamic_cast<const Column*>(xColumn);
+		if (col) {
+			xJulianDays.resize(col->rowCount());
+			col->julianDays(0, col->rowCount(), xJulianDays.data());
+		}
+	}
+	if (yColMode == AbstractColumn::DateTime || yColMode == AbstractColumn::Month || yColMode == AbstractColumn::Day) {
+		const Column* col = dynamic_cast<const Column*>(yColumn);
+		if (col) {
+			yJulianDays.resize(col->rowCount());
+			col->julianDays(0, col->rowCount(), yJulianDays.data());
+		}
+	}
+
 	//take over only valid and non masked points.
 	for (int row = startRow; row <= endRow; row++) {
-		if ( xColumn->isValid(row) && yColumn->isValid(row)
+		//for date and time columns invalid values are already NAN in the converted values
+		const bool xValid = xJulianDays.isEmpty() ? xColumn->isValid(row) : (row < xJulianDays.size() && !std::isnan(xJulianDays.at(row)));
+		const bool yValid = yJulianDays.isEmpty() ? yColumn->isValid(row) : (row < yJulianDays.size() && !std::isnan(yJulianDays.at(row)));
+		if ( xValid && yValid
 				&& (!xColumn->isMasked(row)) && (!yColumn->isMasked(row)) ) {
 
 			switch (xColMode) {
 			case AbstractColumn::Numeric:
+			case AbstractColumn::Integer:
+			case AbstractColumn::BigInt:
+			case AbstractColumn::Float:
 				tempPoint.setX(xColumn->valueAt(row));
 				break;
 			case AbstractColumn::Text:
-			//TODO
+				if (row < xCategories.size())
+					tempPoint.setX(xCategories.at(row));
+				break;
 			case AbstractColumn::DateTime:
 			case AbstractColumn::Month:
 			case AbstractColumn::Day:
-				//TODO
+				if (!xJulianDays.isEmpty())
+					tempPoint.setX(xJulianDays.at(row));
 				break;
 			}
 
 			switch (yColMode) {
 			case AbstractColumn::Numeric:
+			case AbstractColumn::Integer:
+			case AbstractColumn::BigInt:
+			case AbstractColumn::Float:
 				tempPoint.setY(yColumn->valueAt(row));
 				break;
 			case AbstractColumn::Text:
-			//TODO
+				if (row < yCategories.size())
+					tempPoint.setY(yCategories.at(row));
+				break;
 			case AbstractColumn::DateTime:
 			case AbstractColumn::Month:
 			case AbstractColumn::Day:
-				//TODO
+				if (!yJulianDays.isEmpty())
+					tempPoint.setY(yJulianDays.at(row));
 				break;
 			}
 			symbolPointsLogical.append(tempPoint);
@@ -1346,6 +1395,9 @@ void XYCurvePrivate::updateValues() {
 
 			switch (xColMode) {
 			case AbstractColumn::Numeric:
+			case AbstractColumn::Integer:
+			case AbstractColumn::BigInt:
+			case AbstractColumn::Float:
 				valuesStrings << valuesPrefix + QString::number(valuesColumn->valueAt(i)) + valuesSuffix;
 				break;
 			case AbstractColumn::Text:
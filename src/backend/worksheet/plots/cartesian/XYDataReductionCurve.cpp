@@ -37,6 +37,7 @@
 #include "XYDataReductionCurvePrivate.h"
 #include "CartesianCoordinateSystem.h"
 #include "backend/core/column/Column.h"
+#include "backend/lib/ChunkedVector.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
 
@@ -174,8 +175,8 @@ void XYDataReductionCurvePrivate::recalculate() {
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
 		yColumn = new Column("y", AbstractColumn::Numeric);
-		xVector = static_cast<QVector<double>* >(xColumn->data());
-		yVector = static_cast<QVector<double>* >(yColumn->data());
+		xVector = static_cast<ChunkedVector<double>* >(xColumn->data());
+		yVector = static_cast<ChunkedVector<double>* >(yColumn->data());
 
 		xColumn->setHidden(true);
 		q->addChild(xColumn);
@@ -300,11 +301,11 @@ void XYDataReductionCurvePrivate::recalculate() {
 
 	emit q->completed(80);
 
-	xVector->resize(npoints);
-	yVector->resize(npoints);
+	xVector->clear();
+	yVector->clear();
 	for (unsigned int i = 0; i < npoints; i++) {
-		(*xVector)[i] = xdata[index[i]];
-		(*yVector)[i] = ydata[index[i]];
+		xVector->append(xdata[index[i]]);
+		yVector->append(ydata[index[i]]);
 	}
 
 	emit q->completed(90);
@@ -451,8 +452,8 @@ bool XYDataReductionCurve::load(XmlStreamReader* reader) {
 		d->yColumn->setHidden(true);
 		addChild(d->yColumn);
 
-		d->xVector = static_cast<QVector<double>* >(d->xColumn->data());
-		d->yVector = static_cast<QVector<double>* >(d->yColumn->data());
+		d->xVector = static_cast<ChunkedVector<double>* >(d->xColumn->data());
+		d->yVector = static_cast<ChunkedVector<double>* >(d->yColumn->data());
 
 		setUndoAware(false);
 		XYCurve::d_ptr->xColumn = d->xColumn;
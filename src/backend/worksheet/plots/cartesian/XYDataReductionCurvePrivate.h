@@ -34,6 +34,7 @@
 
 class XYDataReductionCurve;
 class Column;
+template<class T> class ChunkedVector;
 
 class XYDataReductionCurvePrivate: public XYCurvePrivate {
 	public:
@@ -52,8 +53,8 @@ class XYDataReductionCurvePrivate: public XYCurvePrivate {
 
 		Column* xColumn; //<! column used internally for storing the x-values of the result data reduction curve
 		Column* yColumn; //<! column used internally for storing the y-values of the result data reduction curve
-		QVector<double>* xVector;
-		QVector<double>* yVector;
+		ChunkedVector<double>* xVector;
+		ChunkedVector<double>* yVector;
 
 		bool sourceDataChangedSinceLastDataReduction; //<! \c true if the data in the source columns (x, y) was changed, \c false otherwise
 
@@ -37,6 +37,7 @@
 #include "XYDifferentiationCurvePrivate.h"
 #include "CartesianCoordinateSystem.h"
 #include "backend/core/column/Column.h"
+#include "backend/lib/ChunkedVector.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
 
@@ -163,8 +164,8 @@ void XYDifferentiationCurvePrivate::recalculate() {
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
 		yColumn = new Column("y", AbstractColumn::Numeric);
-		xVector = static_cast<QVector<double>* >(xColumn->data());
-		yVector = static_cast<QVector<double>* >(yColumn->data());
+		xVector = static_cast<ChunkedVector<double>* >(xColumn->data());
+		yVector = static_cast<ChunkedVector<double>* >(yColumn->data());
 
 		xColumn->setHidden(true);
 		q->addChild(xColumn);
@@ -283,10 +284,10 @@ void XYDifferentiationCurvePrivate::recalculate() {
 		break;
 	}
 
-	xVector->resize(n);
-	yVector->resize(n);
-	memcpy(xVector->data(), xdata, n*sizeof(double));
-	memcpy(yVector->data(), ydata, n*sizeof(double));
+	xVector->clear();
+	yVector->clear();
+	xVector->append(xdata, n);
+	yVector->append(ydata, n);
 ///////////////////////////////////////////////////////////
 
 	//write the result
@@ -407,8 +408,8 @@ bool XYDifferentiationCurve::load(XmlStreamReader* reader) {
 		d->yColumn->setHidden(true);
 		addChild(d->yColumn);
 
-		d->xVector = static_cast<QVector<double>* >(d->xColumn->data());
-		d->yVector = static_cast<QVector<double>* >(d->yColumn->data());
+		d->xVector = static_cast<ChunkedVector<double>* >(d->xColumn->data());
+		d->yVector = static_cast<ChunkedVector<double>* >(d->yColumn->data());
 
 		setUndoAware(false);
 		XYCurve::d_ptr->xColumn = d->xColumn;
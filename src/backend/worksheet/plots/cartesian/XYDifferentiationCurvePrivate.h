@@ -34,6 +34,7 @@
 
 class XYDifferentiationCurve;
 class Column;
+template<class T> class ChunkedVector;
 
 class XYDifferentiationCurvePrivate: public XYCurvePrivate {
 	public:
@@ -52,8 +53,8 @@ class XYDifferentiationCurvePrivate: public XYCurvePrivate {
 
 		Column* xColumn; //<! column used internally for storing the x-values of the result differentiation curve
 		Column* yColumn; //<! column used internally for storing the y-values of the result differentiation curve
-		QVector<double>* xVector;
-		QVector<double>* yVector;
+		ChunkedVector<double>* xVector;
+		ChunkedVector<double>* yVector;
 
 		XYDifferentiationCurve* const q;
 };
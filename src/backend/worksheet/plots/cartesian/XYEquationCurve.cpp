@@ -37,12 +37,158 @@
 #include "XYEquationCurvePrivate.h"
 #include "backend/core/AbstractColumn.h"
 #include "backend/core/column/Column.h"
+#include "backend/lib/ChunkedVector.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/gsl/ExpressionParser.h"
+#include "backend/worksheet/Worksheet.h"
+
+extern "C" {
+#include "backend/gsl/parser.h"
+}
+#include <cmath>
 
 #include <QIcon>
+#include <QtConcurrent/QtConcurrentRun>
 #include <KLocale>
 
+namespace {
+//number of calculated samples kept for reuse
+const int EquationCacheSize = 3;
+//minimal number of values to calculate in a background thread
+const int BackgroundEvaluationSize = 100000;
+
+//number of points the adaptive sampling starts with
+const int AdaptiveInitialCount = 65;
+//maximal number of bisections of the initial intervals in the adaptive sampling
+const int AdaptiveMaxDepth = 20;
+//maximal angle in degrees between two neighbouring segments of the adaptively sampled curve
+const double AdaptiveMaxAngle = 10.0;
+
+/*
+	calculates the x- and y-values of the equation of the type \c type for the parameter values \c parameter.
+*/
+bool evaluate(XYEquationCurve::EquationType type, const QString& expression1, const QString& expression2,
+		const QVector<double>& parameter, QVector<double>& x, QVector<double>& y) {
+	ExpressionParser* parser = ExpressionParser::getInstance();
+	x.resize(parameter.size());
+	y.resize(parameter.size());
+	if (type == XYEquationCurve::Cartesian) {
+		x = parameter;
+		return parser->evaluateCartesian(expression1, &x, &y);
+	} else if (type == XYEquationCurve::Polar) {
+		return parser->evaluatePolar(expression1, parameter, &x, &y);
+	} else if (type == XYEquationCurve::Parametric) {
+		return parser->evaluateParametric(expression1, expression2, parameter, &x, &y);
+	}
+
+	return false;
+}
+
+/*
+	calculates the values of \c samples at the positions \c missing, the other values were taken from the cache.
+	Only works on copies of the data and is called in a background thread for large numbers of values.
+*/
+XYEquationCurvePrivate::Samples evaluateSamples(XYEquationCurvePrivate::Samples samples, const QVector<int>& missing) {
+	const int count = missing.size();
+	QVector<double> parameter(count);
+	for (int i = 0; i < count; ++i)
+		parameter[i] = samples.parameter.at(missing.at(i));
+
+	QVector<double> x;
+	QVector<double> y;
+	samples.valid = evaluate(samples.type, samples.expression1, samples.expression2, parameter, x, y);
+	if (!samples.valid)
+		return samples;
+
+	double* xData = samples.x.data();
+	double* yData = samples.y.data();
+	for (int i = 0; i < count; ++i) {
+		xData[missing.at(i)] = x.at(i);
+		yData[missing.at(i)] = y.at(i);
+	}
+	return samples;
+}
+
+/*
+	position of \c value on an axis with the range [\c min, \c max] and the scale \c scale,
+	0 and 1 correspond to the ends of the axis. Range breaks are not taken into account.
+*/
+double axisPosition(double value, double min, double max, CartesianPlot::Scale scale) {
+	switch (scale) {
+	case CartesianPlot::ScaleLinear:
+		break;
+	case CartesianPlot::ScaleLog10:
+	case CartesianPlot::ScaleLog2:
+	case CartesianPlot::ScaleLn:
+		if (value <= 0 || min <= 0 || max <= 0)
+			return NAN;
+		value = log(value);
+		min = log(min);
+		max = log(max);
+		break;
+	case CartesianPlot::ScaleSqrt:
+		if (value < 0 || min < 0 || max < 0)
+			return NAN;
+		value = sqrt(value);
+		min = sqrt(min);
+		max = sqrt(max);
+		break;
+	case CartesianPlot::ScaleX2:
+		value *= value;
+		min *= min;
+		max *= max;
+		break;
+	}
+
+	return (value - min)/(max - min);
+}
+
+QPointF scenePoint(double x, double y, const XYEquationCurvePrivate::View& view) {
+	return QPointF(axisPosition(x, view.xMin, view.xMax, view.xScale)*view.size.width(),
+			axisPosition(y, view.yMin, view.yMax, view.yScale)*view.size.height());
+}
+
+bool isFinite(const QPointF& point) {
+	return std::isfinite(point.x()) && std::isfinite(point.y());
+}
+
+/*
+	decides whether the interval with the end points \c a and \c b and the midpoint \c m (in scene coordinates)
+	has to be bisected: if the midpoint deviates from the chord by more than \c tolerance or the curve bends
+	by more than the maximal angle. Intervals outside of the plot area of the size \c size are not refined,
+	intervals with undefined values are refined towards the boundaries of the domain of the equation.
+*/
+bool needsRefinement(const QPointF& a, const QPointF& m, const QPointF& b, const QSizeF& size, double tolerance, double minCos) {
+	const bool finiteA = isFinite(a);
+	const bool finiteM = isFinite(m);
+	const bool finiteB = isFinite(b);
+	if (!finiteA || !finiteM || !finiteB)
+		return finiteA || finiteM || finiteB;
+
+	if ( (a.x() < 0 && m.x() < 0 && b.x() < 0) || (a.x() > size.width() && m.x() > size.width() && b.x() > size.width())
+		|| (a.y() < 0 && m.y() < 0 && b.y() < 0) || (a.y() > size.height() && m.y() > size.height() && b.y() > size.height()) )
+		return false;
+
+	//distance of the midpoint from the chord
+	const QPointF ab = b - a;
+	const QPointF am = m - a;
+	const double chord = ab.x()*ab.x() + ab.y()*ab.y();
+	const double u = (chord > 0) ? qBound(0.0, (am.x()*ab.x() + am.y()*ab.y())/chord, 1.0) : 0.0;
+	const QPointF deviation = am - u*ab;
+	if (hypot(deviation.x(), deviation.y()) > tolerance)
+		return true;
+
+	//angle between the two halves, only relevant if the interval is visible at all
+	const QPointF mb = b - m;
+	const double l1 = hypot(am.x(), am.y());
+	const double l2 = hypot(mb.x(), mb.y());
+	if (l1 + l2 > tolerance && l1 > 0 && l2 > 0)
+		return (am.x()*mb.x() + am.y()*mb.y())/(l1*l2) < minCos;
+
+	return false;
+}
+}
+
 XYEquationCurve::XYEquationCurve(const QString& name)
 		: XYCurve(name, new XYEquationCurvePrivate(this)) {
 	init();
@@ -76,6 +222,8 @@ void XYEquationCurve::init() {
 	setXColumn(d->xColumn);
 	setYColumn(d->yColumn);
 	setUndoAware(true);
+
+	connect(&d->evaluationWatcher, SIGNAL(finished()), this, SLOT(evaluationFinished()));
 }
 
 void XYEquationCurve::recalculate() {
@@ -90,6 +238,23 @@ QIcon XYEquationCurve::icon() const {
 	return QIcon::fromTheme("labplot-xy-equation-curve");
 }
 
+/*!
+	In the adaptive sampling mode the values are recalculated first if the range, the scales or the size
+	of the plot were changed since the last sampling.
+*/
+void XYEquationCurve::retransform() {
+	Q_D(XYEquationCurve);
+	if (d->equationData.adaptive && !d->sampling && d->currentView() != d->sampledView)
+		d->recalculate();
+
+	XYCurve::retransform();
+}
+
+void XYEquationCurve::evaluationFinished() {
+	Q_D(XYEquationCurve);
+	d->evaluationFinished();
+}
+
 //##############################################################################
 //##########################  getter methods  ##################################
 //##############################################################################
@@ -101,11 +266,13 @@ BASIC_SHARED_D_READER_IMPL(XYEquationCurve, XYEquationCurve::EquationData, equat
 STD_SETTER_CMD_IMPL_F_S(XYEquationCurve, SetEquationData, XYEquationCurve::EquationData, equationData, recalculate);
 void XYEquationCurve::setEquationData(const XYEquationCurve::EquationData& equationData) {
 	Q_D(XYEquationCurve);
-	if ( (equationData.expression1 != d->equationData.expression1)
+	if ( (equationData.type != d->equationData.type)
+		|| (equationData.expression1 != d->equationData.expression1)
 		|| (equationData.expression2 != d->equationData.expression2)
 		|| (equationData.min != d->equationData.min)
 		|| (equationData.max != d->equationData.max)
-		|| (equationData.count != d->equationData.count) )
+		|| (equationData.count != d->equationData.count)
+		|| (equationData.adaptive != d->equationData.adaptive) )
 		exec(new XYEquationCurveSetEquationDataCmd(d, equationData, i18n("%1: set equation")));
 }
 
@@ -115,8 +282,10 @@ void XYEquationCurve::setEquationData(const XYEquationCurve::EquationData& equat
 XYEquationCurvePrivate::XYEquationCurvePrivate(XYEquationCurve* owner) : XYCurvePrivate(owner),
 	xColumn(new Column("x", AbstractColumn::Numeric)),
 	yColumn(new Column("y", AbstractColumn::Numeric)),
-	xVector(static_cast<QVector<double>* >(xColumn->data())),
-	yVector(static_cast<QVector<double>* >(yColumn->data())),
+	xVector(static_cast<ChunkedVector<double>* >(xColumn->data())),
+	yVector(static_cast<ChunkedVector<double>* >(yColumn->data())),
+	evaluationId(0),
+	sampling(false),
 	q(owner)  {
 
 }
@@ -126,45 +295,272 @@ XYEquationCurvePrivate::~XYEquationCurvePrivate() {
 	//when the parent aspect is removed
 }
 
+/*!
+	recalculates the values of the curve.
+	Values that were already calculated for the same equation and parameter value are taken from the cache,
+	so refining the grid such that it contains the previous one (e.g. from N to 2N-1 points) or shifting
+	the range by whole steps only calculates the new values. Other changes of the number of points,
+	like doubling it, share only the end points with the previous grid. Large numbers of values are calculated in the background,
+	the curve is updated in evaluationFinished().
+	In the adaptive sampling mode the number of points is the maximal number of points and the values
+	are calculated for the current range of the plot in sampleAdaptively().
+*/
 void XYEquationCurvePrivate::recalculate() {
-	//resize the vector if a new number of point to calculate was provided
-	if (equationData.count != xVector->size()) {
-		if (equationData.count >= 1) {
-			xVector->resize(equationData.count);
-			yVector->resize(equationData.count);
-		} else {
-			//invalid number of points provided
-			xVector->clear();
-			yVector->clear();
-			emit (q->dataChanged());
-			return;
+	//the result of a still running evaluation is not needed anymore
+	++evaluationId;
+
+	if (equationData.count < 1) {
+		//invalid number of points provided
+		xVector->clear();
+		yVector->clear();
+		emit (q->dataChanged());
+		return;
+	}
+
+	ExpressionParser::getInstance();	//initializes the symbol table of the parser
+	const double minValue = parse(equationData.min.toLocal8Bit().data());
+	const double maxValue = parse(equationData.max.toLocal8Bit().data());
+
+	Samples samples;
+	samples.id = evaluationId;
+	samples.type = equationData.type;
+	samples.expression1 = equationData.expression1;
+	samples.expression2 = equationData.expression2;
+
+	if (equationData.adaptive) {
+		sampledView = currentView();
+		sampleAdaptively(samples, minValue, maxValue, sampledView);
+
+		//the plot retransforms the curve when the data was changed, no further sampling is required for this
+		sampling = true;
+		setSamples(samples);
+		sampling = false;
+		return;
+	}
+
+	const int count = equationData.count;
+	const double step = (maxValue - minValue)/(double)(count - 1);
+
+	samples.parameter.resize(count);
+	for (int i = 0; i < count; ++i)
+		samples.parameter[i] = minValue + step*i;
+	samples.x.resize(count);
+	samples.y.resize(count);
+
+	QVector<int> missing;
+	if (reuseSamples(samples, missing))
+		setSamples(samples);
+	else if (missing.size() < BackgroundEvaluationSize)
+		setSamples(evaluateSamples(samples, missing));
+	else
+		evaluationWatcher.setFuture(QtConcurrent::run(evaluateSamples, samples, missing));
+}
+
+void XYEquationCurvePrivate::evaluationFinished() {
+	const Samples samples = evaluationWatcher.result();
+
+	//ignore the results of evaluations that were superseded by a later recalculation
+	if (samples.id == evaluationId)
+		setSamples(samples);
+}
+
+/*!
+	copies the values of \c samples that were already calculated for the same equation from the cache.
+	The cached parameter values form equidistant grids, the position of a parameter value in a grid is
+	calculated directly and the value is only taken if the parameter values are exactly equal.
+	Values can only be reused if the grids nest, the function values in between are not interpolated.
+	The indices of the values still to be calculated are returned in \c missing.
+	Returns \c true if all values were found.
+*/
+bool XYEquationCurvePrivate::reuseSamples(Samples& samples, QVector<int>& missing) const {
+	const int count = samples.parameter.size();
+	QVector<bool> found(count, false);
+	double* x = samples.x.data();
+	double* y = samples.y.data();
+
+	foreach (const Samples& cached, cache) {
+		if (cached.type != samples.type || cached.expression1 != samples.expression1 || cached.expression2 != samples.expression2)
+			continue;
+
+		const int n = cached.parameter.size();
+		const double first = cached.parameter.first();
+		const double step = (n > 1) ? (cached.parameter.last() - first)/(n - 1) : 1.0;
+		if (!std::isfinite(step) || step == 0)
+			continue;
+
+		for (int i = 0; i < count; ++i) {
+			if (found.at(i))
+				continue;
+
+			const double position = (samples.parameter.at(i) - first)/step;
+			if (!(position > -0.5 && position < n - 0.5))
+				continue;
+
+			const int j = qRound(position);
+			if (cached.parameter.at(j) == samples.parameter.at(i)) {
+				x[i] = cached.x.at(j);
+				y[i] = cached.y.at(j);
+				found[i] = true;
+			}
 		}
-	} else {
-		if (equationData.count < 1)
-			return;
 	}
 
-	ExpressionParser* parser = ExpressionParser::getInstance();
-	bool rc = false;
-	if (equationData.type == XYEquationCurve::Cartesian) {
-		rc = parser->evaluateCartesian( equationData.expression1, equationData.min, equationData.max,
-						equationData.count, xVector, yVector );
-	} else if (equationData.type == XYEquationCurve::Polar) {
-		rc = parser->evaluatePolar( equationData.expression1, equationData.min, equationData.max,
-						equationData.count, xVector, yVector );
-	} else if (equationData.type == XYEquationCurve::Parametric) {
-		rc = parser->evaluateParametric(equationData.expression1, equationData.expression2,
-						equationData.min, equationData.max, equationData.count,
-						xVector, yVector);
+	for (int i = 0; i < count; ++i) {
+		if (!found.at(i))
+			missing << i;
 	}
 
-	if (!rc) {
+	samples.valid = missing.isEmpty();
+	return samples.valid;
+}
+
+void XYEquationCurvePrivate::setSamples(const Samples& samples) {
+	if (samples.valid) {
+		*xVector = ChunkedVector<double>(samples.x);
+		*yVector = ChunkedVector<double>(samples.y);
+	} else {
 		xVector->clear();
 		yVector->clear();
 	}
+
+	//keep the samples for later reuse, adaptively calculated values depend on the plot range and are not kept
+	if (samples.valid && !equationData.adaptive) {
+
+		//an older entry for the same grid is replaced
+		for (int i = cache.size() - 1; i >= 0; --i) {
+			const Samples& cached = cache.at(i);
+			if (cached.type == samples.type && cached.expression1 == samples.expression1
+				&& cached.expression2 == samples.expression2 && cached.parameter == samples.parameter)
+				cache.removeAt(i);
+		}
+		cache.prepend(samples);
+		while (cache.size() > EquationCacheSize)
+			cache.removeLast();
+	}
+
 	emit (q->dataChanged());
 }
 
+/*!
+	returns the range, the scales and the size of the plot the curve is shown in.
+	The view is invalid if the curve was not added to a plot yet.
+*/
+XYEquationCurvePrivate::View XYEquationCurvePrivate::currentView() const {
+	View view;
+	CartesianPlot* plot = dynamic_cast<CartesianPlot*>(q->parentAspect());
+	if (!plot)
+		return view;
+
+	view.xMin = plot->xMin();
+	view.xMax = plot->xMax();
+	view.yMin = plot->yMin();
+	view.yMax = plot->yMax();
+	view.xScale = plot->xScale();
+	view.yScale = plot->yScale();
+	view.size = plot->plotRect().size();
+	view.valid = !view.size.isEmpty();
+	return view;
+}
+
+bool XYEquationCurvePrivate::View::operator==(const View& other) const {
+	return valid == other.valid && xMin == other.xMin && xMax == other.xMax && yMin == other.yMin && yMax == other.yMax
+		&& xScale == other.xScale && yScale == other.yScale && size == other.size;
+}
+
+/*!
+	calculates the values of the equation in [\c minValue, \c maxValue] adaptively for the plot view \c view.
+	Starting with a coarse equidistant grid, the parameter intervals are bisected as long as the midpoint
+	deviates from the chord by more than 0.1 mm or the curve bends by more than AdaptiveMaxAngle degrees
+	in the plot. The bisection is done level by level, all new parameter values of one level are calculated at once.
+	The refinement stops after AdaptiveMaxDepth levels or when the maximal number of points is reached.
+	Without a valid view only the initial grid is calculated.
+*/
+void XYEquationCurvePrivate::sampleAdaptively(Samples& samples, double minValue, double maxValue, const View& view) const {
+	const int maxCount = equationData.count;
+	int count = qMin(maxCount, AdaptiveInitialCount);
+	const double step = (count > 1) ? (maxValue - minValue)/(double)(count - 1) : 0.0;
+	QVector<double>& parameter = samples.parameter;
+	parameter.resize(count);
+	for (int i = 0; i < count; ++i)
+		parameter[i] = minValue + step*i;
+
+	samples.valid = evaluate(samples.type, samples.expression1, samples.expression2, parameter, samples.x, samples.y);
+	if (!samples.valid || !view.valid || count < 2)
+		return;
+
+	const double tolerance = Worksheet::convertToSceneUnits(0.1, Worksheet::Millimeter);
+	const double minCos = cos(AdaptiveMaxAngle*M_PI/180.0);
+
+	QVector<QPointF> points(count);
+	for (int i = 0; i < count; ++i)
+		points[i] = scenePoint(samples.x.at(i), samples.y.at(i), view);
+
+	//intervals to bisect in the next level, all intervals of the initial grid are checked
+	QVector<bool> refine(count - 1, true);
+
+	for (int depth = 0; depth < AdaptiveMaxDepth; ++depth) {
+		QVector<double> midParameter;
+		for (int i = 0; i < count - 1; ++i) {
+			if (refine.at(i))
+				midParameter << (parameter.at(i) + parameter.at(i + 1))/2;
+		}
+
+		//don't exceed the maximal number of points, the intervals at the end are not bisected then
+		if (midParameter.size() > maxCount - count)
+			midParameter.resize(qMax(maxCount - count, 0));
+		if (midParameter.isEmpty())
+			break;
+
+		QVector<double> midX;
+		QVector<double> midY;
+		if (!evaluate(samples.type, samples.expression1, samples.expression2, midParameter, midX, midY))
+			break;
+
+		QVector<double> newParameter;
+		QVector<double> newX;
+		QVector<double> newY;
+		QVector<QPointF> newPoints;
+		QVector<bool> newRefine;
+		int k = 0;
+		for (int i = 0; i < count - 1; ++i) {
+			newParameter << parameter.at(i);
+			newX << samples.x.at(i);
+			newY << samples.y.at(i);
+			newPoints << points.at(i);
+
+			if (!refine.at(i) || k >= midParameter.size()) {
+				newRefine << false;
+				continue;
+			}
+
+			const QPointF midPoint = scenePoint(midX.at(k), midY.at(k), view);
+			if (needsRefinement(points.at(i), midPoint, points.at(i + 1), view.size, tolerance, minCos)) {
+				newParameter << midParameter.at(k);
+				newX << midX.at(k);
+				newY << midY.at(k);
+				newPoints << midPoint;
+				newRefine << true << true;
+			} else
+				newRefine << false;
+			++k;
+		}
+		newParameter << parameter.last();
+		newX << samples.x.last();
+		newY << samples.y.last();
+		newPoints << points.last();
+
+		const bool refined = (newParameter.size() > count);
+		parameter = newParameter;
+		samples.x = newX;
+		samples.y = newY;
+		points = newPoints;
+		refine = newRefine;
+		count = parameter.size();
+		if (!refined)
+			break;
+	}
+}
+
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
 //##############################################################################
@@ -185,6 +581,7 @@ void XYEquationCurve::save(QXmlStreamWriter* writer) const{
 	writer->writeAttribute( "min", d->equationData.min);
 	writer->writeAttribute( "max", d->equationData.max );
 	writer->writeAttribute( "count", QString::number(d->equationData.count) );
+	writer->writeAttribute( "adaptive", QString::number(d->equationData.adaptive) );
 	writer->writeEndElement();
 
 	writer->writeEndElement();
@@ -223,6 +620,11 @@ bool XYEquationCurve::load(XmlStreamReader* reader) {
 			READ_STRING_VALUE("min", equationData.min);
 			READ_STRING_VALUE("max", equationData.max);
 			READ_INT_VALUE("count", equationData.count, int);
+
+			//not available in projects of older versions, uniform sampling then
+			str = attribs.value("adaptive").toString();
+			if (!str.isEmpty())
+				d->equationData.adaptive = str.toInt();
 		}
 	}
 
@@ -39,14 +39,15 @@ class XYEquationCurve: public XYCurve {
 		enum EquationType {Cartesian, Polar, Parametric, Implicit, Neutral};
 
 		struct EquationData {
-			EquationData() : type(Cartesian), min("0"), max("1"), count(1000) {};
+			EquationData() : type(Cartesian), min("0"), max("1"), count(1000), adaptive(false) {};
 
 			EquationType type;
 			QString expression1;
 			QString expression2;
 			QString min;
 			QString max;
-			int count;
+			int count;	//number of points, maximal number of points for the adaptive sampling
+			bool adaptive;
 		};
 
 		explicit XYEquationCurve(const QString& name);
@@ -62,6 +63,9 @@ class XYEquationCurve: public XYCurve {
 		typedef WorksheetElement BaseClass;
 		typedef XYEquationCurvePrivate Private;
 
+	public slots:
+		virtual void retransform();
+
 	protected:
 		XYEquationCurve(const QString& name, XYEquationCurvePrivate* dd);
 
@@ -69,6 +73,9 @@ class XYEquationCurve: public XYCurve {
 		Q_DECLARE_PRIVATE(XYEquationCurve)
 		void init();
 
+	private slots:
+		void evaluationFinished();
+
 	signals:
 		friend class XYEquationCurveSetEquationDataCmd;
 		void equationDataChanged(const XYEquationCurve::EquationData&);
@@ -31,24 +31,72 @@
 
 #include "backend/worksheet/plots/cartesian/XYCurvePrivate.h"
 #include "backend/worksheet/plots/cartesian/XYEquationCurve.h"
+#include "backend/worksheet/plots/cartesian/CartesianPlot.h"
+
+#include <QFutureWatcher>
 
 class XYEquationCurve;
 class Column;
+template<class T> class ChunkedVector;
 
 class XYEquationCurvePrivate: public XYCurvePrivate {
 	public:
 		explicit XYEquationCurvePrivate(XYEquationCurve*);
 		~XYEquationCurvePrivate();
 
+		//! values of the curve for the parameter values x (cartesian), phi (polar) or t (parametric)
+		struct Samples {
+			Samples() : id(0), type(XYEquationCurve::Cartesian), valid(false) {}
+
+			int id;
+			XYEquationCurve::EquationType type;
+			QString expression1;
+			QString expression2;
+			QVector<double> parameter;
+			QVector<double> x;
+			QVector<double> y;
+			bool valid;
+		};
+
+		//range, scales and size of the plot the adaptive samples were calculated for
+		struct View {
+			View() : xMin(0), xMax(0), yMin(0), yMax(0),
+				xScale(CartesianPlot::ScaleLinear), yScale(CartesianPlot::ScaleLinear), valid(false) {}
+			bool operator==(const View&) const;
+			bool operator!=(const View& other) const { return !(*this == other); }
+
+			double xMin;
+			double xMax;
+			double yMin;
+			double yMax;
+			CartesianPlot::Scale xScale;
+			CartesianPlot::Scale yScale;
+			QSizeF size;
+			bool valid;
+		};
+
 		void recalculate();
+		void evaluationFinished();
+		View currentView() const;
 
 		XYEquationCurve::EquationData equationData;
 		Column* xColumn;
 		Column* yColumn;
-		QVector<double>* xVector;
-		QVector<double>* yVector;
+		ChunkedVector<double>* xVector;
+		ChunkedVector<double>* yVector;
+
+		QList<Samples> cache;	//recently calculated samples, the latest first
+		int evaluationId;	//id of the last requested evaluation
+		QFutureWatcher<Samples> evaluationWatcher;
+		View sampledView;	//view of the last adaptive sampling
+		bool sampling;	//true while the adaptively calculated values are set
 
 		XYEquationCurve* const q;
+
+	private:
+		bool reuseSamples(Samples&, QVector<int>& missing) const;
+		void setSamples(const Samples&);
+		void sampleAdaptively(Samples&, double minValue, double maxValue, const View&) const;
 };
 
 #endif
@@ -39,6 +39,7 @@
 #include "XYFitCurvePrivate.h"
 #include "backend/core/AbstractColumn.h"
 #include "backend/core/column/Column.h"
+#include "backend/lib/ChunkedVector.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
 #include "backend/gsl/ExpressionParser.h"
@@ -201,7 +202,9 @@ struct data {
 	nsl_fit_model_category modelCategory;
 	unsigned int modelType;
 	int degree;
-	QString* func;	// string containing the definition of the model/function
+	parser_expr* func;	// compiled model/function, x is bound to the slot 0
+	parser_expr** derivs;	// compiled partial derivatives of the model with respect to the parameters (0 if not known)
+	double** paramHandles;	// values of the parameters in the context of the model, see context_bind_variable()
 	QStringList* paramNames;
 	double* paramMin;	// lower parameter limits
 	double* paramMax;	// upper parameter limits
@@ -220,39 +223,44 @@ int func_f(const gsl_vector* paramValues, void* params, gsl_vector* f) {
 	double* sigma = ((struct data*)params)->sigma;
 	nsl_fit_model_category modelCategory = ((struct data*)params)->modelCategory;
 	unsigned int modelType = ((struct data*)params)->modelType;
-	QByteArray funcba = ((struct data*)params)->func->toLocal8Bit();	// a local byte array is needed!
+	parser_expr* func = ((struct data*)params)->func;	// function to evaluate
+	double** paramHandles = ((struct data*)params)->paramHandles;
 	QStringList* paramNames = ((struct data*)params)->paramNames;
 	double *min = ((struct data*)params)->paramMin;
 	double *max = ((struct data*)params)->paramMax;
 
+	if (!func)
+		return GSL_EINVAL;
+
 	// set current values of the parameters
 	for (int i = 0; i < paramNames->size(); i++) {
 		double x = gsl_vector_get(paramValues, i);
 		// bound values if limits are set
-		assign_variable(paramNames->at(i).toLocal8Bit().data(), nsl_fit_map_bound(x, min[i], max[i]));
+		*paramHandles[i] = nsl_fit_map_bound(x, min[i], max[i]);
 		QDEBUG("Parameter"<<i<<" (\" "<<paramNames->at(i).toLocal8Bit().data()<<"\")"<<'['<<min[i]<<','<<max[i]
 			<<"] free/bound:"<<QString::number(x, 'g', 15)<<' '<<QString::number(nsl_fit_map_bound(x, min[i], max[i]), 'g', 15));
 	}
 
-	const char *func = funcba.data();	// function to evaluate
-	for (size_t i = 0; i < n; i++) {
-		if (std::isnan(x[i]) || std::isnan(y[i]))
-			continue;
-
-		// checks for allowed values of x for different models
-		// TODO: more to check
-		if (modelCategory == nsl_fit_model_distribution && modelType == nsl_sf_stats_lognormal) {
+	// checks for allowed values of x for different models
+	// TODO: more to check
+	if (modelCategory == nsl_fit_model_distribution && modelType == nsl_sf_stats_lognormal) {
+		for (size_t i = 0; i < n; i++) {
 			if (x[i] < 0)
 				x[i] = 0;
 		}
+	}
 
-		assign_variable("x", x[i]);
-		double Yi = parse(func);
+	// evaluate the model for all points at once
+	QVector<double> values(n);
+	const double* xData = x;
+	eval_expr_block(func, &xData, values.data(), n);
 
-//		DEBUG("evaluate function"<<QString(func)<<": f(x["<<i<<"]) ="<<Yi);
+	for (size_t i = 0; i < n; i++) {
+		if (std::isnan(x[i]) || std::isnan(y[i]))
+			continue;
 
-		if (parse_errors() > 0)
-			return GSL_EINVAL;
+		const double Yi = values.at(i);
+//		DEBUG("evaluate function: f(x["<<i<<"]) ="<<Yi);
 
 		if (sigma)
 			gsl_vector_set (f, i, (Yi - y[i])/sigma[i]);
@@ -759,44 +767,45 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		}
 		break;
 	case nsl_fit_model_custom:
-		QByteArray funcba = ((struct data*)params)->func->toLocal8Bit();
-		char* func = funcba.data();
-		QByteArray nameba;
-		double value;
+		parser_expr* func = ((struct data*)params)->func;
+		parser_expr** derivs = ((struct data*)params)->derivs;
+		double** paramHandles = ((struct data*)params)->paramHandles;
+		if (!func)
+			return GSL_EINVAL;
+
 		const unsigned int np = paramNames->size();
-		for (size_t i = 0; i < n; i++) {
-			x = xVector[i];
-			assign_variable("x", x);
-			if (sigmaVector) sigma = sigmaVector[i];
-
-			for (unsigned int j = 0; j < np; j++) {
-				for (unsigned int k = 0; k < np; k++) {
-					if (k != j) {
-						nameba = paramNames->at(k).toLocal8Bit();
-						value = nsl_fit_map_bound(gsl_vector_get(paramValues, k), min[k], max[k]);
-						assign_variable(nameba.data(), value);
-					}
+		for (unsigned int k = 0; k < np; k++)
+			*paramHandles[k] = nsl_fit_map_bound(gsl_vector_get(paramValues, k), min[k], max[k]);
+
+		const double* xData = xVector;
+		QVector<double> values(n);
+		for (unsigned int j = 0; j < np; j++) {
+			if (fixed[j]) {
+				for (size_t i = 0; i < n; i++)
+					gsl_matrix_set(J, i, j, 0.);
+			} else if (derivs[j]) {
+				// exact derivative, evaluated for all points at once
+				eval_expr_block(derivs[j], &xData, values.data(), n);
+				for (size_t i = 0; i < n; i++) {
+					if (sigmaVector) sigma = sigmaVector[i];
+					gsl_matrix_set(J, i, j, values.at(i)/sigma);
 				}
+			} else {
+				// no symbolic derivative available (e.g. special functions), calculate finite difference
+				const double value = *paramHandles[j];
+				for (size_t i = 0; i < n; i++) {
+					x = xVector[i];
+					if (sigmaVector) sigma = sigmaVector[i];
 
-				nameba = paramNames->at(j).toLocal8Bit();
-				char *name = nameba.data();
-				value = nsl_fit_map_bound(gsl_vector_get(paramValues, j), min[j], max[j]);
-				assign_variable(name, value);
-				double f_p = parse(func);
-
-				double eps = 1.e-9*fabs(f_p);	// adapt step size to value
-				value += eps;
-				assign_variable(name, value);
-				double f_pdp = parse(func);
+					double f_p = eval_expr(func, &x);
 
-//		qDebug()<<"evaluate deriv"<<QString(func)<<": f(x["<<i<<"]) ="<<QString::number(f_p, 'g', 15);
-//		qDebug()<<"evaluate deriv"<<QString(func)<<": f(x["<<i<<"]+dx) ="<<QString::number(f_pdp, 'g', 15);
-//		qDebug()<<"	deriv = "<<QString::number((f_pdp-f_p)/eps/sigma, 'g', 15);
+					double eps = 1.e-9*fabs(f_p);	// adapt step size to value
+					*paramHandles[j] = value + eps;
+					double f_pdp = eval_expr(func, &x);
+					*paramHandles[j] = value;
 
-				if (fixed[j])
-					gsl_matrix_set(J, i, j, 0.);
-				else	// calculate finite difference
 					gsl_matrix_set(J, i, j, (f_pdp - f_p)/eps/sigma);
+				}
 			}
 		}
 	}
@@ -820,9 +829,9 @@ void XYFitCurvePrivate::recalculate() {
 		xColumn = new Column("x", AbstractColumn::Numeric);
 		yColumn = new Column("y", AbstractColumn::Numeric);
 		residualsColumn = new Column("residuals", AbstractColumn::Numeric);
-		xVector = static_cast<QVector<double>* >(xColumn->data());
-		yVector = static_cast<QVector<double>* >(yColumn->data());
-		residualsVector = static_cast<QVector<double>* >(residualsColumn->data());
+		xVector = static_cast<ChunkedVector<double>* >(xColumn->data());
+		yVector = static_cast<ChunkedVector<double>* >(yColumn->data());
+		residualsVector = static_cast<ChunkedVector<double>* >(residualsColumn->data());
 
 		xColumn->setHidden(true);
 		q->addChild(xColumn);
@@ -949,9 +958,26 @@ void XYFitCurvePrivate::recalculate() {
 	for (unsigned int i = 0; i < np; i++)
 		DEBUG("fixed parameter" << i << fitData.paramFixed.data()[i]);
 
+	//compile the model once in an own context, x is bound to a slot and the parameters are variables of the context
+	//whose values are set through handles. For custom models the partial derivatives are compiled, too.
+	gsl_set_error_handler_off();
+	parser_context* context = copy_context(0);
+	QVector<double*> paramHandles(np);
+	for (unsigned int i = 0; i < np; i++)
+		paramHandles[i] = context_bind_variable(context, fitData.paramNames.at(i).toLocal8Bit().constData());
+
+	const QByteArray model = fitData.model.toLocal8Bit();
+	const char* varNames[] = {"x"};
+	parser_expr* func = context_compile_expr(context, model.constData(), varNames, 1);
+	QVector<parser_expr*> derivs(np, 0);
+	if (func && fitData.modelCategory == nsl_fit_model_custom) {
+		for (unsigned int i = 0; i < np; i++)
+			derivs[i] = context_compile_derivative(context, model.constData(), varNames, 1, fitData.paramNames.at(i).toLocal8Bit().constData());
+	}
+
 	//function to fit
 	gsl_multifit_function_fdf f;
-	struct data params = {n, xdata, ydata, sigma, fitData.modelCategory, fitData.modelType, fitData.degree, &fitData.model, &fitData.paramNames, 
+	struct data params = {n, xdata, ydata, sigma, fitData.modelCategory, fitData.modelType, fitData.degree, func, derivs.data(), paramHandles.data(), &fitData.paramNames, 
 				fitData.paramLowerLimits.data(), fitData.paramUpperLimits.data(), fitData.paramFixed.data()};
 	f.f = &func_f;
 	f.df = &func_df;
@@ -1040,32 +1066,37 @@ void XYFitCurvePrivate::recalculate() {
 	}
 
 	// fill residuals vector. To get residuals on the correct x values, fill the rest with zeros.
-	residualsVector->resize(xDataColumn->rowCount());
+	QVector<double> residuals(xDataColumn->rowCount());
 	if (fitData.evaluateFullRange) {	// evaluate full range of residuals
-		xVector->resize(xDataColumn->rowCount());
+		QVector<double> xValues(xDataColumn->rowCount());
 		for (int i = 0; i < xDataColumn->rowCount(); i++)
-			(*xVector)[i] = xDataColumn->valueAt(i);
+			xValues[i] = xDataColumn->valueAt(i);
 		ExpressionParser* parser = ExpressionParser::getInstance();
-		bool rc = parser->evaluateCartesian(fitData.model, xVector, residualsVector,
+		bool rc = parser->evaluateCartesian(fitData.model, &xValues, &residuals,
 							fitData.paramNames, fitResult.paramValues);
 		for (int i = 0; i < xDataColumn->rowCount(); i++)
-			(*residualsVector)[i] = yDataColumn->valueAt(i) - (*residualsVector)[i];
+			residuals[i] = yDataColumn->valueAt(i) - residuals[i];
 		if (!rc)
-			residualsVector->clear();
+			residuals.clear();
 	} else {	// only selected range
 		size_t j = 0;
 		for (int i = 0; i < xDataColumn->rowCount(); i++) {
 			if (xDataColumn->valueAt(i) >= xmin && xDataColumn->valueAt(i) <= xmax)
-				residualsVector->data()[i] = - gsl_vector_get(s->f, j++);
+				residuals[i] = - gsl_vector_get(s->f, j++);
 			else	// outside range
-				residualsVector->data()[i] = 0;
+				residuals[i] = 0;
 		}
 	}
+	*residualsVector = ChunkedVector<double>(residuals);
 	residualsColumn->setChanged();
 
 	//free resources
 	gsl_multifit_fdfsolver_free(s);
 	gsl_matrix_free(covar);
+	free_expr(func);
+	for (unsigned int i = 0; i < np; i++)
+		free_expr(derivs[i]);
+	free_context(context);
 
 	//calculate the fit function (vectors)
 	ExpressionParser* parser = ExpressionParser::getInstance();
@@ -1073,11 +1104,14 @@ void XYFitCurvePrivate::recalculate() {
 		xmin = xDataColumn->minimum();
 		xmax = xDataColumn->maximum();
 	}
-	xVector->resize(fitData.evaluatedPoints);
-	yVector->resize(fitData.evaluatedPoints);
-	bool rc = parser->evaluateCartesian(fitData.model, QString::number(xmin), QString::number(xmax), fitData.evaluatedPoints, xVector, yVector,
+	QVector<double> xResult(fitData.evaluatedPoints);
+	QVector<double> yResult(fitData.evaluatedPoints);
+	bool rc = parser->evaluateCartesian(fitData.model, QString::number(xmin), QString::number(xmax), fitData.evaluatedPoints, &xResult, &yResult,
 						fitData.paramNames, fitResult.paramValues);
-	if (!rc) {
+	if (rc) {
+		*xVector = ChunkedVector<double>(xResult);
+		*yVector = ChunkedVector<double>(yResult);
+	} else {
 		xVector->clear();
 		yVector->clear();
 	}
@@ -1353,9 +1387,9 @@ bool XYFitCurve::load(XmlStreamReader* reader) {
 
 		addChild(d->residualsColumn);
 
-		d->xVector = static_cast<QVector<double>* >(d->xColumn->data());
-		d->yVector = static_cast<QVector<double>* >(d->yColumn->data());
-		d->residualsVector = static_cast<QVector<double>* >(d->residualsColumn->data());
+		d->xVector = static_cast<ChunkedVector<double>* >(d->xColumn->data());
+		d->yVector = static_cast<ChunkedVector<double>* >(d->yColumn->data());
+		d->residualsVector = static_cast<ChunkedVector<double>* >(d->residualsColumn->data());
 
 		setUndoAware(false);
 		XYCurve::d_ptr->xColumn = d->xColumn;
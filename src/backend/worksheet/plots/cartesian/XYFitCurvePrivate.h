@@ -34,6 +34,7 @@
 
 class XYFitCurve;
 class Column;
+template<class T> class ChunkedVector;
 
 extern "C" {
 #include <gsl/gsl_multifit_nlin.h>
@@ -60,9 +61,9 @@ class XYFitCurvePrivate: public XYCurvePrivate {
 		Column* xColumn; //<! column used internally for storing the x-values of the result fit curve
 		Column* yColumn; //<! column used internally for storing the y-values of the result fit curve
 		Column* residualsColumn;
-		QVector<double>* xVector;
-		QVector<double>* yVector;
-		QVector<double>* residualsVector;
+		ChunkedVector<double>* xVector;
+		ChunkedVector<double>* yVector;
+		ChunkedVector<double>* residualsVector;
 
 		bool sourceDataChangedSinceLastFit; //<! \c true if the data in the source columns (x, y, or weights) was changed, \c false otherwise
 
@@ -37,6 +37,7 @@
 #include "XYFourierFilterCurvePrivate.h"
 #include "backend/core/AbstractColumn.h"
 #include "backend/core/column/Column.h"
+#include "backend/lib/ChunkedVector.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
 
@@ -183,8 +184,8 @@ void XYFourierFilterCurvePrivate::recalculate() {
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
 		yColumn = new Column("y", AbstractColumn::Numeric);
-		xVector = static_cast<QVector<double>* >(xColumn->data());
-		yVector = static_cast<QVector<double>* >(yColumn->data());
+		xVector = static_cast<ChunkedVector<double>* >(xColumn->data());
+		yVector = static_cast<ChunkedVector<double>* >(yColumn->data());
 
 		xColumn->setHidden(true);
 		q->addChild(xColumn);
@@ -299,10 +300,10 @@ void XYFourierFilterCurvePrivate::recalculate() {
 	// run filter
 	int status = nsl_filter_fourier(ydata, n, type, form, order, cutindex, bandwidth);
 
-	xVector->resize(n);
-	yVector->resize(n);
-	memcpy(xVector->data(), xdataVector.data(), n*sizeof(double));
-	memcpy(yVector->data(), ydata, n*sizeof(double));
+	xVector->clear();
+	yVector->clear();
+	xVector->append(xdataVector.data(), n);
+	yVector->append(ydata, n);
 ///////////////////////////////////////////////////////////
 
 	//write the result
@@ -434,8 +435,8 @@ bool XYFourierFilterCurve::load(XmlStreamReader* reader) {
 		d->yColumn->setHidden(true);
 		addChild(d->yColumn);
 
-		d->xVector = static_cast<QVector<double>* >(d->xColumn->data());
-		d->yVector = static_cast<QVector<double>* >(d->yColumn->data());
+		d->xVector = static_cast<ChunkedVector<double>* >(d->xColumn->data());
+		d->yVector = static_cast<ChunkedVector<double>* >(d->yColumn->data());
 
 		setUndoAware(false);
 		XYCurve::d_ptr->xColumn = d->xColumn;
@@ -37,6 +37,7 @@
 #include "XYFourierTransformCurvePrivate.h"
 #include "backend/core/AbstractColumn.h"
 #include "backend/core/column/Column.h"
+#include "backend/lib/ChunkedVector.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
 
@@ -178,8 +179,8 @@ void XYFourierTransformCurvePrivate::recalculate() {
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
 		yColumn = new Column("y", AbstractColumn::Numeric);
-		xVector = static_cast<QVector<double>* >(xColumn->data());
-		yVector = static_cast<QVector<double>* >(yColumn->data());
+		xVector = static_cast<ChunkedVector<double>* >(xColumn->data());
+		yVector = static_cast<ChunkedVector<double>* >(yColumn->data());
 
 		xColumn->setHidden(true);
 		q->addChild(xColumn);
@@ -304,16 +305,18 @@ void XYFourierTransformCurvePrivate::recalculate() {
 		out << ydata[i] << '(' << xdata[i] << ')';
 #endif
 
-	xVector->resize(N);
-	yVector->resize(N);
+	xVector->clear();
+	yVector->clear();
 	if(shifted) {
-		memcpy(xVector->data(), &xdata[n/2], n/2*sizeof(double));
-		memcpy(&xVector->data()[n/2], xdata, n/2*sizeof(double));
-		memcpy(yVector->data(), &ydata[n/2], n/2*sizeof(double));
-		memcpy(&yVector->data()[n/2], ydata, n/2*sizeof(double));
+		xVector->append(&xdata[n/2], n/2);
+		xVector->append(xdata, n/2);
+		yVector->append(&ydata[n/2], n/2);
+		yVector->append(ydata, n/2);
+		xVector->resize(N, 0.0);
+		yVector->resize(N, 0.0);
 	} else {
-		memcpy(xVector->data(), xdata, N*sizeof(double));
-		memcpy(yVector->data(), ydata, N*sizeof(double));
+		xVector->append(xdata, N);
+		yVector->append(ydata, N);
 	}
 ///////////////////////////////////////////////////////////
 
@@ -441,8 +444,8 @@ bool XYFourierTransformCurve::load(XmlStreamReader* reader) {
 		d->yColumn->setHidden(true);
 		addChild(d->yColumn);
 
-		d->xVector = static_cast<QVector<double>* >(d->xColumn->data());
-		d->yVector = static_cast<QVector<double>* >(d->yColumn->data());
+		d->xVector = static_cast<ChunkedVector<double>* >(d->xColumn->data());
+		d->yVector = static_cast<ChunkedVector<double>* >(d->yColumn->data());
 
 		setUndoAware(false);
 		XYCurve::d_ptr->xColumn = d->xColumn;
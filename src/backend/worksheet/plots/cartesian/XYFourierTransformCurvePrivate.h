@@ -37,6 +37,7 @@
 
 class XYFourierTransformCurve;
 class Column;
+template<class T> class ChunkedVector;
 
 class XYFourierTransformCurvePrivate: public XYCurvePrivate {
 	public:
@@ -54,8 +55,8 @@ class XYFourierTransformCurvePrivate: public XYCurvePrivate {
 
 		Column* xColumn; //<! column used internally for storing the x-values of the result fit curve
 		Column* yColumn; //<! column used internally for storing the y-values of the result fit curve
-		QVector<double>* xVector;
-		QVector<double>* yVector;
+		ChunkedVector<double>* xVector;
+		ChunkedVector<double>* yVector;
 
 		bool sourceDataChangedSinceLastTransform; //<! \c true if the data in the source columns (x, y) was changed, \c false otherwise
 
@@ -37,6 +37,7 @@
 #include "XYIntegrationCurvePrivate.h"
 #include "CartesianCoordinateSystem.h"
 #include "backend/core/column/Column.h"
+#include "backend/lib/ChunkedVector.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
 
@@ -178,8 +179,8 @@ void XYIntegrationCurvePrivate::recalculate() {
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
 		yColumn = new Column("y", AbstractColumn::Numeric);
-		xVector = static_cast<QVector<double>* >(xColumn->data());
-		yVector = static_cast<QVector<double>* >(yColumn->data());
+		xVector = static_cast<ChunkedVector<double>* >(xColumn->data());
+		yVector = static_cast<ChunkedVector<double>* >(yColumn->data());
 
 		xColumn->setHidden(true);
 		q->addChild(xColumn);
@@ -271,10 +272,10 @@ void XYIntegrationCurvePrivate::recalculate() {
 		break;
 	}
 
-	xVector->resize(np);
-	yVector->resize(np);
-	memcpy(xVector->data(), xdata, np*sizeof(double));
-	memcpy(yVector->data(), ydata, np*sizeof(double));
+	xVector->clear();
+	yVector->clear();
+	xVector->append(xdata, np);
+	yVector->append(ydata, np);
 ///////////////////////////////////////////////////////////
 
 	//write the result
@@ -398,8 +399,8 @@ bool XYIntegrationCurve::load(XmlStreamReader* reader) {
 		d->yColumn->setHidden(true);
 		addChild(d->yColumn);
 
-		d->xVector = static_cast<QVector<double>* >(d->xColumn->data());
-		d->yVector = static_cast<QVector<double>* >(d->yColumn->data());
+		d->xVector = static_cast<ChunkedVector<double>* >(d->xColumn->data());
+		d->yVector = static_cast<ChunkedVector<double>* >(d->yColumn->data());
 
 		setUndoAware(false);
 		XYCurve::d_ptr->xColumn = d->xColumn;
@@ -34,6 +34,7 @@
 
 class XYIntegrationCurve;
 class Column;
+template<class T> class ChunkedVector;
 
 class XYIntegrationCurvePrivate: public XYCurvePrivate {
 	public:
@@ -52,8 +53,8 @@ class XYIntegrationCurvePrivate: public XYCurvePrivate {
 
 		Column* xColumn; //<! column used internally for storing the x-values of the result integration curve
 		Column* yColumn; //<! column used internally for storing the y-values of the result integration curve
-		QVector<double>* xVector;
-		QVector<double>* yVector;
+		ChunkedVector<double>* xVector;
+		ChunkedVector<double>* yVector;
 
 		bool sourceDataChangedSinceLastIntegration; //<! \c true if the data in the source columns (x, y) was changed, \c false otherwise
 
@@ -37,6 +37,7 @@
 #include "XYInterpolationCurvePrivate.h"
 #include "CartesianCoordinateSystem.h"
 #include "backend/core/column/Column.h"
+#include "backend/lib/ChunkedVector.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
 
@@ -182,8 +183,8 @@ void XYInterpolationCurvePrivate::recalculate() {
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
 		yColumn = new Column("y", AbstractColumn::Numeric);
-		xVector = static_cast<QVector<double>* >(xColumn->data());
-		yVector = static_cast<QVector<double>* >(yColumn->data());
+		xVector = static_cast<ChunkedVector<double>* >(xColumn->data());
+		yVector = static_cast<ChunkedVector<double>* >(yColumn->data());
 
 		xColumn->setHidden(true);
 		q->addChild(xColumn);
@@ -307,13 +308,14 @@ void XYInterpolationCurvePrivate::recalculate() {
 		break;
 	}
 
-	xVector->resize(npoints);
-	yVector->resize(npoints);
+	//the values are calculated in contiguous vectors and stored in the result columns at the end
+	QVector<double> xResult(npoints);
+	QVector<double> yResult(npoints);
 	for (unsigned int i = 0; i < npoints; i++) {
 		unsigned int a=0,b=n-1;
 
 		double x = xmin + i*(xmax-xmin)/(npoints-1);
-		(*xVector)[i] = x;
+		xResult[i] = x;
 
 		// find index a,b for interval [x[a],x[b]] around x[i] using bisection
 		int j=0;
@@ -339,27 +341,27 @@ void XYInterpolationCurvePrivate::recalculate() {
 		case nsl_interp_type_steffen:
 			switch (evaluate) {
 			case nsl_interp_evaluate_function:
-				(*yVector)[i] = gsl_spline_eval(spline, x, acc);
+				yResult[i] = gsl_spline_eval(spline, x, acc);
 				break;
 			case nsl_interp_evaluate_derivative:
-				(*yVector)[i] = gsl_spline_eval_deriv(spline, x, acc);
+				yResult[i] = gsl_spline_eval_deriv(spline, x, acc);
 				break;
 			case nsl_interp_evaluate_second_derivative:
-				(*yVector)[i] = gsl_spline_eval_deriv2(spline, x, acc);
+				yResult[i] = gsl_spline_eval_deriv2(spline, x, acc);
 				break;
 			case nsl_interp_evaluate_integral:
-				(*yVector)[i] = gsl_spline_eval_integ(spline, xmin, x, acc);
+				yResult[i] = gsl_spline_eval_integ(spline, xmin, x, acc);
 				break;
 			}
 			break;
 		case nsl_interp_type_cosine:
 			t = (x-xdata[a])/(xdata[b]-xdata[a]);
 			t = (1.-cos(M_PI*t))/2.;
-			(*yVector)[i] =  ydata[a] + t*(ydata[b]-ydata[a]);
+			yResult[i] =  ydata[a] + t*(ydata[b]-ydata[a]);
 			break;
 		case nsl_interp_type_exponential:
 			t = (x-xdata[a])/(xdata[b]-xdata[a]);
-			(*yVector)[i] = ydata[a]*pow(ydata[b]/ydata[a],t);
+			yResult[i] = ydata[a]*pow(ydata[b]/ydata[a],t);
 			break;
 		case nsl_interp_type_pch: {
 			t = (x-xdata[a])/(xdata[b]-xdata[a]);
@@ -420,13 +422,13 @@ void XYInterpolationCurvePrivate::recalculate() {
 			}	
 
 			// Hermite polynomial
-			(*yVector)[i] = ydata[a]*h1+ydata[b]*h2+(xdata[b]-xdata[a])*(m1*h3+m2*h4);
+			yResult[i] = ydata[a]*h1+ydata[b]*h2+(xdata[b]-xdata[a])*(m1*h3+m2*h4);
 		}
 			break;
 		case nsl_interp_type_rational: {
 			double v,dv;
 			nsl_interp_ratint(xdata, ydata, n, x, &v, &dv);
-			(*yVector)[i] = v;
+			yResult[i] = v;
 			//TODO: use error dv
 			break;
 		}
@@ -439,24 +441,26 @@ void XYInterpolationCurvePrivate::recalculate() {
 		case nsl_interp_evaluate_function:
 			break;
 		case nsl_interp_evaluate_derivative:
-			nsl_diff_first_deriv_second_order(xVector->data(), yVector->data(), npoints);
+			nsl_diff_first_deriv_second_order(xResult.data(), yResult.data(), npoints);
 			break;
 		case nsl_interp_evaluate_second_derivative:
-			nsl_diff_second_deriv_second_order(xVector->data(), yVector->data(), npoints);
+			nsl_diff_second_deriv_second_order(xResult.data(), yResult.data(), npoints);
 			break;
 		case nsl_interp_evaluate_integral:
-			nsl_int_trapezoid(xVector->data(), yVector->data(), npoints, 0);
+			nsl_int_trapezoid(xResult.data(), yResult.data(), npoints, 0);
 			break;
 		}
 	}
 
 	// check values
 	for (unsigned int i = 0; i < npoints; i++) {
-		if ((*yVector)[i] > CartesianScale::LIMIT_MAX)
-			(*yVector)[i] = CartesianScale::LIMIT_MAX;
-		else if ((*yVector)[i] < CartesianScale::LIMIT_MIN)
-			(*yVector)[i] = CartesianScale::LIMIT_MIN;
+		if (yResult[i] > CartesianScale::LIMIT_MAX)
+			yResult[i] = CartesianScale::LIMIT_MAX;
+		else if (yResult[i] < CartesianScale::LIMIT_MIN)
+			yResult[i] = CartesianScale::LIMIT_MIN;
 	}
+	*xVector = ChunkedVector<double>(xResult);
+	*yVector = ChunkedVector<double>(yResult);
 
 	gsl_spline_free(spline);
 	gsl_interp_accel_free(acc);
@@ -593,8 +597,8 @@ bool XYInterpolationCurve::load(XmlStreamReader* reader) {
 		d->yColumn->setHidden(true);
 		addChild(d->yColumn);
 
-		d->xVector = static_cast<QVector<double>* >(d->xColumn->data());
-		d->yVector = static_cast<QVector<double>* >(d->yColumn->data());
+		d->xVector = static_cast<ChunkedVector<double>* >(d->xColumn->data());
+		d->yVector = static_cast<ChunkedVector<double>* >(d->yColumn->data());
 
 		setUndoAware(false);
 		XYCurve::d_ptr->xColumn = d->xColumn;
@@ -34,6 +34,7 @@
 
 class XYInterpolationCurve;
 class Column;
+template<class T> class ChunkedVector;
 
 class XYInterpolationCurvePrivate: public XYCurvePrivate {
 	public:
@@ -52,8 +53,8 @@ class XYInterpolationCurvePrivate: public XYCurvePrivate {
 
 		Column* xColumn; //<! column used internally for storing the x-values of the result interpolation curve
 		Column* yColumn; //<! column used internally for storing the y-values of the result interpolation curve
-		QVector<double>* xVector;
-		QVector<double>* yVector;
+		ChunkedVector<double>* xVector;
+		ChunkedVector<double>* yVector;
 
 		bool sourceDataChangedSinceLastInterpolation; //<! \c true if the data in the source columns (x, y) was changed, \c false otherwise
 
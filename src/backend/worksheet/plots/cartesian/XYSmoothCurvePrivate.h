@@ -34,6 +34,7 @@
 
 class XYSmoothCurve;
 class Column;
+template<class T> class ChunkedVector;
 
 class XYSmoothCurvePrivate: public XYCurvePrivate {
 	public:
@@ -52,8 +53,8 @@ class XYSmoothCurvePrivate: public XYCurvePrivate {
 
 		Column* xColumn; //<! column used internally for storing the x-values of the result smooth curve
 		Column* yColumn; //<! column used internally for storing the y-values of the result smooth curve
-		QVector<double>* xVector;
-		QVector<double>* yVector;
+		ChunkedVector<double>* xVector;
+		ChunkedVector<double>* yVector;
 
 		bool sourceDataChangedSinceLastSmooth; //<! \c true if the data in the source columns (x, y) was changed, \c false otherwise
 
@@ -234,6 +234,7 @@ void ProjectExplorer::setModel(AspectTreeModel* treeModel) {
 
 void ProjectExplorer::setProject(Project* project) {
 	connect(project, SIGNAL(aspectAdded(const AbstractAspect*)), this, SLOT(aspectAdded(const AbstractAspect*)));
+	connect(project, SIGNAL(aspectsAdded(const AbstractAspect*,int,int)), this, SLOT(aspectsAdded(const AbstractAspect*,int,int)));
 	connect(project, SIGNAL(requestSaveState(QXmlStreamWriter*)), this, SLOT(save(QXmlStreamWriter*)));
 	connect(project, SIGNAL(requestLoadState(XmlStreamReader*)), this, SLOT(load(XmlStreamReader*)));
 	connect(project, SIGNAL(requestNavigateTo(QString)), this, SLOT(navigateTo(QString)));
@@ -317,6 +318,19 @@ void ProjectExplorer::aspectAdded(const AbstractAspect* aspect) {
 	m_treeView->header()->resizeSection(0, m_treeView->header()->sectionSize(0)*1.2);
 }
 
+/*!
+  expands the parent of the aspects added at once with AbstractAspect::insertChildrenBefore(),
+  e.g. the columns of a spreadsheet. The new aspects are not selected.
+ */
+void ProjectExplorer::aspectsAdded(const AbstractAspect* parent, int first, int last) {
+	Q_UNUSED(first) Q_UNUSED(last)
+	if (m_project->isLoading())
+		return;
+
+	AspectTreeModel* tree_model = qobject_cast<AspectTreeModel*>(m_treeView->model());
+	m_treeView->setExpanded(tree_model->modelIndexOfAspect(parent), true);
+}
+
 void ProjectExplorer::navigateTo(const QString& path) {
 	AspectTreeModel* tree_model = qobject_cast<AspectTreeModel*>(m_treeView->model());
 	if(tree_model)
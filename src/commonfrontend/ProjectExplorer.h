@@ -86,6 +86,7 @@ class ProjectExplorer : public QWidget {
 
 	private slots:
 		void aspectAdded(const AbstractAspect*);
+		void aspectsAdded(const AbstractAspect* parent, int first, int last);
 		void toggleColumn(int);
 		void showAllColumns();
 		void filterTextChanged(const QString&);
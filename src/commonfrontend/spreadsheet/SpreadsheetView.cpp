@@ -158,6 +158,10 @@ void SpreadsheetView::init() {
 	        this, SLOT(handleAspectAdded(const AbstractAspect*)));
 	connect(m_spreadsheet, SIGNAL(aspectAboutToBeRemoved(const AbstractAspect*)),
 	        this, SLOT(handleAspectAboutToBeRemoved(const AbstractAspect*)));
+	connect(m_spreadsheet, SIGNAL(aspectsAdded(const AbstractAspect*,int,int)),
+	        this, SLOT(handleAspectsAdded(const AbstractAspect*,int,int)));
+	connect(m_spreadsheet, SIGNAL(aspectsAboutToBeRemoved(const AbstractAspect*,int,int)),
+	        this, SLOT(handleAspectsAboutToBeRemoved(const AbstractAspect*,int,int)));
 	connect(m_spreadsheet, SIGNAL(requestProjectContextMenu(QMenu*)), this, SLOT(createContextMenu(QMenu*)));
 
 	//selection relevant connections
@@ -472,6 +476,22 @@ void SpreadsheetView::handleAspectAboutToBeRemoved(const AbstractAspect* aspect)
 	disconnect(col, 0, this, 0);
 }
 
+void SpreadsheetView::handleAspectsAdded(const AbstractAspect* parent, int first, int last) {
+	if (parent != m_spreadsheet)
+		return;
+
+	for (int i = first; i <= last; ++i)
+		handleAspectAdded(parent->child<AbstractAspect>(i));
+}
+
+void SpreadsheetView::handleAspectsAboutToBeRemoved(const AbstractAspect* parent, int first, int last) {
+	if (parent != m_spreadsheet)
+		return;
+
+	for (int i = first; i <= last; ++i)
+		handleAspectAboutToBeRemoved(parent->child<AbstractAspect>(i));
+}
+
 void SpreadsheetView::handleHorizontalSectionResized(int logicalIndex, int oldSize, int newSize) {
 	Q_UNUSED(logicalIndex);
 	Q_UNUSED(oldSize);
@@ -740,7 +760,7 @@ bool SpreadsheetView::eventFilter(QObject* watched, QEvent* event) {
 		if (watched == m_tableView->verticalHeader()) {
 			bool onlyNumeric = true;
 			for (int i = 0; i < m_spreadsheet->columnCount(); ++i) {
-				if (m_spreadsheet->column(i)->columnMode() != AbstractColumn::Numeric) {
+				if (!AbstractColumn::isNumeric(m_spreadsheet->column(i)->columnMode())) {
 					onlyNumeric = false;
 					break;
 				}
@@ -770,7 +790,7 @@ bool SpreadsheetView::eventFilter(QObject* watched, QEvent* event) {
 			//check whether we have non-numeric columns selected and deactivate actions for numeric columns
 			bool numeric = true;
 			foreach(Column* col, selectedColumns()) {
-				if (col->columnMode() != AbstractColumn::Numeric) {
+				if (!AbstractColumn::isNumeric(col->columnMode())) {
 					numeric = false;
 					break;
 				}
@@ -855,7 +875,7 @@ void SpreadsheetView::copySelection() {
 			if (isCellSelected(first_row + r, first_col + c)) {
 				if (formulaModeActive())
 					output_str += col_ptr->formula(first_row + r);
-				else if (col_ptr->columnMode() == AbstractColumn::Numeric) {
+				else if (AbstractColumn::isNumeric(col_ptr->columnMode())) {
 					Double2StringFilter * out_fltr = static_cast<Double2StringFilter *>(col_ptr->outputFilter());
 					output_str += QLocale().toString(col_ptr->valueAt(first_row + r),
 					                                 out_fltr->numericFormat(), 16); // copy with max. precision
@@ -996,7 +1016,10 @@ void SpreadsheetView::fillSelectedCellsWithRowNumbers() {
 		int col = m_spreadsheet->indexOfChild<Column>(col_ptr);
 		col_ptr->setSuppressDataChangedSignal(true);
 		switch (col_ptr->columnMode()) {
-		case AbstractColumn::Numeric: {
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float: {
 				QVector<double> results(last-first+1);
 				for (int row=first; row <= last; row++)
 					if (isCellSelected(row, col))
@@ -1045,7 +1068,7 @@ void SpreadsheetView::fillWithRowNumbers() {
 		new_data[i] = i+1;
 
 	foreach(Column* col, selectedColumns()) {
-		if (col->columnMode() != AbstractColumn::Numeric)
+		if (!AbstractColumn::isNumeric(col->columnMode()))
 			continue;
 		col->replaceValues(0, new_data);
 	}
@@ -1068,7 +1091,10 @@ void SpreadsheetView::fillSelectedCellsWithRandomNumbers() {
 		int col = m_spreadsheet->indexOfChild<Column>(col_ptr);
 		col_ptr->setSuppressDataChangedSignal(true);
 		switch (col_ptr->columnMode()) {
-		case AbstractColumn::Numeric: {
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float: {
 				QVector<double> results(last-first+1);
 				for (int row=first; row<=last; row++)
 					if (isCellSelected(row, col))
@@ -1155,7 +1181,10 @@ void SpreadsheetView::fillSelectedCellsWithConstValues() {
 		int col = m_spreadsheet->indexOfChild<Column>(col_ptr);
 		col_ptr->setSuppressDataChangedSignal(true);
 		switch (col_ptr->columnMode()) {
-		case AbstractColumn::Numeric: {
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float: {
 				if (!doubleOk)
 					doubleValue = QInputDialog::getDouble(this, i18n("Fill the selection with constant value"),
 					                                      i18n("Value"), 0, -2147483647, 2147483647, 6, &doubleOk);
@@ -1322,11 +1351,11 @@ void SpreadsheetView::reverseColumns() {
 	m_spreadsheet->beginMacro(i18np("%1: reverse column", "%1: reverse columns",
 	                                m_spreadsheet->name(), cols.size()));
 	foreach(Column* col, cols) {
-		if (col->columnMode() != AbstractColumn::Numeric)
+		if (!AbstractColumn::isNumeric(col->columnMode()))
 			continue;
 
-		QVector<double>* data = static_cast<QVector<double>* >(col->data());
-		QVector<double> new_data(*data);
+		QVector<double> new_data(col->rowCount());
+		col->valuesAsDouble(0, new_data.size(), new_data.data());
 		std::reverse(new_data.begin(), new_data.end());
 		col->replaceValues(0, new_data);
 	}
@@ -1359,7 +1388,7 @@ void SpreadsheetView::normalizeSelectedColumns() {
 	m_spreadsheet->beginMacro(i18n("%1: normalize columns", m_spreadsheet->name()));
 	QList< Column* > cols = selectedColumns();
 	foreach(Column* col, cols)	{
-		if (col->columnMode() == AbstractColumn::Numeric) {
+		if (AbstractColumn::isNumeric(col->columnMode())) {
 			col->setSuppressDataChangedSignal(true);
 			double max = col->maximum();
 			if (max != 0.0) {// avoid division by zero
@@ -1379,7 +1408,7 @@ void SpreadsheetView::normalizeSelection() {
 	m_spreadsheet->beginMacro(i18n("%1: normalize selection", m_spreadsheet->name()));
 	double max = 0.0;
 	for (int col=firstSelectedColumn(); col<=lastSelectedColumn(); col++)
-		if (m_spreadsheet->column(col)->columnMode() == AbstractColumn::Numeric)
+		if (AbstractColumn::isNumeric(m_spreadsheet->column(col)->columnMode()))
 			for (int row=0; row<m_spreadsheet->rowCount(); row++) {
 				if (isCellSelected(row, col) && m_spreadsheet->column(col)->valueAt(row) > max)
 					max = m_spreadsheet->column(col)->valueAt(row);
@@ -1388,7 +1417,7 @@ void SpreadsheetView::normalizeSelection() {
 	if (max != 0.0) { // avoid division by zero
 		//TODO setSuppressDataChangedSignal
 		for (int col=firstSelectedColumn(); col<=lastSelectedColumn(); col++)
-			if (m_spreadsheet->column(col)->columnMode() == AbstractColumn::Numeric)
+			if (AbstractColumn::isNumeric(m_spreadsheet->column(col)->columnMode()))
 				for (int row=0; row<m_spreadsheet->rowCount(); row++) {
 					if (isCellSelected(row, col))
 						m_spreadsheet->column(col)->setValueAt(row, m_spreadsheet->column(col)->valueAt(row) / max);
@@ -1418,7 +1447,7 @@ void SpreadsheetView::showColumnStatistics(bool forAll) {
 		dlg->setColumns(selectedColumns());
 	else if (forAll) {
 		for (int col = 0; col < m_spreadsheet->columnCount(); ++col) {
-			if (m_spreadsheet->column(col)->columnMode() == AbstractColumn::Numeric)
+			if (AbstractColumn::isNumeric(m_spreadsheet->column(col)->columnMode()))
 				list << m_spreadsheet->column(col);
 		}
 		dlg->setColumns(list);
@@ -1573,6 +1602,7 @@ void SpreadsheetView::sortDialog(QList<Column*> cols) {
 	SortDialog* dlg = new SortDialog();
 	dlg->setAttribute(Qt::WA_DeleteOnClose);
 	connect(dlg, SIGNAL(sort(Column*,QList<Column*>,bool)), m_spreadsheet, SLOT(sortColumns(Column*,QList<Column*>,bool)));
+	connect(dlg, SIGNAL(sortByKeys(QList<Column*>,QList<bool>,QList<Column*>)), m_spreadsheet, SLOT(sortColumns(QList<Column*>,QList<bool>,QList<Column*>)));
 	dlg->setColumnsList(cols);
 	int rc = dlg->exec();
 
@@ -230,6 +230,8 @@ class SpreadsheetView : public QWidget {
 		void currentColumnChanged(const QModelIndex& current, const QModelIndex & previous);
 		void handleAspectAdded(const AbstractAspect* aspect);
 		void handleAspectAboutToBeRemoved(const AbstractAspect* aspect);
+		void handleAspectsAdded(const AbstractAspect* parent, int first, int last);
+		void handleAspectsAboutToBeRemoved(const AbstractAspect* parent, int first, int last);
 		void updateHeaderGeometry(Qt::Orientation o, int first, int last);
 
 		void selectColumn(int);
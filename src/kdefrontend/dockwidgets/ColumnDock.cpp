@@ -145,7 +145,10 @@ void ColumnDock::setColumns(QList<Column*> list){
 	this->updateFormatWidgets(columnMode);
 
 	switch(columnMode) {
-		case AbstractColumn::Numeric:{
+		case AbstractColumn::Numeric:
+		case AbstractColumn::Integer:
+		case AbstractColumn::BigInt:
+		case AbstractColumn::Float: {
 			Double2StringFilter* filter = static_cast<Double2StringFilter*>(m_column->outputFilter());
 			ui.cbFormat->setCurrentIndex(ui.cbFormat->findData(filter->numericFormat()));
 			//qDebug()<<"set columns, numeric format"<<filter->numericFormat();
@@ -184,6 +187,9 @@ void ColumnDock::updateFormatWidgets(const AbstractColumn::ColumnMode columnMode
 
   switch (columnMode){
 	case AbstractColumn::Numeric:
+	case AbstractColumn::Integer:
+	case AbstractColumn::BigInt:
+	case AbstractColumn::Float:
 	  ui.cbFormat->addItem(i18n("Decimal"), QVariant('f'));
 	  ui.cbFormat->addItem(i18n("Scientific (e)"), QVariant('e'));
 	  ui.cbFormat->addItem(i18n("Scientific (E)"), QVariant('E'));
@@ -220,7 +226,7 @@ void ColumnDock::updateFormatWidgets(const AbstractColumn::ColumnMode columnMode
 	}
   }
 
-  if (columnMode == AbstractColumn::Numeric){
+  if (AbstractColumn::isNumeric(columnMode)){
 	ui.lPrecision->show();
 	ui.sbPrecision->show();
   }else{
@@ -250,6 +256,9 @@ void ColumnDock::retranslateUi(){
 
   	ui.cbType->clear();
 	ui.cbType->addItem(i18n("Numeric"), QVariant(int(AbstractColumn::Numeric)));
+	ui.cbType->addItem(i18n("Integer"), QVariant(int(AbstractColumn::Integer)));
+	ui.cbType->addItem(i18n("Big integer"), QVariant(int(AbstractColumn::BigInt)));
+	ui.cbType->addItem(i18n("Float"), QVariant(int(AbstractColumn::Float)));
 	ui.cbType->addItem(i18n("Text"), QVariant(int(AbstractColumn::Text)));
 	ui.cbType->addItem(i18n("Month names"), QVariant(int(AbstractColumn::Month)));
 	ui.cbType->addItem(i18n("Day names"), QVariant(int(AbstractColumn::Day)));
@@ -299,7 +308,10 @@ void ColumnDock::typeChanged(int index){
   int format_index = ui.cbFormat->currentIndex();
 
   switch(columnMode) {
-	  case AbstractColumn::Numeric:{
+	  case AbstractColumn::Numeric:
+	  case AbstractColumn::Integer:
+	  case AbstractColumn::BigInt:
+	  case AbstractColumn::Float: {
 		int digits = ui.sbPrecision->value();
 		foreach(Column* col, m_columnsList) {
 		  col->beginMacro(i18n("%1: change column type", col->name()));
@@ -344,7 +356,10 @@ void ColumnDock::formatChanged(int index){
   int format_index = index;
 
   switch(mode) {
-	  case AbstractColumn::Numeric:{
+	  case AbstractColumn::Numeric:
+	  case AbstractColumn::Integer:
+	  case AbstractColumn::BigInt:
+	  case AbstractColumn::Float: {
 		foreach(Column* col, m_columnsList) {
 		  Double2StringFilter* filter = static_cast<Double2StringFilter*>(col->outputFilter());
 		  filter->setNumericFormat(ui.cbFormat->itemData(format_index).toChar().toLatin1());
@@ -409,7 +424,10 @@ void ColumnDock::columnFormatChanged() {
         m_initializing = true;
 	AbstractColumn::ColumnMode columnMode = m_column->columnMode();
 	switch(columnMode) {
-                case AbstractColumn::Numeric:{
+                case AbstractColumn::Numeric:
+                case AbstractColumn::Integer:
+                case AbstractColumn::BigInt:
+                case AbstractColumn::Float: {
                         Double2StringFilter* filter = static_cast<Double2StringFilter*>(m_column->outputFilter());
                         ui.cbFormat->setCurrentIndex(ui.cbFormat->findData(filter->numericFormat()));
                         break;
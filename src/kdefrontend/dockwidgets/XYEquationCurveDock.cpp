@@ -112,6 +112,7 @@ void XYEquationCurveDock::setupGeneral() {
 	connect( uiGeneralTab.teMin, SIGNAL(expressionChanged()), this, SLOT(enableRecalculate()) );
 	connect( uiGeneralTab.teMax, SIGNAL(expressionChanged()), this, SLOT(enableRecalculate()) );
 	connect( uiGeneralTab.sbCount, SIGNAL(valueChanged(int)), this, SLOT(enableRecalculate()) );
+	connect( uiGeneralTab.chkAdaptive, SIGNAL(clicked(bool)), this, SLOT(enableRecalculate()) );
 	connect( uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()) );
 }
 
@@ -163,6 +164,7 @@ void XYEquationCurveDock::initGeneralTab() {
 	uiGeneralTab.teMin->setText(data.min);
 	uiGeneralTab.teMax->setText(data.max);
 	uiGeneralTab.sbCount->setValue(data.count);
+	uiGeneralTab.chkAdaptive->setChecked(data.adaptive);
 
 	uiGeneralTab.chkVisible->setChecked( m_curve->isVisible() );
 
@@ -253,6 +255,7 @@ void XYEquationCurveDock::recalculateClicked() {
 	data.min = uiGeneralTab.teMin->document()->toPlainText();
 	data.max = uiGeneralTab.teMax->document()->toPlainText();
 	data.count = uiGeneralTab.sbCount->value();
+	data.adaptive = uiGeneralTab.chkAdaptive->isChecked();
 
 	foreach(XYCurve* curve, m_curvesList)
 		dynamic_cast<XYEquationCurve*>(curve)->setEquationData(data);
@@ -372,5 +375,6 @@ void XYEquationCurveDock::curveEquationDataChanged(const XYEquationCurve::Equati
 	uiGeneralTab.teMin->setText(data.min);
 	uiGeneralTab.teMax->setText(data.max);
 	uiGeneralTab.sbCount->setValue(data.count);
+	uiGeneralTab.chkAdaptive->setChecked(data.adaptive);
 	m_initializing = false;
 }
@@ -35,17 +35,60 @@
 extern "C" {
 #include "backend/gsl/parser.h"
 }
-#include <cmath>
 
 #include <QMenu>
 #include <QWidgetAction>
 #include <KLocalizedString>
+#include <QProgressDialog>
 #include <QThreadPool>
 #ifndef NDEBUG
 #include <QDebug>
 #include <QElapsedTimer>
 #endif
 
+namespace {
+//number of columns and rows of the tiles evaluated by one task
+const int MatrixTileSize = 256;
+
+/* task evaluating a compiled expression for the columns [startCol, endCol) and rows [startRow, endRow) */
+class GenerateValueTask : public QRunnable {
+public:
+	GenerateValueTask(const parser_expr* expr, double* const* columnData, const double* xValues, const double* yValues,
+		int startCol, int endCol, int startRow, int endRow, QAtomicInt& finished, const QAtomicInt& canceled)
+		: m_expr(expr), m_columnData(columnData), m_xValues(xValues), m_yValues(yValues), m_startCol(startCol), m_endCol(endCol),
+		m_startRow(startRow), m_endRow(endRow), m_finished(finished), m_canceled(canceled) {
+	}
+
+	void run() {
+		double vars[2];
+		for (int col = m_startCol; col < m_endCol; ++col) {
+			if (m_canceled.load())
+				return;
+
+			vars[0] = m_xValues[col];
+			double* data = m_columnData[col];
+			for (int row = m_startRow; row < m_endRow; ++row) {
+				vars[1] = m_yValues[row];
+				data[row] = eval_expr(m_expr, vars);
+			}
+		}
+		m_finished.fetchAndAddRelaxed(1);
+	}
+
+private:
+	const parser_expr* m_expr;
+	double* const* m_columnData;
+	const double* m_xValues;
+	const double* m_yValues;
+	int m_startCol;
+	int m_endCol;
+	int m_startRow;
+	int m_endRow;
+	QAtomicInt& m_finished;
+	const QAtomicInt& m_canceled;
+};
+}
+
 /*!
 	\class MatrixFunctionDialog
 	\brief Dialog for generating matrix values from a mathematical function.
@@ -136,116 +179,88 @@ void MatrixFunctionDialog::insertConstant(const QString& str) {
 	ui.teEquation->insertPlainText(str);
 }
 
-/* task class for parallel fill (not used) */
-class GenerateValueTask : public QRunnable {
-public:
-	GenerateValueTask(int startCol, int endCol, QVector<QVector<double>>& matrixData, double xStart, double yStart,
-		double xStep, double yStep, char* func): m_startCol(startCol), m_endCol(endCol), m_matrixData(matrixData),
-		m_xStart(xStart), m_yStart(yStart), m_xStep(xStep), m_yStep(yStep), m_func(func) {
-	};
-
-	void run() {
-		const int rows = m_matrixData[m_startCol].size();
-		double x = m_xStart;
-		double y = m_yStart;
-#ifndef NDEBUG
-		qDebug()<<"FILL col"<<m_startCol<<"-"<<m_endCol<<" x/y ="<<x<<'/'<<y<<" steps ="<<m_xStep<<'/'<<m_yStep<<" rows ="<<rows;
-#endif
-		parser_var vars[] = { {"x", x}, {"y", y}};
-		for (int col = m_startCol; col < m_endCol; ++col) {
-			vars[0].value = x;
-			for (int row = 0; row < rows; row++) {
-				vars[1].value = y;
-				double z = parse_with_vars(m_func, vars, 2);
-				//qDebug()<<" z ="<<z;
-				m_matrixData[col][row] = z;
-				y += m_yStep;
-			}
-
-			y = m_yStart;
-			x += m_xStep;
-		}
-	}
-
-private:
-	int m_startCol;
-	int m_endCol;
-	QVector<QVector<double>>& m_matrixData;
-	double m_xStart;
-	double m_yStart;
-	double m_xStep;
-	double m_yStep;
-	char* m_func;
-};
-
 void MatrixFunctionDialog::generate() {
-	WAIT_CURSOR;
+	const int cols = m_matrix->columnCount();
+	const int rows = m_matrix->rowCount();
 
-	m_matrix->beginMacro(i18n("%1: fill matrix with function values", m_matrix->name()));
+	//compile the expression once, x and y are bound to the slots 0 and 1
+	const QByteArray funcba = ui.teEquation->toPlainText().toLocal8Bit();
+	const char* varNames[] = {"x", "y"};
+	parser_expr* compiled = compile_expr(funcba.constData(), varNames, 2);
+	if (!compiled)
+		return;
 
-	QVector<QVector<double> > new_data = m_matrix->data();
+	WAIT_CURSOR;
 
-	QByteArray funcba = ui.teEquation->toPlainText().toLocal8Bit();
-	char* func = funcba.data();
+	//x and y are calculated once per column and per row, check if rows or cols == 1
+	QVector<double> xValues(cols);
+	const double xStep = (cols > 1) ? (m_matrix->xEnd() - m_matrix->xStart())/double(cols - 1) : 0.0;
+	for (int col = 0; col < cols; ++col)
+		xValues[col] = m_matrix->xStart() + xStep*col;
 
-	// check if rows or cols == 1
-	double diff = m_matrix->xEnd() - m_matrix->xStart();
-	double xStep = 0.0;
-	if (m_matrix->columnCount() > 1)
-		xStep = diff/double(m_matrix->columnCount() - 1);
+	QVector<double> yValues(rows);
+	const double yStep = (rows > 1) ? (m_matrix->yEnd() - m_matrix->yStart())/double(rows - 1) : 0.0;
+	for (int row = 0; row < rows; ++row)
+		yValues[row] = m_matrix->yStart() + yStep*row;
 
-	diff = m_matrix->yEnd() - m_matrix->yStart();
-	double yStep = 0.0;
-	if (m_matrix->rowCount() > 1)
-		yStep = diff/double(m_matrix->rowCount() - 1);
+	//detach all columns here, the tasks only write to the column data
+	QVector<QVector<double> > new_data = m_matrix->data();
+	QVector<double*> columnData(cols);
+	for (int col = 0; col < cols; ++col)
+		columnData[col] = new_data[col].data();
 
 #ifndef NDEBUG
 	QElapsedTimer timer;
 	timer.start();
 #endif
 
-	//TODO: too slow because every parser thread needs an own symbol_table
-	// idea: use pool->maxThreadCount() symbol tables and reuse them?
-/*	double yStart = m_matrix->yStart();
-	const int cols = m_matrix->columnCount();
-	QThreadPool* pool = QThreadPool::globalInstance();
-	int range = ceil(double(cols)/pool->maxThreadCount());
-#ifndef NDEBUG
-	qDebug() << "Starting" << pool->maxThreadCount() << "threads. cols =" << cols << ": range =" << range;
-#endif
-	for (int i = 0; i < pool->maxThreadCount(); ++i) {
-		const int start = i*range;
-		int end = (i+1)*range;
-		if (end > cols) end = cols;
-		qDebug() << "start/end: " << start << end;
-		const double xStart = m_matrix->xStart() + xStep*start;
-		GenerateValueTask* task = new GenerateValueTask(start, end, new_data, xStart, yStart, xStep, yStep, func);
-		task->setAutoDelete(false);
-		pool->start(task);
+	QList<GenerateValueTask*> tasks;
+	QAtomicInt finished(0);
+	QAtomicInt canceled(0);
+	for (int startCol = 0; startCol < cols; startCol += MatrixTileSize) {
+		for (int startRow = 0; startRow < rows; startRow += MatrixTileSize) {
+			tasks << new GenerateValueTask(compiled, columnData.constData(), xValues.constData(), yValues.constData(),
+				startCol, qMin(startCol + MatrixTileSize, cols), startRow, qMin(startRow + MatrixTileSize, rows), finished, canceled);
+		}
 	}
-	pool->waitForDone();
-*/
-	double x = 0, y = 0;
-	parser_var vars[] = {{"x", x}, {"y", y}};
-	for (int col = 0; col < m_matrix->columnCount(); col++) {
-		vars[0].value = x;
-		for (int row = 0; row < m_matrix->rowCount(); row++) {
-			vars[1].value = y;
-			new_data[col][row] = parse_with_vars(func, vars, 2);
-			y += yStep;
+
+	QProgressDialog progress(i18n("Generating function values..."), i18n("Cancel"), 0, tasks.size(), this);
+	progress.setWindowModality(Qt::WindowModal);
+	progress.setMinimumDuration(500);
+
+	//expressions assigning variables of the symbol table are evaluated serially.
+	//the tasks run in a pool of their own, waiting for the global pool would also wait for unrelated background jobs
+	QThreadPool pool;
+	if (tasks.size() > 1 && pool.maxThreadCount() > 1 && expr_is_threadsafe(compiled)) {
+		foreach (GenerateValueTask* task, tasks)
+			pool.start(task);
+		while (!pool.waitForDone(100)) {
+			progress.setValue(finished.load());
+			if (progress.wasCanceled())
+				canceled.store(1);
+		}
+	} else {
+		foreach (GenerateValueTask* task, tasks) {
+			task->run();
+			delete task;
+			progress.setValue(finished.load());
+			if (progress.wasCanceled())
+				canceled.store(1);
 		}
-		y = m_matrix->yStart();
-		x += xStep;
 	}
+	free_expr(compiled);
 
 	// Timing
 #ifndef NDEBUG
 	qDebug() << "elapsed time =" << timer.elapsed() << "ms";
 #endif
 
+	RESET_CURSOR;
+	if (canceled.load())
+		return;
+
+	m_matrix->beginMacro(i18n("%1: fill matrix with function values", m_matrix->name()));
 	m_matrix->setFormula(ui.teEquation->toPlainText());
 	m_matrix->setData(new_data);
-
 	m_matrix->endMacro();
-	RESET_CURSOR;
 }
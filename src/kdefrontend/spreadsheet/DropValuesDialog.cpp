@@ -112,7 +112,9 @@ class MaskValuesTask : public QRunnable {
 		void run() {
 			m_column->setSuppressDataChangedSignal(true);
 			bool changed = false;
-			QVector<double>* data = static_cast<QVector<double>* >(m_column->data());
+			QVector<double> convertedData(m_column->rowCount());
+			m_column->valuesAsDouble(0, convertedData.size(), convertedData.data());
+			const QVector<double>* data = &convertedData;
 
 			//equal to
 			if (m_operator == 0) {
@@ -207,8 +209,8 @@ class DropValuesTask : public QRunnable {
 
 		void run() {
 			bool changed = false;
-			QVector<double>* data = static_cast<QVector<double>* >(m_column->data());
-			QVector<double> new_data(*data);
+			QVector<double> new_data(m_column->rowCount());
+			m_column->valuesAsDouble(0, new_data.size(), new_data.data());
 
 			//equal to
 			if (m_operator == 0) {
@@ -303,8 +303,7 @@ void FunctionValuesDialog::generate() {
 	//determine variable names and the data vectors of the specified columns
 	QStringList variableNames;
 	QStringList columnPathes;
-	QVector<QVector<double>*> xVectors;
-	QVector<Column*> xColumns;
+	QVector<const Column*> xColumns;
 	int maxRowCount = m_spreadsheet->rowCount();
 	for (int i=0; i<m_variableNames.size(); ++i) {
 		variableNames << m_variableNames.at(i)->text().simplified();
@@ -315,7 +314,6 @@ void FunctionValuesDialog::generate() {
 		Q_ASSERT(column);
 		columnPathes << column->path();
 		xColumns << column;
-		xVectors << static_cast<QVector<double>* >(column->data());
 
 		if (column->rowCount()>maxRowCount)
 			maxRowCount = column->rowCount();
@@ -335,7 +333,7 @@ void FunctionValuesDialog::generate() {
 	//evaluate the expression for f(x_1, x_2, ...) and write the calculated values into a new vector.
 	ExpressionParser* parser = ExpressionParser::getInstance();
 	const QString& expression = ui.teEquation->toPlainText();
-	parser->evaluateCartesian(expression, variableNames, xVectors, &new_data);
+	parser->evaluateColumns(expression, variableNames, xColumns, &new_data);
 
 	//set the new values and store the expression, variable names and the used data columns
 	foreach(Column* col, m_columns) {
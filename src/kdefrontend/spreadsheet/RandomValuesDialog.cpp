@@ -28,6 +28,7 @@
  ***************************************************************************/
 #include "RandomValuesDialog.h"
 #include "backend/core/column/Column.h"
+#include "backend/lib/ChunkedVector.h"
 #include "backend/lib/macros.h"
 #include "backend/spreadsheet/Spreadsheet.h"
 #include <QStandardPaths>
@@ -38,6 +39,10 @@
 #include <KSharedConfig>
 #include <KWindowConfig>
 #include <QFileInfo>
+#include <QDateTime>
+#include <QProgressDialog>
+#include <QRegExpValidator>
+#include <QThreadPool>
 
 extern "C" {
 #include <stdio.h>
@@ -46,6 +51,296 @@ extern "C" {
 #include <gsl/gsl_randist.h>
 }
 
+namespace {
+//number of values generated from one random number stream by one task, a multiple of the chunk size
+const int RandomBlockSize = 4*ChunkedVector<double>::ChunkSize;
+
+//SplitMix64 finalizer, maps consecutive numbers to well distributed seeds
+quint64 mix(quint64 z) {
+	z = (z ^ (z >> 30))*Q_UINT64_C(0xbf58476d1ce4e5b9);
+	z = (z ^ (z >> 27))*Q_UINT64_C(0x94d049bb133111eb);
+	return z ^ (z >> 31);
+}
+
+/*
+	seed of the independent random number stream number \c stream derived from \c seed.
+	The streams only depend on the seed and their number and not on the number of threads.
+*/
+quint64 streamSeed(quint64 seed, quint64 stream) {
+	return mix(seed + Q_UINT64_C(0x9e3779b97f4a7c15)*(stream + 1));
+}
+
+//GSL generator with the name \c name, the default generator if not available
+const gsl_rng_type* generatorType(const QString& name) {
+	for (const gsl_rng_type** t = gsl_rng_types_setup(); *t; ++t) {
+		if (name == QLatin1String((*t)->name))
+			return *t;
+	}
+	return gsl_rng_default;
+}
+
+/* fills data[0..count-1] with random numbers of the distribution dist with the parameters params */
+void generateValues(gsl_rng* r, nsl_sf_stats_distribution dist, const double* params, double* data, int count) {
+	switch (dist) {
+	case nsl_sf_stats_gaussian: {
+		const double mu = params[0];
+		const double sigma = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_gaussian(r, sigma) + mu;
+		break;
+	}
+	case nsl_sf_stats_gaussian_tail: {
+		const double mu = params[0];
+		const double sigma = params[1];
+		const double a = params[2];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_gaussian_tail(r, a, sigma) + mu;
+		break;
+	}
+	case nsl_sf_stats_exponential: {
+		const double mu = 1./params[0]; //GSL uses the inverse for exp. distrib.
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_exponential(r, mu);
+		break;
+	}
+	case nsl_sf_stats_laplace: {
+		const double s = params[0];
+		const double mu = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_laplace(r, s) + mu;
+		break;
+	}
+	case nsl_sf_stats_exponential_power: {
+		const double mu = params[0];
+		const double a = params[1];
+		const double b = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_exppow(r, a, b) + mu;
+		break;
+	}
+	case nsl_sf_stats_cauchy_lorentz: {
+		const double gamma = params[0];
+		const double mu = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_cauchy(r, gamma) + mu;
+		break;
+	}
+	case nsl_sf_stats_rayleigh: {
+		const double s = params[0];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_rayleigh(r, s);
+		break;
+	}
+	case nsl_sf_stats_rayleigh_tail: {
+		const double sigma = params[0];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_rayleigh(r, sigma);
+		break;
+	}
+	case nsl_sf_stats_landau:
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_landau(r);
+		break;
+	case nsl_sf_stats_levy_alpha_stable: {
+		const double c = params[0];
+		const double alpha = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_levy(r, c, alpha);
+		break;
+	}
+	case nsl_sf_stats_levy_skew_alpha_stable: {
+		const double c = params[0];
+		const double alpha = params[1];
+		const double beta = params[2];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_levy_skew(r, c, alpha, beta);
+		break;
+	}
+	case nsl_sf_stats_gamma: {
+		const double a = params[0];
+		const double b = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_gamma(r, a, b);
+		break;
+	}
+	case nsl_sf_stats_flat: {
+		const double a = params[0];
+		const double b = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_flat(r, a, b);
+		break;
+	}
+	case nsl_sf_stats_lognormal: {
+		const double s = params[0];
+		const double mu = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_lognormal(r, mu, s);
+		break;
+	}
+	case nsl_sf_stats_chi_squared: {
+		const double dof = params[0];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_chisq(r, dof);
+		break;
+	}
+	case nsl_sf_stats_fdist: {
+		const double nu1 = params[0];
+		const double nu2 = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_fdist(r, nu1, nu2);
+		break;
+	}
+	case nsl_sf_stats_tdist: {
+		const double nu = params[0];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_tdist(r, nu);
+		break;
+	}
+	case nsl_sf_stats_beta: {
+		const double a = params[0];
+		const double b = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_beta(r, a, b);
+		break;
+	}
+	case nsl_sf_stats_logistic: {
+		const double s = params[0];
+		const double mu = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_logistic(r, s) + mu;
+		break;
+	}
+	case nsl_sf_stats_pareto: {
+		const double a = params[0];
+		const double b = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_pareto(r, a, b);
+		break;
+	}
+	case nsl_sf_stats_weibull: {
+		const double k = params[0];
+		const double l = params[1];
+		const double mu = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_weibull(r, l, k) + mu;
+		break;
+	}
+	case nsl_sf_stats_gumbel1: {
+		const double s = params[0];
+		const double b = params[1];
+		const double mu = params[2];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_gumbel1(r, 1./s, b) + mu;
+		break;
+	}
+	case nsl_sf_stats_gumbel2: {
+		const double a = params[0];
+		const double b = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_gumbel2(r, a, b);
+		break;
+	}
+	case nsl_sf_stats_poisson: {
+		const double l = params[0];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_poisson(r, l);
+		break;
+	}
+	case nsl_sf_stats_bernoulli: {
+		const double p = params[0];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_bernoulli(r, p);
+		break;
+	}
+	case nsl_sf_stats_binomial: {
+		const double p = params[0];
+		const double trials = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_binomial(r, p, trials);
+		break;
+	}
+	case nsl_sf_stats_negative_bionomial: {
+		const double p = params[0];
+		const double trials = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_negative_binomial(r, p, trials);
+		break;
+	}
+	case nsl_sf_stats_pascal: {
+		const double p = params[0];
+		const double trials = params[1];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_pascal(r, p, trials);
+		break;
+	}
+	case nsl_sf_stats_geometric: {
+		const double p = params[0];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_geometric(r, p);
+		break;
+	}
+	case nsl_sf_stats_hypergeometric: {
+		const double n1 = params[0];
+		const double n2 = params[1];
+		const double t = params[2];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_hypergeometric(r, n1, n2, t);
+		break;
+	}
+	case nsl_sf_stats_logarithmic: {
+		const double p = params[0];
+		for (int i = 0; i < count; ++i)
+			data[i] = gsl_ran_logarithmic(r, p);
+		break;
+	}
+	case nsl_sf_stats_maxwell_boltzmann:	// additional non-GSL distros
+	case nsl_sf_stats_sech:
+	case nsl_sf_stats_levy:
+	case nsl_sf_stats_frechet:
+		break;
+	}
+}
+
+/* task generating the values of one block of a column with its own random number stream,
+ * the values are written into the full chunks \c chunks of the column's new storage
+ */
+class GenerateRandomValuesTask : public QRunnable {
+public:
+	GenerateRandomValuesTask(const gsl_rng_type* type, quint64 seed, nsl_sf_stats_distribution dist, const double* parameters,
+		const QVector<double*>& chunks, int count, QAtomicInt& finished, const QAtomicInt& canceled)
+		: m_type(type), m_seed(seed), m_dist(dist), m_chunks(chunks), m_count(count), m_finished(finished), m_canceled(canceled) {
+		for (int i = 0; i < 3; ++i)
+			m_parameters[i] = parameters[i];
+	}
+
+	void run() {
+		if (m_canceled.load())
+			return;
+
+		gsl_rng* r = gsl_rng_alloc(m_type);
+		gsl_rng_set(r, (unsigned long)m_seed);
+		int remaining = m_count;
+		foreach (double* chunk, m_chunks) {
+			const int count = qMin(remaining, (int)ChunkedVector<double>::ChunkSize);
+			generateValues(r, m_dist, m_parameters, chunk, count);
+			remaining -= count;
+		}
+		gsl_rng_free(r);
+		m_finished.fetchAndAddRelaxed(1);
+	}
+
+private:
+	const gsl_rng_type* m_type;
+	quint64 m_seed;
+	nsl_sf_stats_distribution m_dist;
+	double m_parameters[3];
+	QVector<double*> m_chunks;
+	int m_count;
+	QAtomicInt& m_finished;
+	const QAtomicInt& m_canceled;
+};
+}
+
 /*!
 	\class RandomValuesDialog
 	\brief Dialog for generating non-uniform random numbers.
@@ -85,6 +380,8 @@ RandomValuesDialog::RandomValuesDialog(Spreadsheet* s, QWidget* parent, Qt::WFla
 	ui.kleParameter1->setValidator( new QDoubleValidator(ui.kleParameter1) );
 	ui.kleParameter2->setValidator( new QDoubleValidator(ui.kleParameter2) );
 	ui.kleParameter3->setValidator( new QDoubleValidator(ui.kleParameter3) );
+	ui.kleSeed->setValidator( new QRegExpValidator(QRegExp("[0-9]{0,20}"), ui.kleSeed) );
+	ui.kleSeed->setClearButtonShown(true);
 
 	connect( ui.cbDistribution, SIGNAL(currentIndexChanged(int)), SLOT(distributionChanged(int)) );
 	connect( ui.kleParameter1, SIGNAL(textChanged(QString)), this, SLOT(checkValues()) );
@@ -125,6 +422,12 @@ RandomValuesDialog::~RandomValuesDialog() {
 
 void RandomValuesDialog::setColumns(QList<Column*> list) {
 	m_columns = list;
+
+	//show the seed the values of the first column were generated with
+	if (!m_columns.isEmpty() && !m_columns.first()->randomGenerator().isEmpty())
+		ui.kleSeed->setPlaceholderText(i18n("new seed (last: %1)", m_columns.first()->randomSeed()));
+	else
+		ui.kleSeed->setPlaceholderText(i18n("new seed"));
 }
 
 void RandomValuesDialog::distributionChanged(int index) {
@@ -360,345 +663,101 @@ void RandomValuesDialog::checkValues() {
 
 void RandomValuesDialog::generate() {
 	Q_ASSERT(m_spreadsheet);
+	if (m_columns.isEmpty())
+		return;
 
-	//create a generator chosen by the environment variable GSL_RNG_TYPE
-	gsl_rng_env_setup();
-	const gsl_rng_type* T = gsl_rng_default;
-	gsl_rng* r = gsl_rng_alloc(T);
+	const int index = ui.cbDistribution->currentIndex();
+	const nsl_sf_stats_distribution dist = (nsl_sf_stats_distribution)ui.cbDistribution->itemData(index).toInt();
 
-	WAIT_CURSOR;
-	foreach (Column* col, m_columns)
-		col->setSuppressDataChangedSignal(true);
+	//additional non-GSL distributions are not supported yet
+	if (dist == nsl_sf_stats_maxwell_boltzmann || dist == nsl_sf_stats_sech || dist == nsl_sf_stats_levy || dist == nsl_sf_stats_frechet)
+		return;
 
-	m_spreadsheet->beginMacro(i18np("%1: fill column with non-uniform random numbers",
-					"%1: fill columns with non-uniform random numbers",
-					m_spreadsheet->name(), m_columns.size()));
+	const double parameters[3] = {ui.kleParameter1->text().toDouble(), ui.kleParameter2->text().toDouble(),
+					ui.kleParameter3->text().toDouble()};
 
-	int index = ui.cbDistribution->currentIndex();
-	nsl_sf_stats_distribution dist = (nsl_sf_stats_distribution)ui.cbDistribution->itemData(index).toInt();
+	//create a generator chosen by the environment variable GSL_RNG_TYPE,
+	//the values of a column are reproduced with the generator they were created with
+	gsl_rng_env_setup();
+	const gsl_rng_type* type = gsl_rng_default;
+	bool ok;
+	quint64 seed = ui.kleSeed->text().toULongLong(&ok);
+	if (ok) {
+		const Column* first = m_columns.first();
+		if (!first->randomGenerator().isEmpty() && first->randomSeed() == seed)
+			type = generatorType(first->randomGenerator());
+	} else
+		seed = QDateTime::currentMSecsSinceEpoch();
 
-	const int rows = m_spreadsheet->rowCount();
-	QVector<double> new_data(rows);
+	WAIT_CURSOR;
 
-	switch (dist) {
-	case nsl_sf_stats_gaussian: {
-		double mu = ui.kleParameter1->text().toDouble();
-		double sigma = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_gaussian(r, sigma) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_gaussian_tail: {
-		double mu = ui.kleParameter1->text().toDouble();
-		double sigma = ui.kleParameter2->text().toDouble();
-		double a = ui.kleParameter3->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_gaussian_tail(r, a, sigma) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_exponential: {
-		double mu = ui.kleParameter1->text().toDouble();
-		mu = 1./mu; //GSL uses the inverse for exp. distrib.
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_exponential(r, mu);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_laplace: {
-		double s = ui.kleParameter1->text().toDouble();
-		double mu = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_laplace(r, s) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_exponential_power: {
-		double mu = ui.kleParameter1->text().toDouble();
-		double a = ui.kleParameter2->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_exppow(r, a, b) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_cauchy_lorentz: {
-		double gamma = ui.kleParameter1->text().toDouble();
-		double mu = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_cauchy(r, gamma) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_rayleigh: {
-		double s = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_rayleigh(r, s);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_rayleigh_tail: {
-		double sigma = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_rayleigh(r, sigma);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_landau:
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_landau(r);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	case nsl_sf_stats_levy_alpha_stable: {
-		double c = ui.kleParameter1->text().toDouble();
-		double alpha = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_levy(r, c, alpha);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_levy_skew_alpha_stable: {
-		double c = ui.kleParameter1->text().toDouble();
-		double alpha = ui.kleParameter2->text().toDouble();
-		double beta = ui.kleParameter3->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_levy_skew(r, c, alpha, beta);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_gamma: {
-		double a = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_gamma(r, a, b);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_flat: {
-		double a = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach(Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_flat(r, a, b);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_lognormal: {
-		double s = ui.kleParameter1->text().toDouble();
-		double mu = ui.kleParameter2->text().toDouble();
-		foreach(Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_lognormal(r, mu, s);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_chi_squared: {
-		double n = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_chisq(r, n);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_fdist: {
-		double nu1 = ui.kleParameter1->text().toDouble();
-		double nu2 = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_fdist(r, nu1, nu2);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_tdist: {
-		double nu = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_tdist(r, nu);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_beta: {
-		double a = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_beta(r, a, b);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_logistic: {
-		double s = ui.kleParameter1->text().toDouble();
-		double mu = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_logistic(r, s) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_pareto: {
-		double a = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_pareto(r, a, b);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_weibull: {
-		double k = ui.kleParameter1->text().toDouble();
-		double l = ui.kleParameter2->text().toDouble();
-		double mu = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_weibull(r, l, k) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_gumbel1: {
-		double s = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		double mu = ui.kleParameter3->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_gumbel1(r, 1./s, b) + mu;
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_gumbel2: {
-		double a = ui.kleParameter1->text().toDouble();
-		double b = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_gumbel2(r, a, b);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_poisson: {
-		double l = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_poisson(r, l);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_bernoulli: {
-		double p = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_bernoulli(r, p);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_binomial: {
-		double p = ui.kleParameter1->text().toDouble();
-		double n = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_binomial(r, p, n);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_negative_bionomial: {
-		double p = ui.kleParameter1->text().toDouble();
-		double n = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_negative_binomial(r, p, n);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_pascal: {
-		double p = ui.kleParameter1->text().toDouble();
-		double n = ui.kleParameter2->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_pascal(r, p, n);
-			col->replaceValues(0, new_data);
-		}
-		break;
-	}
-	case nsl_sf_stats_geometric: {
-		double p = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_geometric(r, p);
-			col->replaceValues(0, new_data);
+	const int rows = m_spreadsheet->rowCount();
+	const int cols = m_columns.size();
+	QVector<ChunkedVector<double> > new_data(cols);
+	QVector<quint64> seeds(cols);
+	QList<GenerateRandomValuesTask*> tasks;
+	QAtomicInt finished(0);
+	QAtomicInt canceled(0);
+	for (int col = 0; col < cols; ++col) {
+		//every column records its own seed and can be reproduced with it alone
+		seeds[col] = (col == 0) ? seed : streamSeed(seed, col);
+		//the chunks are allocated here, the tasks only write into them
+		ChunkedVector<double>& data = new_data[col];
+		data.resize(rows, NAN);
+		for (int block = 0; block*RandomBlockSize < rows; ++block) {
+			const int start = block*RandomBlockSize;
+			const int count = qMin(RandomBlockSize, rows - start);
+			QVector<double*> chunks;
+			for (int chunk = data.chunkIndex(start); chunk <= data.chunkIndex(start + count - 1); ++chunk)
+				chunks << data.chunkData(chunk);
+			tasks << new GenerateRandomValuesTask(type, streamSeed(seeds.at(col), block), dist, parameters,
+				chunks, count, finished, canceled);
 		}
-		break;
 	}
-	case nsl_sf_stats_hypergeometric: {
-		double n1 = ui.kleParameter1->text().toDouble();
-		double n2 = ui.kleParameter2->text().toDouble();
-		double t = ui.kleParameter3->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_hypergeometric(r, n1, n2, t);
-			col->replaceValues(0, new_data);
+
+	QProgressDialog progress(i18n("Generating random values..."), i18n("Cancel"), 0, tasks.size(), this);
+	progress.setWindowModality(Qt::WindowModal);
+	progress.setMinimumDuration(500);
+
+	//a pool of its own, waiting for the global pool would also wait for unrelated background jobs
+	QThreadPool pool;
+	if (tasks.size() > 1 && pool.maxThreadCount() > 1) {
+		foreach (GenerateRandomValuesTask* task, tasks)
+			pool.start(task);
+		while (!pool.waitForDone(100)) {
+			progress.setValue(finished.load());
+			if (progress.wasCanceled())
+				canceled.store(1);
 		}
-		break;
-	}
-	case nsl_sf_stats_logarithmic: {
-		double p = ui.kleParameter1->text().toDouble();
-		foreach (Column* col, m_columns) {
-			for (int i = 0; i < rows; ++i)
-				new_data[i] = gsl_ran_logarithmic(r, p);
-			col->replaceValues(0, new_data);
+	} else {
+		foreach (GenerateRandomValuesTask* task, tasks) {
+			task->run();
+			delete task;
+			progress.setValue(finished.load());
+			if (progress.wasCanceled())
+				canceled.store(1);
 		}
-		break;
 	}
-	case nsl_sf_stats_maxwell_boltzmann:	// additional non-GSL distros
-	case nsl_sf_stats_sech:
-	case nsl_sf_stats_levy:
-	case nsl_sf_stats_frechet:
-		break;
+
+	if (canceled.load()) {
+		RESET_CURSOR;
+		return;
 	}
 
+	foreach (Column* col, m_columns)
+		col->setSuppressDataChangedSignal(true);
+
+	m_spreadsheet->beginMacro(i18np("%1: fill column with non-uniform random numbers",
+					"%1: fill columns with non-uniform random numbers",
+					m_spreadsheet->name(), m_columns.size()));
+
+	for (int col = 0; col < cols; ++col)
+		m_columns.at(col)->setRandomValues(new_data.at(col), type->name, seeds.at(col));
+
 	foreach (Column* col, m_columns) {
 		col->setSuppressDataChangedSignal(false);
 		col->setChanged();
 	}
 	m_spreadsheet->endMacro();
 	RESET_CURSOR;
-
-	gsl_rng_free(r);
 }
@@ -74,7 +74,24 @@ SortDialog::SortDialog( QWidget* parent, Qt::WFlags fl ) : QDialog( parent, fl )
 	layout->addWidget( lblColumns, 2, 0 );
 	cbColumns = new QComboBox();
 	layout->addWidget(cbColumns, 2, 1);
-	layout->setRowStretch(3, 1);
+
+	// further columns used to order the rows with equal values in the leading column
+	for (int i = 1; i < MaxKeys; ++i) {
+		QLabel* label = new QLabel(i18n("Then by"));
+		layout->addWidget(label, 2 + i, 0);
+		lblThenBy << label;
+
+		QComboBox* cbColumn = new QComboBox();
+		layout->addWidget(cbColumn, 2 + i, 1);
+		cbThenByColumns << cbColumn;
+
+		QComboBox* cbOrder = new QComboBox();
+		cbOrder->addItem(QIcon::fromTheme("view-sort-ascending"), i18n("Ascending"));
+		cbOrder->addItem(QIcon::fromTheme("view-sort-descending"), i18n("Descending"));
+		layout->addWidget(cbOrder, 2 + i, 2);
+		cbThenByOrderings << cbOrder;
+	}
+	layout->setRowStretch(2 + MaxKeys, 1);
 
 
 	QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok
@@ -96,13 +113,27 @@ SortDialog::SortDialog( QWidget* parent, Qt::WFlags fl ) : QDialog( parent, fl )
 }
 
 void SortDialog::sort(){
-	Column* leading;
-	if(cbType->currentIndex() == Together) 
-		leading = m_columns_list.at(cbColumns->currentIndex());
-	else
-		leading = 0;
-	
-	emit sort(leading, m_columns_list, cbOrdering->currentIndex() == Ascending );
+	if(cbType->currentIndex() == Together) {
+		QList<Column*> keys;
+		QList<bool> ascending;
+		keys << m_columns_list.at(cbColumns->currentIndex());
+		ascending << (cbOrdering->currentIndex() == Ascending);
+
+		// the first entry of the "then by" boxes is "none"
+		for (int i = 0; i < cbThenByColumns.size(); ++i) {
+			const int index = cbThenByColumns.at(i)->currentIndex();
+			if (index <= 0)
+				continue;
+			Column* column = m_columns_list.at(index - 1);
+			if (keys.contains(column))
+				continue;
+			keys << column;
+			ascending << (cbThenByOrderings.at(i)->currentIndex() == Ascending);
+		}
+
+		emit sortByKeys(keys, ascending, m_columns_list);
+	} else
+		emit sort(0, m_columns_list, cbOrdering->currentIndex() == Ascending );
 	
 	accepted();
 }
@@ -114,18 +145,32 @@ void SortDialog::setColumnsList(QList<Column*> list){
 		cbColumns->addItem( list.at(i)->name() );
 
 	cbColumns->setCurrentIndex(0);
+
+	for (int i = 0; i < cbThenByColumns.size(); ++i) {
+		cbThenByColumns.at(i)->addItem(i18n("none"));
+		for(int j=0; j<list.size(); j++)
+			cbThenByColumns.at(i)->addItem( list.at(j)->name() );
+		cbThenByColumns.at(i)->setCurrentIndex(0);
+	}
 	
 	if (list.size() == 1){
 		lblType->hide();
 		cbType->hide();
 		lblColumns->hide();
 		cbColumns->hide();
+		for (int i = 0; i < cbThenByColumns.size(); ++i) {
+			lblThenBy.at(i)->hide();
+			cbThenByColumns.at(i)->hide();
+			cbThenByOrderings.at(i)->hide();
+		}
 	}
 }
 
 void SortDialog::changeType(int Type){
-	if(Type == Together)
-		cbColumns->setEnabled(true);
-	else
-		cbColumns->setEnabled(false);
+	const bool together = (Type == Together);
+	cbColumns->setEnabled(together);
+	for (int i = 0; i < cbThenByColumns.size(); ++i) {
+		cbThenByColumns.at(i)->setEnabled(together);
+		cbThenByOrderings.at(i)->setEnabled(together);
+	}
 }
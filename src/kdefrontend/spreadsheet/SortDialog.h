@@ -44,6 +44,7 @@ class SortDialog : public QDialog{
 
 		enum { Separately=0, Together=1 };
 		enum { Ascending=0, Descending=1 };
+		enum { MaxKeys=3 };
 
 	private slots:
 		void sort();
@@ -51,6 +52,7 @@ class SortDialog : public QDialog{
 
 	signals:
 		void sort(Column *leading, QList<Column*> cols, bool ascending);
+		void sortByKeys(QList<Column*> keys, QList<bool> ascending, QList<Column*> cols);
 
 	private:
 		QList<Column*> m_columns_list;
@@ -60,6 +62,9 @@ class SortDialog : public QDialog{
 		QComboBox* cbType;
 		QLabel* lblColumns;
 		QComboBox* cbColumns;
+		QList<QLabel*> lblThenBy;
+		QList<QComboBox*> cbThenByColumns;
+		QList<QComboBox*> cbThenByOrderings;
 };
 
 #endif